@@ -1,9 +1,12 @@
 #include "ArticlesCompress.h"
 
+#include <memory>
+
 #include "Articles.h"
 #include "Log.h"
 #include "StringCompare.h"
 #include "Styles.h"
+#include "ThreadPool.h"
 #include "Tools.h"
 
 // The maximum number of quck access entries that possible
@@ -47,9 +50,166 @@ static int CryptQA(std::vector<TQAArticlesEntry> &aQA, UInt32 aHASH)
 	return ERROR_NO;
 }
 
+namespace {
+
+//  ,      
+enum : UInt32 { ArticlesPerShard = 4096 };
+
+//  ,    
+struct ArticlesShard
+{
+	//   [begin, end)
+	UInt32 begin;
+	UInt32 end;
+
+	//  ,   
+	ICompressBy *compress;
+	//    (   )
+	std::unique_ptr<ICompressBy> shard;
+	//    (   )
+	COut out;
+
+	//       
+	std::vector<UInt32> positions;
+	//         
+	UInt32 maxWordTypeSize;
+	UInt32 maxTextSize;
+
+	// ,   
+	std::vector<uint16_t> blockType;
+	std::u16string text16;
+
+	int error;
+};
+
+}
+
+/**
+ *   
+ *
+ * @param aShard   - ,    
+ * @param aArticle - 
+ *
+ * @return  
+ */
+static int compressArticle(ArticlesShard &aShard, const CArticle &aArticle)
+{
+	//       
+	//      0.
+	//          
+	std::vector<uint16_t> &blockType = aShard.blockType;
+	blockType.resize(aArticle.GetBlockCount() + 1);
+	for (auto&& block : enumerate(aArticle.blocks()))
+		blockType[block.index] = block->styleNumber;
+	blockType[aArticle.GetBlockCount()] = '\0';
+
+	int error = aShard.compress->AddText(blockType.data(), static_cast<uint32_t>(blockType.size()), SLD_TREE_BLOCKTYPE);
+	if (error != ERROR_NO)
+		return error;
+
+	std::u16string &text16 = aShard.text16;
+	for (const BlockType &block : aArticle.blocks())
+	{
+		sld::as_utf16(block.text, text16);
+		aShard.maxTextSize = (std::max)(aShard.maxTextSize, static_cast<UInt32>(text16.size()));
+
+		error = aShard.compress->AddText((const UInt16*)text16.c_str(), (UInt32)text16.length() + 1, block.styleNumber);
+		if (error != ERROR_NO)
+			return error;
+	}
+	return ERROR_NO;
+}
+
+/**
+ *        
+ *
+ * @param aArticles   - 
+ * @param aShard      - 
+ * @param aPositions  -      
+ */
+static void compressShard(const CArticles *aArticles, ArticlesShard &aShard, bool aPositions)
+{
+	for (UInt32 index : xrange(aShard.begin, aShard.end))
+	{
+		const CArticle &article = *aArticles->GetArticleByIndex(index);
+
+		aShard.maxWordTypeSize = (std::max)(aShard.maxWordTypeSize, article.GetBlockCount());
+		if (aPositions)
+			aShard.positions.push_back(aShard.compress->GetCurrentPos());
+
+		aShard.error = compressArticle(aShard, article);
+		if (aShard.error != ERROR_NO)
+			return;
+	}
+}
+
+/**
+ *    
+ *
+ *    ,         
+ *     .
+ *
+ * @param aArticles   - 
+ * @param aCompress   -  
+ * @param aShards     - 
+ * @param aPositions  -      
+ * @param aThreadPool - thread pool
+ *
+ * @return  
+ */
+static int compressShards(const CArticles *aArticles, ICompressBy *aCompress, std::vector<ArticlesShard> &aShards,
+						  bool aPositions, ThreadPool &aThreadPool)
+{
+	for (ArticlesShard &shard : aShards)
+	{
+		shard.positions.clear();
+		shard.maxWordTypeSize = 0;
+		shard.maxTextSize = 0;
+		shard.error = ERROR_NO;
+		shard.compress = aCompress;
+		if (aShards.size() > 1)
+		{
+			shard.out.ClearContent();
+			shard.shard.reset(aCompress->CreateShard());
+			shard.shard->Init(shard.out);
+			shard.compress = shard.shard.get();
+		}
+	}
+
+	if (aShards.size() == 1)
+	{
+		compressShard(aArticles, aShards.front(), aPositions);
+		return aShards.front().error;
+	}
+
+	std::vector<ThreadPool::Task> tasks(aShards.size());
+	for (size_t i : indices(aShards))
+	{
+		ArticlesShard *shard = &aShards[i];
+		tasks[i] = aThreadPool.queue([aArticles, shard, aPositions]() { compressShard(aArticles, *shard, aPositions); });
+	}
+	aThreadPool.complete(tasks.data(), tasks.size());
+
+	for (const ArticlesShard &shard : aShards)
+	{
+		if (shard.error != ERROR_NO)
+			return shard.error;
+	}
+	return ERROR_NO;
+}
+
 /** ********************************************************************
 *    
 *
+*            
+*  (@ref ICompressBy::SupportsShards),     , 
+*   ,        .
+*        .
+*
+*     ,      
+*    (    ); ,   
+*  ,   .
+*
 * @param aArticles   -        
 * @param aStyles     -      
 * @param aHASH       -     
@@ -70,34 +230,18 @@ int CArticlesCompress::DoCompress(const CArticles *aArticles, const TSlovoedStyl
 	}
 	m_Compress->Init(m_Out);
 
-	std::vector<uint16_t> blockType;
-	std::u16string text16;
-	auto compress = [&](const CArticle &article) {
-		//       
-		//      0.
-		//          
-		blockType.resize(article.GetBlockCount() + 1);
-		for (auto&& block : enumerate(article.blocks()))
-			blockType[block.index] = block->styleNumber;
-		blockType[article.GetBlockCount()] = '\0';
-
-		int error = m_Compress->AddText(blockType.data(), static_cast<uint32_t>(blockType.size()), SLD_TREE_BLOCKTYPE);
-		if (error != ERROR_NO)
-			return error;
-
-		size_t maxTextSize = 0;
-		for (const BlockType &block : article.blocks())
-		{
-			sld::as_utf16(block.text, text16);
-			maxTextSize = (std::max)(maxTextSize, text16.size());
+	//    
+	const UInt32 articlesCount = aArticles->GetNumberOfArticles();
+	UInt32 shardsCount = 1;
+	if (aThreadPool.active() && articlesCount > ArticlesPerShard && m_Compress->SupportsShards())
+		shardsCount = (articlesCount + ArticlesPerShard - 1) / ArticlesPerShard;
 
-			error = m_Compress->AddText((const UInt16*)text16.c_str(), (UInt32)text16.length() + 1, block.styleNumber);
-			if (error != ERROR_NO)
-				return error;
-		}
-		m_maxTextSize = (std::max)(m_maxTextSize, static_cast<UInt32>(maxTextSize));
-		return ERROR_NO;
-	};
+	std::vector<ArticlesShard> shards(shardsCount);
+	for (UInt32 i : xrange(shardsCount))
+	{
+		shards[i].begin = shardsCount == 1 ? 0 : i * ArticlesPerShard;
+		shards[i].end = shardsCount == 1 ? articlesCount : (std::min)(articlesCount, (i + 1) * ArticlesPerShard);
+	}
 
 	//////////////////////////////////////////////////////////////////////////
 	//  .
@@ -107,12 +251,12 @@ int CArticlesCompress::DoCompress(const CArticles *aArticles, const TSlovoedStyl
 	if (error != ERROR_NO)
 		return error;
 
-	for (const CArticle &article : aArticles->articles())
-	{
-		error = compress(article);
-		if (error != ERROR_NO)
-			return error;
-	}
+	error = compressShards(aArticles, m_Compress, shards, false, aThreadPool);
+	if (error != ERROR_NO)
+		return error;
+
+	for (const ArticlesShard &shard : shards)
+		m_maxTextSize = (std::max)(m_maxTextSize, shard.maxTextSize);
 
 	//  ,      
 
@@ -132,36 +276,51 @@ int CArticlesCompress::DoCompress(const CArticles *aArticles, const TSlovoedStyl
 	//////////////////////////////////////////////////////////////////////////
 	//   
 	//////////////////////////////////////////////////////////////////////////
+	error = compressShards(aArticles, m_Compress, shards, true, aThreadPool);
+	if (error != ERROR_NO)
+		return error;
+
 	const UInt32 QAinterleave = aArticles->GetQAInterleave();
 	UInt32 prevCompressedSize = 0;	//        !
 	vector<TQAArticlesEntry> QAArray;
 	vector<TQAArticlesEntry> QAArrayTotal;
+	QAArrayTotal.reserve(articlesCount);
 
-	for (auto article : enumerate(aArticles->articles()))
+	for (ArticlesShard &shard : shards)
 	{
-		//       
-		m_maxWordTypeSize = (std::max)(m_maxWordTypeSize, article->GetBlockCount());
-
-		//////////////////////////////////////////////////////////////////////////
-		//      
-		//////////////////////////////////////////////////////////////////////////
-		const UInt32 currCompressedSize = m_Compress->GetCurrentPos();
-
-		TQAArticlesEntry qa_entry;
-		memset(&qa_entry, 0, sizeof(qa_entry));
-		qa_entry.Index = static_cast<uint32_t>(article.index);
-		qa_entry.ShiftBit = currCompressedSize;
-		QAArrayTotal.push_back(qa_entry);
-		
-		if (currCompressedSize - prevCompressedSize >= QAinterleave || currCompressedSize == 0)
+		//         
+		const UInt32 shardPos = shard.shard ? m_Compress->GetCurrentPos() : 0;
+		for (auto pos : enumerate(shard.positions))
 		{
-			QAArray.push_back(qa_entry);
-			prevCompressedSize = currCompressedSize;
+			//////////////////////////////////////////////////////////////////////////
+			//      
+			//////////////////////////////////////////////////////////////////////////
+			const UInt32 currCompressedSize = shardPos + *pos;
+
+			TQAArticlesEntry qa_entry;
+			memset(&qa_entry, 0, sizeof(qa_entry));
+			qa_entry.Index = static_cast<uint32_t>(shard.begin + pos.index);
+			qa_entry.ShiftBit = currCompressedSize;
+			QAArrayTotal.push_back(qa_entry);
+
+			if (currCompressedSize - prevCompressedSize >= QAinterleave || currCompressedSize == 0)
+			{
+				QAArray.push_back(qa_entry);
+				prevCompressedSize = currCompressedSize;
+			}
 		}
 
-		error = compress(*article);
-		if (error != ERROR_NO)
-			return error;
+		if (shard.shard)
+		{
+			error = m_Out.AddOut(shard.out);
+			if (error != ERROR_NO)
+				return error;
+			shard.out.ClearContent();
+			shard.shard.reset();
+		}
+
+		//       
+		m_maxWordTypeSize = (std::max)(m_maxWordTypeSize, shard.maxWordTypeSize);
 	}
 	//  0
 	m_maxWordTypeSize++;
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <initializer_list>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <type_traits>
 
@@ -11,6 +12,7 @@
 #include "sld_Platform.h"
 #include "SlovoEdProject.h"
 #include "StringFunctions.h"
+#include "ThreadPool.h"
 #include "Tools.h"
 #include "XmlTagContent.h"
 
@@ -2597,9 +2599,259 @@ static int loadArticles(pugi::xml_node aNode, Loader load)
 	return ERROR_NO;
 }
 
+// splitting of large article files into independently parsed chunks
+namespace {
+
+// Минимальный размер (в байтах) части файла со статьями при параллельном разборе;
+// файлы меньше двух частей разбираются целиком
+enum : size_t { ArticlesChunkSize = 32 * 1024 * 1024 };
+
+// a part of an articles file containing a run of whole <article> elements
+// parsed as a separate xml fragment (with its own pugixml memory arena)
+struct ArticlesChunk
+{
+	void *data;
+	size_t size;
+	pugi::xml_encoding encoding;
+
+	pugi::xml_document doc;
+	pugi::xml_parse_result result;
+};
+
+using ArticlesChunks = std::vector<std::unique_ptr<ArticlesChunk>>;
+
+// a minimal xml tokenizer finding the top level <article> elements boundaries
+// works directly on the source code units and only understands enough of xml
+// to skip over comments, cdata, processing instructions and attribute values
+// fills @aBounds with: the start of the <Articles> content, the split points and
+// the start of the </Articles> tag; returns false if the file can't be split
+template <typename Char>
+static bool findArticlesBounds(const Char *aText, size_t aSize, size_t aChunkSize, std::vector<size_t> &aBounds)
+{
+	const auto startsWith = [aText, aSize](size_t pos, const char *str) {
+		for (; *str; str++, pos++)
+		{
+			if (pos >= aSize || aText[pos] != static_cast<Char>(*str))
+				return false;
+		}
+		return true;
+	};
+	// returns the position right after @str or aSize if not found
+	const auto skipPast = [aText, aSize, &startsWith](size_t pos, const char *str) {
+		for (; pos < aSize; pos++)
+		{
+			if (aText[pos] == static_cast<Char>(*str) && startsWith(pos, str))
+				return pos + strlen(str);
+		}
+		return aSize;
+	};
+	const auto nameEquals = [aText](size_t pos, size_t end, const char *str) {
+		for (; pos < end && *str; str++, pos++)
+		{
+			if (aText[pos] != static_cast<Char>(*str))
+				return false;
+		}
+		return pos == end && *str == '\0';
+	};
+	const auto isSpace = [](Char ch) { return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n'; };
+
+	aBounds.clear();
+	size_t depth = 0;
+	size_t pos = 0;
+	while (pos < aSize)
+	{
+		if (aText[pos] != '<')
+		{
+			pos++;
+			continue;
+		}
+
+		if (startsWith(pos, "<!--"))
+		{
+			pos = skipPast(pos + 4, "-->");
+		}
+		else if (startsWith(pos, "<![CDATA["))
+		{
+			pos = skipPast(pos + 9, "]]>");
+		}
+		else if (startsWith(pos, "<?"))
+		{
+			pos = skipPast(pos + 2, "?>");
+		}
+		else if (startsWith(pos, "<!"))
+		{
+			// doctype; internal subsets are not supported here
+			const size_t end = skipPast(pos, ">");
+			for (size_t i = pos; i < end; i++)
+			{
+				if (aText[i] == '[')
+					return false;
+			}
+			pos = end;
+		}
+		else if (startsWith(pos, "</"))
+		{
+			if (depth == 0)
+				return false;
+			if (--depth == 0)
+			{
+				aBounds.push_back(pos);
+				return aBounds.size() > 2;
+			}
+			pos = skipPast(pos, ">");
+		}
+		else
+		{
+			const size_t tagStart = pos;
+			size_t nameEnd = pos + 1;
+			while (nameEnd < aSize && !isSpace(aText[nameEnd]) && aText[nameEnd] != '>' && aText[nameEnd] != '/')
+				nameEnd++;
+
+			Char quote = 0;
+			for (pos = nameEnd; pos < aSize; pos++)
+			{
+				const Char ch = aText[pos];
+				if (quote)
+				{
+					if (ch == quote)
+						quote = 0;
+				}
+				else if (ch == '"' || ch == '\'')
+					quote = ch;
+				else if (ch == '>')
+					break;
+			}
+			if (pos == aSize)
+				return false;
+
+			const bool selfClosing = aText[pos - 1] == '/';
+			pos++;
+
+			if (depth == 0)
+			{
+				if (selfClosing || !nameEquals(tagStart + 1, nameEnd, "Articles"))
+					return false;
+				aBounds.push_back(pos);
+			}
+			else if (depth == 1 && tagStart - aBounds.back() >= aChunkSize && nameEquals(tagStart + 1, nameEnd, "article"))
+			{
+				aBounds.push_back(tagStart);
+			}
+
+			if (!selfClosing)
+				depth++;
+		}
+	}
+	return false;
+}
+
+// checks that the xml declaration (if any) doesn't name an encoding other than
+// a unicode one; pugixml doesn't convert from such encodings and the chunks must
+// be parsed exactly in the same way as the whole file would be
+template <typename Char>
+static bool hasUnicodeDeclaration(const Char *aText, size_t aSize)
+{
+	const auto startsWith = [aText, aSize](size_t pos, const char *str) {
+		for (; *str; str++, pos++)
+		{
+			if (pos >= aSize || aText[pos] != static_cast<Char>(*str))
+				return false;
+		}
+		return true;
+	};
+	const auto toLower = [](Char ch) { return ch >= 'A' && ch <= 'Z' ? static_cast<Char>(ch - 'A' + 'a') : ch; };
+	const auto isSpace = [](Char ch) { return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n'; };
+
+	if (!startsWith(0, "<?xml") || aSize < 6 || !isSpace(aText[5]))
+		return true;
+
+	size_t end = 5;
+	while (end < aSize && !startsWith(end, "?>"))
+		end++;
+
+	for (size_t pos = 5; pos < end; pos++)
+	{
+		if (!isSpace(aText[pos - 1]) || !startsWith(pos, "encoding"))
+			continue;
+
+		pos += 8;
+		while (pos < end && isSpace(aText[pos]))
+			pos++;
+		if (pos == end || aText[pos] != '=')
+			return false;
+		pos++;
+		while (pos < end && isSpace(aText[pos]))
+			pos++;
+		if (pos == end || (aText[pos] != '"' && aText[pos] != '\''))
+			return false;
+		pos++;
+
+		return end - pos > 3 && toLower(aText[pos]) == 'u' && toLower(aText[pos + 1]) == 't' && toLower(aText[pos + 2]) == 'f';
+	}
+	return true;
+}
+
+// returns the chunks of the articles file data or an empty vector if the data
+// should be parsed as a whole
+// the chunks point directly into @aData (which must outlive them)
+template <typename Char>
+static ArticlesChunks splitArticles(MemoryBuffer &aData, size_t aOffset, pugi::xml_encoding aEncoding)
+{
+	ArticlesChunks chunks;
+
+	Char *text = reinterpret_cast<Char*>(aData.data() + aOffset);
+	const size_t size = (aData.size() - aOffset) / sizeof(Char);
+
+	if (!hasUnicodeDeclaration(text, size))
+		return chunks;
+
+	std::vector<size_t> bounds;
+	if (!findArticlesBounds(text, size, ArticlesChunkSize / sizeof(Char), bounds))
+		return chunks;
+
+	for (size_t i : xrange(bounds.size() - 1))
+	{
+		chunks.emplace_back(new ArticlesChunk());
+		ArticlesChunk &chunk = *chunks.back();
+		chunk.data = text + bounds[i];
+		chunk.size = (bounds[i + 1] - bounds[i]) * sizeof(Char);
+		chunk.encoding = aEncoding;
+	}
+	return chunks;
+}
+
+// splits the articles file data into chunks at the top level <article> elements
+// boundaries; only utf8 and utf16le sources are split (the encoding is guessed
+// in the same way pugixml does it, an xml declaration naming some other encoding
+// disables the splitting), everything else is parsed as a whole
+static ArticlesChunks splitArticlesFile(MemoryBuffer &aData)
+{
+	const uint8_t *d = aData.data();
+	if (aData.size() < 2 * ArticlesChunkSize)
+		return ArticlesChunks();
+
+	if (d[0] == 0xef && d[1] == 0xbb && d[2] == 0xbf)
+		return splitArticles<uint8_t>(aData, 3, pugi::encoding_utf8);
+	if (d[0] == 0xff && d[1] == 0xfe && (d[2] != 0 || d[3] != 0))
+		return splitArticles<uint16_t>(aData, 2, pugi::encoding_utf16_le);
+	if (d[0] == 0x3c && d[1] == 0 && (d[2] != 0 || d[3] != 0))
+		return splitArticles<uint16_t>(aData, 0, pugi::encoding_utf16_le);
+	if (d[0] == 0x3c && d[1] != 0)
+		return splitArticles<uint8_t>(aData, 0, pugi::encoding_utf8);
+
+	return ArticlesChunks();
+}
+
+} // anon namespace
+
 /**
  * Производит загрузку статей из файла
  *
+ * Большие файлы делятся на части по границам статей, которые разбираются
+ * парсером параллельно (каждая часть в собственный xml-документ). Сами статьи
+ * затем создаются последовательно в порядке следования в файле, так что
+ * результат не отличается от разбора файла целиком.
+ *
  * @param[in] aFileName - имя файла со статьями
  *
  * @return код ошибки
@@ -2613,13 +2865,51 @@ int ArticlesLoader::Load(const std::wstring &aFileName)
 
 	// Загрузка xml-файла
 	m_timer.Start();
+	MemoryBuffer fileData;
+	ArticlesChunks chunks;
+	// файлы меньше двух частей не делятся, поэтому и не читаются в память заранее
+	if (m_threadPool.active() && sld::file_size(aFileName) >= 2 * ArticlesChunkSize)
+	{
+		fileData = sld::read_file(aFileName);
+		chunks = splitArticlesFile(fileData);
+	}
+
 	pugi::xml_document XmlDoc;
-	const auto result = XmlDoc.load_file(aFileName.c_str());
-	if (!result)
+	pugi::xml_node RootNode;
+	if (chunks.empty())
 	{
-		sldILog("Error! Can't load xml file `%s`: %s\n", sld::as_ref(aFileName), result.description());
-		CLogW::PrintToConsole("[FAIL]", eLogStatus_Error);
-		return ERROR_CANT_OPEN_FILE;
+		fileData = MemoryBuffer();
+
+		const auto result = XmlDoc.load_file(aFileName.c_str());
+		if (!result)
+		{
+			sldILog("Error! Can't load xml file `%s`: %s\n", sld::as_ref(aFileName), result.description());
+			CLogW::PrintToConsole("[FAIL]", eLogStatus_Error);
+			return ERROR_CANT_OPEN_FILE;
+		}
+	}
+	else
+	{
+		std::vector<ThreadPool::Task> tasks(chunks.size());
+		for (size_t i : indices(chunks))
+		{
+			ArticlesChunk *chunk = chunks[i].get();
+			tasks[i] = m_threadPool.queue([chunk]() {
+				chunk->result = chunk->doc.load_buffer_inplace(chunk->data, chunk->size,
+															   pugi::parse_default | pugi::parse_fragment, chunk->encoding);
+			});
+		}
+		m_threadPool.complete(tasks.data(), tasks.size());
+
+		for (const auto &chunk : chunks)
+		{
+			if (!chunk->result)
+			{
+				sldILog("Error! Can't load xml file `%s`: %s\n", sld::as_ref(aFileName), chunk->result.description());
+				CLogW::PrintToConsole("[FAIL]", eLogStatus_Error);
+				return ERROR_CANT_OPEN_FILE;
+			}
+		}
 	}
 
 	m_timer.Stop();
@@ -2629,21 +2919,25 @@ int ArticlesLoader::Load(const std::wstring &aFileName)
 	// Парсинг
 	m_timer.Start();
 
-	pugi::xml_node RootNode = XmlDoc.first_child();
-	wstring RootNodeName(RootNode.name());
-
-	if (RootNodeName != L"Articles")
+	// корень и наличие статей проверены при разбиении файла на части
+	if (chunks.empty())
 	{
-		sldXLog("Error! Wrong articles tag: %s\n", sld::as_ref(RootNodeName));
-		CLogW::PrintToConsole("[FAIL]", eLogStatus_Error);
-		return ERROR_WRONG_TAG;
-	}
+		RootNode = XmlDoc.first_child();
+		wstring RootNodeName(RootNode.name());
 
-	if (!XmlDoc.first_child().first_child())
-	{
-		sldXLog("Error! Empty Articles tag!\n");
-		CLogW::PrintToConsole("[FAIL]", eLogStatus_Error);
-		return ERROR_WRONG_TAG;
+		if (RootNodeName != L"Articles")
+		{
+			sldXLog("Error! Wrong articles tag: %s\n", sld::as_ref(RootNodeName));
+			CLogW::PrintToConsole("[FAIL]", eLogStatus_Error);
+			return ERROR_WRONG_TAG;
+		}
+
+		if (!XmlDoc.first_child().first_child())
+		{
+			sldXLog("Error! Empty Articles tag!\n");
+			CLogW::PrintToConsole("[FAIL]", eLogStatus_Error);
+			return ERROR_WRONG_TAG;
+		}
 	}
 
 	struct ErrorStats {
@@ -2666,7 +2960,7 @@ int ArticlesLoader::Load(const std::wstring &aFileName)
 	sld::printf("\nLoaded 0 articles");
 	UInt32 i = 0;
 	RateLimit rlimit;
-	int error = loadArticles(RootNode, [&](pugi::xml_node node) {
+	const auto loadArticle = [&](pugi::xml_node node) {
 		int error = LoadArticle(node, ctx);
 		if (error != ERROR_NO)
 			return error;
@@ -2682,9 +2976,21 @@ int ArticlesLoader::Load(const std::wstring &aFileName)
 		i++;
 
 		return ERROR_NO;
-	});
-	if (error != ERROR_NO)
-		return error;
+	};
+
+	if (chunks.empty())
+	{
+		int error = loadArticles(RootNode, loadArticle);
+		if (error != ERROR_NO)
+			return error;
+	}
+
+	for (const auto &chunk : chunks)
+	{
+		int error = loadArticles(chunk->doc, loadArticle);
+		if (error != ERROR_NO)
+			return error;
+	}
 
 	printCount(i, errorStats);
 
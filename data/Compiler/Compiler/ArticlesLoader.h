@@ -17,13 +17,16 @@ class CSSDataManager;
 class CWordList;
 class MetadataManager;
 class TSlovoedStyleManager;
+class ThreadPool;
 
 // Загрузчик статей
 class ArticlesLoader
 {
 public:
-	ArticlesLoader(CArticles &aArticles, MetadataManager &aMetadata, CSSDataManager &aCSS, TSlovoedStyleManager &aStyles, CWordList &aAtomicList)
-		: m_articles(aArticles), m_metadata(aMetadata), m_css(aCSS), m_styles(aStyles), m_atomicList(aAtomicList), m_error(0)
+	ArticlesLoader(CArticles &aArticles, MetadataManager &aMetadata, CSSDataManager &aCSS, TSlovoedStyleManager &aStyles, CWordList &aAtomicList,
+				   ThreadPool &aThreadPool)
+		: m_articles(aArticles), m_metadata(aMetadata), m_css(aCSS), m_styles(aStyles), m_atomicList(aAtomicList),
+		  m_threadPool(aThreadPool), m_error(0)
 	{
 		m_timer.SetFilename("XmlParsingTimeArticles.time");
 	}
@@ -70,6 +73,9 @@ private:
 	TSlovoedStyleManager &m_styles;
 	CWordList &m_atomicList;
 
+	/// Thread pool для параллельного разбора больших файлов со статьями
+	ThreadPool &m_threadPool;
+
 	/// Контейнер картинок
 	CImageContainer m_imageContainer;
 
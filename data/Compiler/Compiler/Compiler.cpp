@@ -29,7 +29,7 @@ void PrintHead(void)
 
 void PrintUsage(void)
 {
-	sld::printf("Usage: Compiler.exe filename.sproj [Process Priority] [Resource Compression]\n\n");
+	sld::printf("Usage: Compiler.exe filename.sproj [Process Priority] [Resource Compression] [Memory Usage] [Integrity]\n\n");
 
 	sld::printf("[Process Priority]: -p[1-5]\n");
 	sld::printf("\t-p1 - LOW priority\n");
@@ -41,7 +41,13 @@ void PrintUsage(void)
 	sld::printf("[Resource Compression]: -norc\n");
 	sld::printf("\t-norc[=lists] Disables resource compression\n");
 	sld::printf("\t     Parameters (optional):\n");
-	sld::printf("\t       lists - disables list resources compression:\n");
+	sld::printf("\t       lists - disables list resources compression:\n\n");
+
+	sld::printf("[Memory Usage]: -spill\n");
+	sld::printf("\t-spill Stores resource data in a temporary file instead of memory\n\n");
+
+	sld::printf("[Integrity]: -rcrc\n");
+	sld::printf("\t-rcrc Stores a checksum of every resource, so the engine can verify resources as they are loaded\n");
 }
 
 static const wchar_t* GetErrorDescription(int aCode)
@@ -84,6 +90,7 @@ static const wchar_t* GetErrorDescription(int aCode)
 	error_case(SDC_WRITE_ALREADY_EXIST)
 	error_case(SDC_WRITE_CANT_CREATE_FILE)
 	error_case(SDC_WRITE_CANT_WRITE)
+	error_case(SDC_WRITE_CANT_ENABLE_SPILL)
 	error_case(SDC_READ_ERRORS)
 	error_case(SDC_READ_CANT_OPEN_FILE)
 	error_case(SDC_READ_CANT_READ)
@@ -221,6 +228,10 @@ int main(int argc, char* argv[])
 			if (arg == L"lists")
 				compConfig.setCanCompressListResources(false);
 		}
+		else if (arg == L"-spill")
+			compConfig.setSpillResources(true);
+		else if (arg == L"-rcrc")
+			compConfig.setResourceCRC(true);
 	}
 	
 	//   
@@ -252,7 +263,7 @@ int main(int argc, char* argv[])
 #endif
 	sld::printf("Loading project `%s`...", sld::as_ref(file1));
 
-	int error = proj.Load(file1);
+	int error = proj.Load(file1, threadPool);
 	if (error != ERROR_NO)
 		ErrorOut(error);
 
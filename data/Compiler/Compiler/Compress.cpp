@@ -234,6 +234,15 @@ int CCompress::DoCompress()
 {
 	CMyProcessTimer timer("CompressTime.time");
 
+	if (m_resCompCfg.spillResources())
+	{
+		SDCError error = m_SDC.EnableSpill();
+		if (error != SDC_OK)
+			return error;
+	}
+
+	m_SDC.EnableResourceCRC(m_resCompCfg.resourceCRC());
+
 	for (auto&& step : g_CompressSteps)
 	{
 		int error = doCompressStep(step.msg, timer, step.funcName,
@@ -283,6 +292,7 @@ struct SortListData
 	CWordList *list;
 	const CWordList *baseList;
 	const CStringCompare *compare;
+	ThreadPool *threadPool;
 	int error;
 };
 
@@ -296,7 +306,7 @@ static int sortList(const SortListData *data)
 	if (error != ERROR_NO)
 		return error;
 
-	error = data->list->DoSort(data->compare);
+	error = data->list->DoSort(data->compare, *data->threadPool);
 	if (error != ERROR_NO)
 		return error;
 
@@ -307,6 +317,9 @@ static int sortList(const SortListData *data)
 
 static int sortLists(ThreadPool &threadPool, std::vector<SortListData> &lists)
 {
+	for (SortListData &data : lists)
+		data.threadPool = &threadPool;
+
 	if (lists.size() <= 1 || !threadPool.active())
 	{
 		for (SortListData &data : lists)
@@ -1451,6 +1464,7 @@ int CCompress::DoCompressLists()
 		listHeader.Type_DirectWordsShifts = 0;
 		listHeader.Type_SearchTreePoints = 0;
 		listHeader.Type_AlternativeHeadwordsInfo = 0;
+		listHeader.Type_HierarchyParents = 0;
 		listHeader.MaximumWordSize = compressedList->GetMaxWordSize();
 
 		listHeader.IsFullTextSearchList = (list->IsFullTextSearchList() || list->GetLinkedList()) ? 1 : 0;
@@ -1475,6 +1489,9 @@ int CCompress::DoCompressLists()
 
 		if (compressedList->GetAlternativeHeadwordInfo().size())
 			listHeader.Type_AlternativeHeadwordsInfo = RESOURCE_TYPE_ALTERNATIVE_HEADWORD_INFO + list.index;
+
+		if (list->GetHierarchyParentsData().size())
+			listHeader.Type_HierarchyParents = SLD_RESOURCE_HIERARCHY_PARENTS + list.index;
 	}
 
 	return ERROR_NO;
@@ -2238,6 +2255,14 @@ int CCompress::DoAddListResourcesToSDC(UInt32 aListIndex)
 			return error;
 	}
 
+	// Таблица родителей уровней иерархии
+	if (listHeader.Type_HierarchyParents)
+	{
+		error = m_SDC.AddResource(m_Project->GetWordList(aListIndex)->GetHierarchyParentsData(), listHeader.Type_HierarchyParents, 0);
+		if (error != SDC_OK)
+			return error;
+	}
+
 	// Сжатые данные
 	resData = compList->GetCompressedData();
 	error = addChunkedResource(resData, listHeader.Type_CompressedData);
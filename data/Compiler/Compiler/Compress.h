@@ -46,9 +46,27 @@ public:
 		return m_compressListsResources;
 	}
 
+	/// Нужно ли сбрасывать данные ресурсов на диск сразу при их добавлении в контейнер
+	void setSpillResources(bool state) {
+		m_spillResources = state;
+	}
+	bool spillResources() const {
+		return m_spillResources;
+	}
+
+	/// Нужно ли записывать в контейнер таблицу контрольных сумм отдельных ресурсов
+	void setResourceCRC(bool state) {
+		m_resourceCRC = state;
+	}
+	bool resourceCRC() const {
+		return m_resourceCRC;
+	}
+
 private:
 	std::pair<bool, CSDCWrite::CompressionConfig> m_resourcesCfg;
 	bool m_compressListsResources = true;
+	bool m_spillResources = false;
+	bool m_resourceCRC = false;
 };
 
 /// Производит сжатие и упаковку словаря в контейнер
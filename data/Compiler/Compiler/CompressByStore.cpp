@@ -53,6 +53,29 @@ UInt32 CCompressByStore::GetCompressedTreeCount() const
 	return 0;
 }
 
+///         
+/** ********************************************************************
+*    ,     ,
+*     .
+*
+* @return   
+************************************************************************/
+ICompressBy* CCompressByStore::CreateShard() const
+{
+	CCompressByStore *shard = new CCompressByStore;
+	shard->m_Mode = m_Mode;
+	return shard;
+}
+
+/// ,      
+/** ********************************************************************
+* @return true,        
+************************************************************************/
+bool CCompressByStore::SupportsShards() const
+{
+	return true;
+}
+
 ///    .
 MemoryRef CCompressByStore::GetCompressedTree(UInt32 aIndex)
 {
@@ -42,6 +42,12 @@ public:
 	************************************************************************/
 	UInt32 GetCompressedTreeCount() const override;
 
+	///         
+	ICompressBy* CreateShard() const override;
+
+	/// ,      
+	bool SupportsShards() const override;
+
 protected:
 	///      
 	int BuildTrees() override;
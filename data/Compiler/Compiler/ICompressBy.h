@@ -123,6 +123,27 @@ public:
 	* @return  
 	************************************************************************/
 	virtual int GetCompressedTree(UInt32 aIndex, const UInt8 **aDataPtr, UInt32 *aDataSize) = 0;
+
+	/** ********************************************************************
+	*         
+	* (   ).
+	*
+	*      ,    ,   
+	*   ,    @ref Init.   
+	* ,  ,     
+	* @ref eInitialization,    (. @ref SupportsShards).
+	*
+	* @return    (  ) 
+	*         nullptr,      
+	************************************************************************/
+	virtual ICompressBy* CreateShard() const { return nullptr; }
+
+	/** ********************************************************************
+	* ,       (@ref CreateShard)
+	*
+	* @return true,       
+	************************************************************************/
+	virtual bool SupportsShards() const { return false; }
 };
 
 ///          
@@ -87,6 +87,15 @@ static void UpdateQAIndexesHeader(TIndexesHeader& aHeader, const CWordList *aLis
 			aHeader.SizeOfCount = aList->GetNumberOfArticlesSize();
 		}
 	}
+
+	//       ,      .
+	//    ,       
+	if (aList->GetByteAlignedIndexes() && (aHeader.DataMask & SLD_INDEXES_IS_ARTICLE_INDEX))
+	{
+		for (UInt32 *size : { &aHeader.SizeOfIndexes, &aHeader.SizeOfListIndex, &aHeader.SizeOfTranslationIndex, &aHeader.SizeOfShiftIndex })
+			*size = (*size + 7) & ~7u;
+		aHeader.DataMask |= SLD_INDEXES_IS_BYTE_ALIGNED;
+	}
 }
 
 /**
@@ -224,7 +233,7 @@ int CListCompress::DoCompress(CWordList *aList)
 		//       , 
 		//    (    -  )
 		if (aList->IsFullTextSearchList() || aList->GetLinkedList())
-			error = AddFullTextSearchIndexes(aList, *elem, &PrevQAIndexesPosition);
+			error = AddFullTextSearchIndexes(*elem, &PrevQAIndexesPosition);
 		else
 			error = AddIndexes(aList, *elem, &PrevQAIndexesPosition);
 		if (error != ERROR_NO)
@@ -373,13 +382,12 @@ int CListCompress::AddIndexes(const CWordList *aList, const ListElement &aListEl
 	  (     ) ,
 	      
 
-	@param[in] aList				-    .
 	@param[in] aListElem			-    
 	@param[in|out] aPrevQAPosition	-        .
 
 	@return  .
 */
-int CListCompress::AddFullTextSearchIndexes(const CWordList *aList, const ListElement &aListElem, UInt32 *aPrevQAPosition)
+int CListCompress::AddFullTextSearchIndexes(const ListElement &aListElem, UInt32 *aPrevQAPosition)
 {
 	int error;
 
@@ -402,10 +410,11 @@ int CListCompress::AddFullTextSearchIndexes(const CWordList *aList, const ListEl
 		return ERROR_WRONG_LIST_TYPE;
 	}
 
-	const UInt32 ListIndexSize = aList->GetFullTextSearchLinkListIndexSize();
-	const UInt32 ListEntryIndexSize = aList->GetFullTextSearchLinkListEntryIndexSize();
-	const UInt32 TranslationIndexSize = aList->GetFullTextSearchLinkTranslationIndexSize();
-	const UInt32 ShiftIndexSize = aList->GetFullTextSearchShiftIndexSize();
+	//     , ..       
+	const UInt32 ListIndexSize = m_IndexesHeader.SizeOfListIndex;
+	const UInt32 ListEntryIndexSize = m_IndexesHeader.SizeOfIndexes;
+	const UInt32 TranslationIndexSize = m_IndexesHeader.SizeOfTranslationIndex;
+	const UInt32 ShiftIndexSize = m_IndexesHeader.SizeOfShiftIndex;
 
 	for (auto&& ref : aListElem.ListEntryRefs)
 	{
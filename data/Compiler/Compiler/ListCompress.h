@@ -86,7 +86,7 @@ private:
 	///   (     ) .
 	int AddIndexes(const CWordList *aList, const ListElement &aListElem, UInt32 *aPrevQAPosition);
 	///   (     ) ,       
-	int AddFullTextSearchIndexes(const CWordList* aList, const ListElement &aListElem, UInt32* aPrevQAPosition);
+	int AddFullTextSearchIndexes(const ListElement &aListElem, UInt32* aPrevQAPosition);
 
 	///    (, , , )   
 	int AddMediaIndexes(const CWordList* aList, const ListElement &aListElem);
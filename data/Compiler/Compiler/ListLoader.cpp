@@ -154,6 +154,13 @@ int CListLoader::Load(pugi::xml_node aNode, UInt32 aDictLangCodeFrom)
 			if (error == ERROR_NO)
 				m_list.SetSorted(sorted);
 		}
+		else if (nodeName == L"ByteAlignedIndexes")
+		{
+			bool byteAligned;
+			error = ParseBoolParamNode(node, byteAligned, BoolType::YesNo);
+			if (error == ERROR_NO)
+				m_list.SetByteAlignedIndexes(byteAligned);
+		}
 		else if (nodeName == L"isListHasLocalizedEntries")
 		{
 			error = ParseBoolParamNode(node, m_list.m_isLocalizedEntriesList, BoolType::YesNo);
@@ -122,6 +122,30 @@ int COut::AddBits(UInt64 aData, UInt32 sizeBits)
 	return ERROR_NO;
 }
 
+// 	       
+/**
+	     ,    
+	 ,      aOut     .
+
+	@param[in] aOut - ,    
+
+	@return  
+*/
+int COut::AddOut(const COut &aOut)
+{
+	int error;
+	for (UInt32 i = 0; i < aOut.m_Byte; i++)
+	{
+		error = AddBits(aOut.m_buffer[i], OUT_BIT_COUNT);
+		if (error != ERROR_NO)
+			return error;
+	}
+
+	if (aOut.m_Bit)
+		return AddBits(aOut.m_buffer[aOut.m_Byte], aOut.m_Bit);
+
+	return ERROR_NO;
+}
 
 //        .
 UInt32 COut::GetCurrentPos() const
@@ -22,6 +22,9 @@ public:
 	///     
 	int AddBits(UInt64 aData, UInt32 sizeBits);
 
+	///        
+	int AddOut(const COut &aOut);
+
 	///        .
 	UInt32 GetCurrentPos() const;
 
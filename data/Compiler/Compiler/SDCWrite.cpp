@@ -10,16 +10,52 @@
 const CSDCWrite::CompressionConfig CSDCWrite::DefaultCompression = { eSDCResourceCompression_None, 0, 0 };
 const CSDCWrite::CompressionConfig CSDCWrite::NoCompression = { eSDCResourceCompression_None, 0, 0 };
 
+//  ,        
+static const size_t SpillCopyBufferSize = 1 << 20;
+
+static uint32_t compress(CSDCWrite::Resource &resource, std::vector<char> &decompressed);
+
 CSDCWrite::CSDCWrite(void)
 {
 	m_DatabaseType = 1;
 	m_DictID = 0;
 	m_IsInApp = 0;
+	m_Spill = nullptr;
+	m_ResourceCRC = false;
 	useOverrideCompressionCfg = false;
 	overrideCompressionCfg = DefaultCompression;
 }
 
-CSDCWrite::~CSDCWrite(void) {}
+CSDCWrite::~CSDCWrite(void)
+{
+	if (m_Spill)
+		fclose(m_Spill);
+}
+
+/**
+	 ,        
+	    ,       .
+	        ,
+	    .     .
+
+	@return  .
+*/
+SDCError CSDCWrite::EnableSpill()
+{
+	if (m_Spill)
+		return SDC_OK;
+
+	if (!m_Data.empty())
+		return SDC_WRITE_CANT_ENABLE_SPILL;
+
+	m_Spill = tmpfile();
+	if (!m_Spill)
+	{
+		sld::printf("\nError! Can't create temporary file for SDC resources");
+		return SDC_WRITE_CANT_ENABLE_SPILL;
+	}
+	return SDC_OK;
+}
 
 void CSDCWrite::OverrideCompressionConfig(const CompressionConfig &aConfig)
 {
@@ -120,6 +156,21 @@ SDCError CSDCWrite::AddResource(MemoryBuffer&& aData, UInt32 aType, UInt32 aInde
 	else
 		resource.compressionConfig = aCompression;
 
+	if (m_Spill)
+	{
+		//      ,      
+		std::vector<char> decompressed;
+		compress(resource, decompressed);
+
+		const size_t size = resource.buf.size();
+		if (fwrite(resource.buf.data(), 1, size, m_Spill) != size)
+			return SDC_WRITE_CANT_WRITE;
+
+		resource.Spilled = true;
+		resource.SpilledSize = static_cast<uint32_t>(size);
+		resource.buf = MemoryBuffer();
+	}
+
 	m_Data.push_back(std::move(resource));
 
 	return SDC_OK;
@@ -267,50 +318,59 @@ static bool testDecomp(ESDCResourceCompressionType compressionType,
 	return false;
 }
 
-// tries to compresses all the resources, returns the number of compressed resources
-static uint32_t compress(std::vector<CSDCWrite::Resource> &resources)
+// tries to compress a single resource, returns 1 if the resource was compressed
+static uint32_t compress(CSDCWrite::Resource &resource, std::vector<char> &decompressed)
 {
-	// cached "resource" used for decompression testing
-	std::vector<char> decompressed;
+	ESDCResourceCompressionType compressionType = resource.compressionConfig.type;
 
-	for (CSDCWrite::Resource &resource : resources)
+	// skip resources marked as uncompressible
+	if (compressionType == eSDCResourceCompression_None)
+		return 0;
+
+	// skip too small resources
+	if (resource.buf.size() < resource.compressionConfig.minSize)
+		return 0;
+
+	MemoryBuffer compressed;
+	switch (compressionType)
 	{
-		ESDCResourceCompressionType compressionType = resource.compressionConfig.type;
-		
-		// skip resources marked as uncompressible
-		if (compressionType == eSDCResourceCompression_None)
-			continue;
-
-		// skip too small resources
-		if (resource.buf.size() < resource.compressionConfig.minSize)
-			continue;
-
-		MemoryBuffer compressed;
-		switch (compressionType)
-		{
 
-		case eSDCResourceCompression_None:
-		default:
-			assert(!"Unhandled compression type!"); break;
-		}
+	case eSDCResourceCompression_None:
+	default:
+		assert(!"Unhandled compression type!"); break;
+	}
 
-		if (compressed.empty())
-			continue;
+	if (compressed.empty())
+		return 0;
 
-		if (!testDecomp(compressionType, resource.buf, compressed, decompressed))
-		{
-			assert(!"Decompression test failed!");
-			continue;
-		}
+	if (!testDecomp(compressionType, resource.buf, compressed, decompressed))
+	{
+		assert(!"Decompression test failed!");
+		return 0;
+	}
 
-		// skip resources with bad compression ratio
-		const double ratio = 1.0 - (double(compressed.size()) / double(resource.buf.size()));
-		if (ratio < resource.compressionConfig.threshold)
-			continue;
+	// skip resources with bad compression ratio
+	const double ratio = 1.0 - (double(compressed.size()) / double(resource.buf.size()));
+	if (ratio < resource.compressionConfig.threshold)
+		return 0;
+
+	// update the resource
+	resource.buf = std::move(compressed);
+	resource.CompressionType = compressionType;
+	return 1;
+}
+
+// tries to compresses all the resources, returns the number of compressed resources
+static uint32_t compress(std::vector<CSDCWrite::Resource> &resources)
+{
+	// cached "resource" used for decompression testing
+	std::vector<char> decompressed;
 
-		// update the resource
-		resource.buf = std::move(compressed);
-		resource.CompressionType = compressionType;
+	// spilled resources are compressed when they are added
+	for (CSDCWrite::Resource &resource : resources)
+	{
+		if (!resource.Spilled)
+			compress(resource, decompressed);
 	}
 
 	size_t totalUncompressedSize = 0;
@@ -319,7 +379,7 @@ static uint32_t compress(std::vector<CSDCWrite::Resource> &resources)
 	for (const CSDCWrite::Resource &resource : resources)
 	{
 		totalUncompressedSize += resource.UncompressedSize;
-		totalCompressedSize += resource.buf.size();
+		totalCompressedSize += resource.dataSize();
 		if (resource.CompressionType != eSDCResourceCompression_None)
 			compressedResourceCount++;
 	}
@@ -378,6 +438,9 @@ SDCError CSDCWrite::Write(FILE *out)
 	//   
 	header.HasCompressedResources = compress(m_Data) == 0 ? 0 : 1;
 
+	//       ()
+	std::vector<uint32_t> dataShifts(m_Data.size());
+
 	uint32_t fileSize = header.HeaderSize + resTableSize;
 	for (const auto resource : enumerate(m_Data))
 	{
@@ -386,8 +449,9 @@ SDCError CSDCWrite::Write(FILE *out)
 
 		record.Type = resource->Type;
 		record.Index = resource->Index;
-		record.Size = static_cast<UInt32>(resource->buf.size());
+		record.Size = static_cast<UInt32>(resource->dataSize());
 		record.Shift = fileSize;
+		dataShifts[resource.index] = fileSize;
 
 		if (resource->CompressionType != eSDCResourceCompression_None)
 			record.Size += sizeof(SlovoEdContainerCompressedResourceHeader);
@@ -404,6 +468,15 @@ SDCError CSDCWrite::Write(FILE *out)
 	//   
 	header.IsResourceTableSorted = sort(resTable) ? 1 : 0;
 
+	//        
+	std::vector<UInt32> resourceCRC;
+	if (m_ResourceCRC)
+	{
+		resourceCRC.resize(m_Data.size());
+		header.ResourceCRCTableShift = fileSize;
+		fileSize += resTableSize / sizeof(resTable[0]) * sizeof(UInt32);
+	}
+
 	//    .
 	header.FileSize = fileSize;
 
@@ -415,20 +488,70 @@ SDCError CSDCWrite::Write(FILE *out)
 	if (fseek(out, header.HeaderSize + resTableSize, SEEK_SET) != 0)
 		return SDC_WRITE_CANT_WRITE;
 
-	for (const Resource &resource : m_Data)
+	//          
+	if (m_Spill && fseek(m_Spill, 0, SEEK_SET) != 0)
+		return SDC_READ_CANT_POSITIONING;
+
+	std::vector<UInt8> spillBuffer;
+	for (const auto resource : enumerate(m_Data))
 	{
-		if (resource.CompressionType != eSDCResourceCompression_None)
+		//     (,    )
+		UInt32 crc = SDC_CRC32_START_VALUE;
+		const auto update = [&](const void *aData, size_t aSize) {
+			header.CRC = CRC32((const UInt8*)aData, static_cast<UInt32>(aSize), header.CRC, false);
+			if (m_ResourceCRC)
+				crc = CRC32((const UInt8*)aData, static_cast<UInt32>(aSize), crc, false);
+		};
+
+		if (resource->CompressionType != eSDCResourceCompression_None)
 		{
-			const auto hdr = initCompressedHeader(resource);
-			header.CRC = CRC32((const UInt8*)&hdr, sizeof(hdr), header.CRC, false);
+			const auto hdr = initCompressedHeader(*resource);
+			update(&hdr, sizeof(hdr));
 			if (fwrite(&hdr, sizeof(hdr), 1, out) != 1)
 				return SDC_WRITE_CANT_WRITE;
 		}
 
-		const UInt8 *data = (const UInt8*)resource.buf.data();
-		const size_t size = resource.buf.size();
-		header.CRC = CRC32(data, static_cast<UInt32>(size), header.CRC, false);
-		if (fwrite(data, 1, size, out) != size)
+		if (resource->Spilled)
+		{
+			spillBuffer.resize(std::min<size_t>(resource->SpilledSize, SpillCopyBufferSize));
+			for (size_t left = resource->SpilledSize; left;)
+			{
+				const size_t size = std::min(left, spillBuffer.size());
+				if (fread(spillBuffer.data(), 1, size, m_Spill) != size)
+					return SDC_READ_CANT_READ;
+
+				update(spillBuffer.data(), size);
+				if (fwrite(spillBuffer.data(), 1, size, out) != size)
+					return SDC_WRITE_CANT_WRITE;
+				left -= size;
+			}
+		}
+		else
+		{
+			const UInt8 *data = (const UInt8*)resource->buf.data();
+			const size_t size = resource->buf.size();
+			update(data, size);
+			if (fwrite(data, 1, size, out) != size)
+				return SDC_WRITE_CANT_WRITE;
+		}
+
+		if (m_ResourceCRC)
+			resourceCRC[resource.index] = CRC32(nullptr, 0, crc, true);
+	}
+
+	if (m_ResourceCRC)
+	{
+		//      ()  
+		std::vector<UInt32> crcTable(resTable.size());
+		for (const auto record : enumerate(resTable))
+		{
+			const auto it = std::lower_bound(dataShifts.begin(), dataShifts.end(), record->Shift);
+			crcTable[record.index] = resourceCRC[it - dataShifts.begin()];
+		}
+
+		const size_t crcTableSize = crcTable.size() * sizeof(crcTable[0]);
+		header.CRC = CRC32((const UInt8*)crcTable.data(), static_cast<UInt32>(crcTableSize), header.CRC, false);
+		if (fwrite(crcTable.data(), 1, crcTableSize, out) != crcTableSize)
 			return SDC_WRITE_CANT_WRITE;
 	}
 	header.CRC = CRC32(nullptr, 0, header.CRC, true); // finalize
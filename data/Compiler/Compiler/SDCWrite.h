@@ -32,6 +32,15 @@ public:
 	/// 
 	~CSDCWrite(void);
 
+	CSDCWrite(const CSDCWrite&) = delete;
+	CSDCWrite& operator=(const CSDCWrite&) = delete;
+
+	///           
+	SDCError EnableSpill();
+
+	///       
+	void EnableResourceCRC(bool aEnable = true) { m_ResourceCRC = aEnable; }
+
 	///  .
 	SDCError AddResource(const void *aPtr, UInt32 aSize, UInt32 aType, UInt32 aIndex, const CompressionConfig &aCompression = DefaultCompression);
 	///  
@@ -71,11 +80,20 @@ public:
 		//  
 		CompressionConfig compressionConfig;
 
+		///  ,       
+		bool Spilled;
+		///      
+		uint32_t SpilledSize;
+
 		Resource(uint32_t aType, uint32_t aIndex, MemoryBuffer&& aData)
 			: buf(std::move(aData)), Type(aType), Index(aIndex),
 			  UncompressedSize(static_cast<uint32_t>(buf.size())),
-			  CompressionType(eSDCResourceCompression_None)
+			  CompressionType(eSDCResourceCompression_None),
+			  Spilled(false), SpilledSize(0)
 		{}
+
+		///     (  ,   )
+		size_t dataSize() const { return Spilled ? SpilledSize : buf.size(); }
 	};
 
 	///      
@@ -90,6 +108,9 @@ private:
 	///     .
 	std::vector<Resource> m_Data;
 
+	///         (    )
+	FILE *m_Spill;
+
 	///  .
 	UInt32 m_DictID;
 
@@ -98,6 +119,9 @@ private:
 	///  ,   -
 	UInt32 m_IsInApp;
 
+	///       
+	bool m_ResourceCRC;
+
 	///   
 	bool useOverrideCompressionCfg;
 	CompressionConfig overrideCompressionCfg;
@@ -918,10 +918,11 @@ int SlovoEdProject::AddStrings(pugi::xml_node aNode)
 *     
 * 
 * @param aFileName	-  
+* @param aThreadPool	- thread pool   
 *
 * @return  
 ************************************************************************/
-int SlovoEdProject::Load(wstring aFileName)
+int SlovoEdProject::Load(wstring aFileName, ThreadPool &aThreadPool)
 {
 	int error;
 	CMyProcessTimer timerCommonXml("XmlParsingTimeCommon.time");
@@ -1281,7 +1282,7 @@ int SlovoEdProject::Load(wstring aFileName)
 	CWordList atomicList;
 
 	//  
-	ArticlesLoader articlesLoader(m_Articles, m_MetadataManager, m_CSSDataManager, m_Styles, atomicList);
+	ArticlesLoader articlesLoader(m_Articles, m_MetadataManager, m_CSSDataManager, m_Styles, atomicList, aThreadPool);
 
 	for (pugi::xml_node styleNode : styleNodes)
 	{
@@ -38,6 +38,7 @@ using namespace std;
 
 class ArticlesLoader;
 class CListLoader;
+class ThreadPool;
 
 /**
 	     .
@@ -53,7 +54,7 @@ public:
 	~SlovoEdProject(void);
 
 	///   
-	int Load(wstring aFileName);
+	int Load(wstring aFileName, ThreadPool &aThreadPool);
 	
 	///     /     
 	wstring GetVersionInfoFilename(void);
@@ -268,6 +268,23 @@ MemoryBuffer sld::read_file(const std::wstring &path)
 	return buf;
 }
 
+/**
+ * Returns the size of a file
+ * On any error returns 0
+ */
+size_t sld::file_size(const std::wstring &path)
+{
+	FILE *fp = fopen(path, L"rb");
+	if (!fp)
+		return 0;
+
+	fseek(fp, 0, SEEK_END);
+	const auto length = ftell(fp);
+	fclose(fp);
+
+	return length > 0 ? static_cast<size_t>(length) : 0;
+}
+
 // text file reading helpers
 namespace {
 
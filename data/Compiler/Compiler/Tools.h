@@ -255,6 +255,9 @@ uint32_t as_utf16_len(const wstring_ref &str);
 // reads file contents
 MemoryBuffer read_file(const std::wstring &path);
 
+// returns file size in bytes (0 on any error)
+size_t file_size(const std::wstring &path);
+
 // reads text file contents
 std::wstring read_text_file(const std::wstring &path);
 
@@ -7,10 +7,22 @@
 #include "Log.h"
 #include "StringCompare.h"
 #include "StringFunctions.h"
+#include "ThreadPool.h"
 #include "Tools.h"
 
 namespace {
 
+// precomputed sort key of a list element
+struct ListElementSortKey
+{
+	// the main name converted to utf16 (the compare tables work with utf16)
+	std::u16string name16;
+	// the main name itself
+	const wchar_t *name;
+	// index of the element in the unsorted list
+	UInt32 index;
+};
+
 struct ListElement_Less
 {
 	const CStringCompare *cmp;
@@ -30,8 +42,91 @@ struct ListElement_Less
 			return cmp->StrWCMP(lhs.Name[0].c_str(), rhs.Name[0].c_str(), 1) < 0;
 		return false;
 	}
+
+	// exactly the same ordering but without converting the names on every comparison
+	bool operator()(const ListElementSortKey &lhs, const ListElementSortKey &rhs) const
+	{
+		const UInt16 *lhs16 = (const UInt16*)lhs.name16.c_str();
+		const UInt16 *rhs16 = (const UInt16*)rhs.name16.c_str();
+
+		int res = cmp->StrWCMP16(lhs16, rhs16, 0);
+		if (res != 0)
+			return res < 0;
+
+		res = cmp->StrWCmp(lhs.name, rhs.name);
+		if (res != 0)
+			return res < 0;
+
+		if (cmp->IsCompare2())
+			return cmp->StrWCMP16(lhs16, rhs16, 1) < 0;
+		return false;
+	}
 };
 
+// the minimal count of elements sorted by a single task when sorting in parallel
+enum : size_t { SortChunkSize = 1 << 14 };
+
+// stable sorts the keys using the thread pool
+// the chunks are stable sorted in parallel and then merged pairwise (std::merge
+// is stable too), so the result is exactly the same as for a single stable_sort()
+static void stableSort(std::vector<ListElementSortKey> &aKeys, const ListElement_Less &aLess, ThreadPool &aThreadPool)
+{
+	const size_t count = aKeys.size();
+	if (!aThreadPool.active() || count < 2 * SortChunkSize)
+	{
+		std::stable_sort(aKeys.begin(), aKeys.end(), aLess);
+		return;
+	}
+
+	std::vector<ThreadPool::Task> tasks;
+	for (size_t begin = 0; begin < count; begin += SortChunkSize)
+	{
+		const auto first = aKeys.begin() + begin;
+		const auto last = aKeys.begin() + (std::min)(begin + SortChunkSize, count);
+		tasks.push_back(aThreadPool.queue([first, last, &aLess]() { std::stable_sort(first, last, aLess); }));
+	}
+	aThreadPool.complete(tasks.data(), tasks.size());
+
+	std::vector<ListElementSortKey> buffer(count);
+	for (size_t width = SortChunkSize; width < count; width *= 2)
+	{
+		tasks.clear();
+		for (size_t begin = 0; begin < count; begin += 2 * width)
+		{
+			const auto first = std::make_move_iterator(aKeys.begin() + begin);
+			const auto middle = std::make_move_iterator(aKeys.begin() + (std::min)(begin + width, count));
+			const auto last = std::make_move_iterator(aKeys.begin() + (std::min)(begin + 2 * width, count));
+			const auto out = buffer.begin() + begin;
+			tasks.push_back(aThreadPool.queue([first, middle, last, out, &aLess]() {
+				std::merge(first, middle, middle, last, out, aLess);
+			}));
+		}
+		aThreadPool.complete(tasks.data(), tasks.size());
+		aKeys.swap(buffer);
+	}
+}
+
+// sorts a "flat" (without hierarchy) list
+static void sortList(std::vector<ListElement> &aList, const ListElement_Less &aLess, ThreadPool &aThreadPool)
+{
+	std::vector<ListElementSortKey> keys(aList.size());
+	for (auto&& key : enumerate(keys))
+	{
+		const std::wstring &name = aList[key.index].Name[0];
+		key->name16 = sld::as_utf16(name);
+		key->name = name.c_str();
+		key->index = static_cast<UInt32>(key.index);
+	}
+
+	stableSort(keys, aLess, aThreadPool);
+
+	std::vector<ListElement> sorted;
+	sorted.reserve(aList.size());
+	for (const ListElementSortKey &key : keys)
+		sorted.push_back(std::move(aList[key.index]));
+	aList = std::move(sorted);
+}
+
 // Simple tree implementation
 namespace tree
 {
@@ -115,6 +210,7 @@ CWordList::CWordList(void)
 	m_isSound = false;
 	m_isLocalizedEntriesList = false;
 	m_isLinkedList = false;
+	m_isByteAlignedIndexes = false;
 	m_NumberOfArticlesSize = 0;
 	m_PictureIndexSize = 0;
 	m_VideoIndexSize = 0;
@@ -366,6 +462,18 @@ bool CWordList::GetLinkedList() const
 	return m_isLinkedList;
 }
 
+/// Устанавливает флаг того, что поля индексов переводов выравниваются по границе байта
+void CWordList::SetByteAlignedIndexes(bool aIsByteAligned)
+{
+	m_isByteAlignedIndexes = aIsByteAligned;
+}
+
+/// Возвращает флаг того, что поля индексов переводов выравниваются по границе байта
+bool CWordList::GetByteAlignedIndexes() const
+{
+	return m_isByteAlignedIndexes;
+}
+
 /// Возвращает флаг того, что на одно слово списка слов может приходится несколько переводов
 bool CWordList::GetIsNumberOfArticles() const
 {
@@ -414,9 +522,10 @@ static void buildListTree(tree::Tree<ListElement> &aTree, const vector<ListEleme
 /**
  * Производит сортировку списка слов (если возможно)
  *
- * @param[in]  aCompare - указатель на сортировщик строк, может быть nullptr
+ * @param[in]  aCompare    - указатель на сортировщик строк, может быть nullptr
+ * @param[in]  aThreadPool - thread pool используемый для сортировки
  */
-int CWordList::DoSort(const CStringCompare *aCompare)
+int CWordList::DoSort(const CStringCompare *aCompare, ThreadPool &aThreadPool)
 {
 	if (GetSorted() && aCompare)
 	{
@@ -438,30 +547,32 @@ int CWordList::DoSort(const CStringCompare *aCompare)
 		else
 		{
 			// В листах без иерархии просто сортируем список "в лоб"
-			stable_sort(m_List.begin(), m_List.end(), less);
+			sortList(m_List, less, aThreadPool);
 		}
 	}
 
 	UInt32 MaxArticlesCount = 0;
-	// Заполняем смещения до следующих элементов такой-же глубины вложенности
-	for (auto elem = m_List.begin(); elem != m_List.cend(); ++elem)
+	// Заполняем смещения до следующих элементов такой-же глубины вложенности.
+	// Проходим список с конца, запоминая для каждого уровня ближайший следующий элемент;
+	// элемент более высокого уровня "закрывает" все более глубокие уровни, т.к. за ним
+	// начинается другая ветвь каталога (в этом случае смещение равно 0).
+	std::vector<size_t> nextOnLevel;
+	for (size_t i = m_List.size(); i-- > 0;)
 	{
+		ListElement &elem = m_List[i];
+
 		UInt32 shiftToUnilevelElement = 0;
-		for (auto elem2 = std::next(elem); elem2 != m_List.cend(); ++elem2)
-		{
-			if (elem2->Level == elem->Level)
-			{
-				shiftToUnilevelElement = std::distance(elem, elem2);
-				break;
-			}
-			// Если мы поднялись на уровень выше, чем наш текущий - значит ставим 0,
-			// т.к. это означает, что мы пытаемся погрузится в другую ветвь каталога.
-			if (elem->Level > elem2->Level)
-				break;
-		}
-		elem->Shift2Next = shiftToUnilevelElement;
+		if (elem.Level < nextOnLevel.size() && nextOnLevel[elem.Level] != SIZE_MAX)
+			shiftToUnilevelElement = static_cast<UInt32>(nextOnLevel[elem.Level] - i);
+		elem.Shift2Next = shiftToUnilevelElement;
+
+		nextOnLevel.resize(elem.Level + 1, SIZE_MAX);
+		nextOnLevel[elem.Level] = i;
+	}
 
-		const UInt32 aRefSize = static_cast<UInt32>(elem->ArticleRefs.size());
+	for (const ListElement &elem : m_List)
+	{
+		const UInt32 aRefSize = static_cast<UInt32>(elem.ArticleRefs.size());
 		if (MaxArticlesCount < aRefSize)
 			MaxArticlesCount = aRefSize;
 	}
@@ -555,6 +666,58 @@ bool CWordList::IsOneArticleReferencedByManyListEntries() const
 	return false;
 }
 
+/**
+	Строит по готовой иерархии таблицу родителей ее уровней.
+
+	Уровни записаны в иерархию в порядке обхода в глубину, в том же порядке идут и их слова
+	в подготовленном списке, поэтому достаточно пройти иерархию подряд, запоминая для каждого
+	уровня элемент, который на него ссылается.
+
+	@param aHierarchy[in] - иерархия в бинарном виде
+	@param aWordCount[in] - количество слов в списке
+
+	@return таблица родителей уровней с терминальным элементом в конце.
+*/
+static std::vector<THierarchyLevelParent> BuildHierarchyParents(const std::vector<uint8_t> &aHierarchy, UInt32 aWordCount)
+{
+	std::vector<THierarchyLevelParent> levels;
+	// смещение уровня в иерархии -> номер родительского уровня и слова в нем
+	std::unordered_map<UInt32, std::pair<UInt32, UInt32>> parents;
+
+	UInt32 offset = 0;
+	while (offset < aHierarchy.size())
+	{
+		THierarchyLevelHeader header;
+		memcpy(&header, aHierarchy.data() + offset, sizeof(header));
+
+		THierarchyLevelParent level = { header.GlobalShift, LIST_END, LIST_END };
+		auto parent = parents.find(offset);
+		if (parent != parents.end())
+		{
+			level.ParentLevel = parent->second.first;
+			level.ParentWordIndex = parent->second.second;
+		}
+		assert(levels.empty() == (parent == parents.end()));
+		assert(levels.empty() || levels.back().LevelStart < level.LevelStart);
+
+		const UInt32 levelIndex = (UInt32)levels.size();
+		levels.push_back(level);
+		offset += sizeof(header);
+
+		for (UInt32 i = 0; i < header.NumberOfElements; i++)
+		{
+			THierarchyElement element;
+			memcpy(&element, aHierarchy.data() + offset, sizeof(element));
+			if (element.NextLevelGlobalIndex != LIST_END)
+				parents.emplace(element.ShiftToNextLevel, std::make_pair(levelIndex, element.BeginIndex - header.GlobalShift));
+			offset += sizeof(element);
+		}
+	}
+
+	levels.push_back({ aWordCount, LIST_END, LIST_END });
+	return levels;
+}
+
 /**
 	Производит подготовку списка слов к последующему сжатию.
 
@@ -578,6 +741,8 @@ int CWordList::PrepareHierarchy()
 
 	m_List = std::move(newList);
 
+	m_hierarchyParents = BuildHierarchyParents(m_hierarchy, (UInt32)m_List.size());
+
 	return ERROR_NO;
 }
 
@@ -889,6 +1054,12 @@ MemoryRef CWordList::GetHierarchyData() const
 	return sld::make_memref(m_hierarchy.data(), m_hierarchy.size());
 }
 
+/// Возвращает таблицу родителей уровней иерархии (см. #THierarchyLevelParent)
+MemoryRef CWordList::GetHierarchyParentsData() const
+{
+	return sld::make_memref(m_hierarchyParents.data(), m_hierarchyParents.size());
+}
+
 /** ********************************************************************
 * Возвращает размер ссылки на перевод(в битах).
 *
@@ -190,6 +190,7 @@ struct ListVariantProperty
 
 class CSortTablesManager;
 class CStringCompare;
+class ThreadPool;
 
 ///       
 class CWordList
@@ -259,8 +260,13 @@ public:
 	///   ,          
 	bool GetIsNumberOfArticles() const;
 
+	///   ,        
+	void SetByteAlignedIndexes(bool aIsByteAligned);
+	///   ,        
+	bool GetByteAlignedIndexes() const;
+
 	///      ( )
-	int DoSort(const CStringCompare *aCompare);
+	int DoSort(const CStringCompare *aCompare, ThreadPool &aThreadPool);
 
 	///   ,            
 	///   , ..       (  
@@ -336,6 +342,9 @@ public:
 	///     
 	MemoryRef GetHierarchyData() const;
 
+	///      (. #THierarchyLevelParent)
+	MemoryRef GetHierarchyParentsData() const;
+
 	///     ( ).
 	UInt32 GetAticleIndexSize() const;
 	///     ( ).
@@ -507,6 +516,9 @@ private:
 	///     (  )
 	std::vector<uint8_t> m_hierarchy;
 
+	///     
+	std::vector<THierarchyLevelParent> m_hierarchyParents;
+
 	//////////////////////////////////////////////////////////////////////////
 	//    -   /  
 	//////////////////////////////////////////////////////////////////////////
@@ -543,6 +555,12 @@ private:
 	///  ,      
 	bool m_isLinkedList;
 
+	///  ,        
+	/**
+		   ,     ,   .
+	*/
+	bool m_isByteAlignedIndexes;
+
 	///            .
 	UInt32 m_NumberOfArticlesSize;
 
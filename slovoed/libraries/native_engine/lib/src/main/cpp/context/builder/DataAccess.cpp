@@ -15,6 +15,7 @@
 #include <iomanip>
 #include <fstream>
 #include <unistd.h>
+#include <cstdlib>
 
 
 DataAccess::DataAccess( const CSldDictionary* pDictionary, const JavaObjects::string& _cacheDir )
@@ -224,6 +225,40 @@ JavaObjects::string DataAccess::createImageFile(const TImageElement * aImageElem
     return path;
 }
 
+JavaObjects::string DataAccess::createAssetFile(const std::string& aFileName, const std::string& aContent)
+{
+    JavaObjects::string path;
+    path = cacheDir;
+    std::string cache_s(path.begin(), path.end());
+
+    AppendStringHelper(path, "/");
+    AppendStringHelper(path, aFileName.data());
+
+    std::string path_s(path.begin(), path.end());
+    if (access(path_s.data(), F_OK) == 0)
+    {
+        // Keep the shared file from being evicted by clearCache() as the oldest one
+        utime(path_s.data(), nullptr );
+        return path;
+    }
+
+    // Write into a temporary file and rename it, so a concurrent article never references a partial file
+    std::string tmp_s = path_s + ".XXXXXX";
+    int pfd = mkstemp(&tmp_s[0]);
+    if (pfd == -1)
+        return JavaObjects::string();
+    clearCache(cache_s, aContent.size());
+    const bool written = write(pfd, aContent.data(), aContent.size()) == (ssize_t) aContent.size();
+    fchmod(pfd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    close(pfd);
+    if (!written || rename(tmp_s.data(), path_s.data()) != 0)
+    {
+        remove(tmp_s.data());
+        return JavaObjects::string();
+    }
+    return path;
+}
+
 SldU16StringRef DataAccess::StyleName( UInt32 aStyleId )
 {
   sld2::IntFormatter fmt;
@@ -46,6 +46,10 @@ class DataAccess : public CSldBasicHTMLBuilder::IDataAccess
     void setMyViewSettings( bool hidePhonetics, bool hideExamples, bool hideImages,
                             bool hideIdioms, bool hidePhrase );
 
+    // Writes aContent into aFileName in the cache dir unless it already exists there,
+    // returns the file path or an empty string on failure
+    JavaObjects::string createAssetFile( const std::string& aFileName, const std::string& aContent );
+
   private:
     SldU16String m_scratchString;
     std::unordered_map< UInt32, SldU16String > m_cssStyles;
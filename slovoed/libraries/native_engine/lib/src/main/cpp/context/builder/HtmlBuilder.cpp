@@ -2,6 +2,7 @@
 // Created by borbat on 01.10.2018.
 //
 
+#include <cstring>
 #include <sstream>
 #include <utility>
 #include "HtmlBuilder.h"
@@ -11,66 +12,129 @@ HtmlBuilder::HtmlBuilder( DataAccess* pData ) : CSldBasicHTMLBuilder( *pData )
   mData = pData;
   mScale = 1.0f;
   mHorizontalPadding = 0.0f;
+  mRemoveBodyMargin = false;
+  mSharedStaticAssets = false;
+  mEncoding = Encoding::Utf16;
   m_LangCode = SldLanguage::Unknown;
+  // Build the static assets with the first builder rather than during the first translation
+  GetStaticAssets();
 }
 
-static void AppendStringHelper( JavaObjects::string& buffer, const char* toAdd )
+// Widens toAdd into the end of the buffer with a single resize instead of per-char appends
+template <typename Char>
+static void AppendWidened( JavaObjects::string& buffer, const Char* toAdd, size_t len )
 {
-    while ( *toAdd )
-    {
-        buffer.append( 1u, (UInt16) (unsigned char) *toAdd );
-        toAdd++;
-    }
+    const size_t pos = buffer.size();
+    buffer.resize( pos + len );
+    UInt16* dst = &buffer[pos];
+    for ( size_t i = 0; i < len; i++ )
+        dst[i] = (UInt16) toAdd[i];
 }
 
-static void AppendWStringHelper( JavaObjects::string& buffer, const wchar_t* toAdd )
+// Encodes code unit values (UTF-16 or the widened chars) as UTF-8. Lone surrogates are
+// written as is, so the UTF-8 document always matches the UTF-16 one
+template <typename Char>
+static void AppendUtf8( std::string& buffer, const Char* toAdd, size_t len )
 {
-    while ( *toAdd )
+    for ( size_t i = 0; i < len; i++ )
     {
-        buffer.append( 1u, (UInt16)  *toAdd );
-        toAdd++;
-    }
-}
+        UInt32 c = toAdd[i];
+        if ( c < 0x80 )
+        {
+            // Runs of ASCII go with a single append
+            size_t run = i + 1;
+            while ( run < len && toAdd[run] < 0x80 )
+                run++;
+            const size_t pos = buffer.size();
+            buffer.resize( pos + run - i );
+            for ( char* dst = &buffer[pos]; i < run; i++ )
+                *dst++ = (char) toAdd[i];
+            i--;
+            continue;
+        }
+
+        if ( c >= 0xD800 && c < 0xDC00 && i + 1 < len && toAdd[i + 1] >= 0xDC00 && toAdd[i + 1] < 0xE000 )
+            c = 0x10000 + ( ( c - 0xD800 ) << 10 ) + ( toAdd[++i] - 0xDC00 );
 
-static void toHtmlEscaped(std::wstring &data) {
-    std::wstring buffer;
-    buffer.reserve(data.size());
-    for(size_t pos = 0; pos != data.size(); ++pos) {
-        switch(data[pos]) {
-            case '&':  buffer.append(L"&amp;");  break;
-            case '\"': buffer.append(L"&quot;"); break;
-            case '\'': buffer.append(L"&apos;"); break;
-            case '<':  buffer.append(L"&lt;");   break;
-            case '>':  buffer.append(L"&gt;");   break;
-            default:   buffer.append(&data[pos], 1); break;
+        if ( c < 0x800 )
+        {
+            buffer += (char) ( 0xC0 | ( c >> 6 ) );
+            buffer += (char) ( 0x80 | ( c & 0x3F ) );
+        }
+        else if ( c < 0x10000 )
+        {
+            buffer += (char) ( 0xE0 | ( c >> 12 ) );
+            buffer += (char) ( 0x80 | ( ( c >> 6 ) & 0x3F ) );
+            buffer += (char) ( 0x80 | ( c & 0x3F ) );
+        }
+        else
+        {
+            buffer += (char) ( 0xF0 | ( c >> 18 ) );
+            buffer += (char) ( 0x80 | ( ( c >> 12 ) & 0x3F ) );
+            buffer += (char) ( 0x80 | ( ( c >> 6 ) & 0x3F ) );
+            buffer += (char) ( 0x80 | ( c & 0x3F ) );
         }
     }
-    data.swap(buffer);
 }
 
+static void AppendStringHelper( JavaObjects::string& buffer, const char* toAdd )
+{
+    AppendWidened( buffer, (const unsigned char*) toAdd, strlen( toAdd ) );
+}
 
+static void AppendStringHelper( std::string& buffer, const char* toAdd )
+{
+    AppendUtf8( buffer, (const unsigned char*) toAdd, strlen( toAdd ) );
+}
 
-static void replaceAll(std::wstring& str, const std::wstring& from, const std::wstring& to) {
-    if(from.empty())
-        return;
-    size_t start_pos = 0;
-    while((start_pos = str.find(from, start_pos)) != std::string::npos) {
-        str.replace(start_pos, from.length(), to);
-        start_pos += to.length(); // In case 'to' contains 'from', like replacing 'x' with 'yx'
-    }
+static void AppendSldStringHelper( JavaObjects::string& buffer, const UInt16* toAdd, size_t len )
+{
+    buffer.append( toAdd, len );
 }
 
-static void U16toWchar(const UInt16 *from, wchar_t *to, UInt32 size)
+static void AppendSldStringHelper( std::string& buffer, const UInt16* toAdd, size_t len )
 {
-    for (int i = 0; i < size; ++i)
+    AppendUtf8( buffer, toAdd, len );
+}
+
+template <typename Buffer>
+static void AppendSldStringHelper( Buffer& buffer, SldU16StringRef toAdd )
+{
+    AppendSldStringHelper( buffer, toAdd.data(), toAdd.size() );
+}
+
+// Escapes the text (new lines become <br>) and encodes it into the buffer in one pass
+template <typename Buffer>
+static void AppendEscapedHelper( Buffer& buffer, SldU16StringRef text )
+{
+    const UInt16* run = text.data();
+    const UInt16* end = run + text.size();
+    for ( const UInt16* pos = run; pos != end; ++pos )
     {
-        to[i] = from[i];
+        const char* replacement;
+        switch ( *pos )
+        {
+            case '&':  replacement = "&amp;";  break;
+            case '\"': replacement = "&quot;"; break;
+            case '\'': replacement = "&apos;"; break;
+            case '<':  replacement = "&lt;";   break;
+            case '>':  replacement = "&gt;";   break;
+            case '\n': replacement = "<br>";   break;
+            default: continue;
+        }
+        AppendSldStringHelper( buffer, run, pos - run );
+        AppendStringHelper( buffer, replacement );
+        run = pos + 1;
     }
+    AppendSldStringHelper( buffer, run, end - run );
 }
 
 void HtmlBuilder::append( SldU16StringRef aString )
 {
-  mBodyBuffer.append( aString.data(), aString.size() );
+  if ( mEncoding == Encoding::Utf8 )
+    AppendSldStringHelper( mUtf8.body, aString );
+  else
+    AppendSldStringHelper( mUtf16.body, aString );
 }
 
 
@@ -83,7 +147,8 @@ std::string to_string(T value)
     return os.str() ;
 }
 
-void HtmlBuilder::addTextHelper(UInt32 aStyle, SldU16StringRef aText, bool phonetics)
+template <typename Char>
+void HtmlBuilder::addTextHelper(Document<Char>& doc, UInt32 aStyle, SldU16StringRef aText, bool phonetics)
 {
     const bool makeCrossRefs = !isInLink() && !isInsideMetaBlock(eMetaHideControl) &&
                                !isInsideMetaBlock(eMetaSwitchControl) &&
@@ -92,73 +157,79 @@ void HtmlBuilder::addTextHelper(UInt32 aStyle, SldU16StringRef aText, bool phone
 
     const bool preNeeded = isInsideMetaBlock(eMetaNoBrText) || isInsideMetaBlock(eMetaPhonetics) || phonetics;
 
-    AppendStringHelper(mBodyBuffer,"<span");
+    AppendStringHelper(doc.body,"<span");
 
     if (makeCrossRefs)
     {
-        AppendStringHelper(mBodyBuffer," sld-ref");
+        AppendStringHelper(doc.body," sld-ref");
     }
-    AppendStringHelper(mBodyBuffer," lang=\"");
+    AppendStringHelper(doc.body," lang=\"");
 
     char temp[5] = {};
     memcpy(&temp[0],&m_LangCode,4u);
-    AppendStringHelper(mBodyBuffer,temp);
-    AppendStringHelper(mBodyBuffer,"\"");
-    AppendStringHelper(mBodyBuffer," class='S");
-    AppendStringHelper(mBodyBuffer,to_string(aStyle).c_str());
-    AppendStringHelper(mBodyBuffer,"'");
+    AppendStringHelper(doc.body,temp);
+    AppendStringHelper(doc.body,"\"");
+    AppendStringHelper(doc.body," class='S");
+    AppendStringHelper(doc.body,to_string(aStyle).c_str());
+    AppendStringHelper(doc.body,"'");
     if (preNeeded)
-        AppendStringHelper(mBodyBuffer," style='white-space:pre !important'");
-    AppendStringHelper(mBodyBuffer,">");
+        AppendStringHelper(doc.body," style='white-space:pre !important'");
+    AppendStringHelper(doc.body,">");
 
-    wchar_t wBuffer[aText.size()];
-    U16toWchar(aText.data(), wBuffer, aText.size());
+    AppendEscapedHelper(doc.body,aText);
+    AppendStringHelper(doc.body,"</span>");
+}
 
-    std::wstring buffer(wBuffer,aText.size());
-    toHtmlEscaped(buffer);
+void HtmlBuilder::addText(UInt32 aStyle, SldU16StringRef aText)
+{
+    if (aText.empty())
+        return;
 
-    replaceAll(buffer,std::wstring(L"\n"),std::wstring(L"<br>"));
-    AppendWStringHelper(mBodyBuffer,buffer.data());
-    AppendStringHelper(mBodyBuffer,"</span>");
+    if (mEncoding == Encoding::Utf8)
+        addTextHelper(mUtf8, aStyle, aText, false);
+    else
+        addTextHelper(mUtf16, aStyle, aText, false);
 }
 
-void HtmlBuilder::addText(UInt32 aStyle, SldU16StringRef aText)
+template <typename Char>
+void HtmlBuilder::addPhoneticsHelper(Document<Char>& doc, UInt32 aStyle, SldU16StringRef aText)
 {
-    if (!aText.empty())
-        addTextHelper(aStyle, aText, false);
+    AppendStringHelper(doc.body, "<wbr/>");
+    addTextHelper(doc, aStyle, aText, true);
+    AppendStringHelper(doc.body, "<wbr/>");
 }
 
 void HtmlBuilder::addPhonetics(UInt32 aStyle, SldU16StringRef aText)
 {
-    if (!aText.empty())
-    {
-        AppendStringHelper(mBodyBuffer, "<wbr/>");
-        addTextHelper(aStyle, aText, true);
-        AppendStringHelper(mBodyBuffer, "<wbr/>");
-    }
+    if (aText.empty())
+        return;
+
+    if (mEncoding == Encoding::Utf8)
+        addPhoneticsHelper(mUtf8, aStyle, aText);
+    else
+        addPhoneticsHelper(mUtf16, aStyle, aText);
 }
 
 void HtmlBuilder::StartBuilding()
 {
   Clear();
   mData->clear();
-  mBodyBuffer.clear();
+  mUtf16.body.clear();
+  mUtf8.body.clear();
 }
 
-static void AddStringHelper( JavaObjects::string& buffer, const char* toAdd )
+template <typename Buffer>
+static void AddStringHelper( Buffer& buffer, const char* toAdd )
 {
-  while ( *toAdd )
-  {
-    buffer.append( 1u, (UInt16) (unsigned char) *toAdd );
-    toAdd++;
-  }
-  buffer.append( 1u, (UInt16) (unsigned char) '\n' );
+  AppendStringHelper( buffer, toAdd );
+  buffer.push_back( '\n' );
 }
 
-static void AddSldStringHelper( JavaObjects::string& buffer, SldU16StringRef toAdd )
+template <typename Buffer>
+static void AddSldStringHelper( Buffer& buffer, SldU16StringRef toAdd )
 {
-  buffer.append( toAdd.data(), toAdd.size() );
-  buffer.append( 1u, (UInt16) (unsigned char) '\n' );
+  AppendSldStringHelper( buffer, toAdd );
+  buffer.push_back( '\n' );
 }
 
 const char* GetSoundAnimStyle() {
@@ -324,58 +395,138 @@ const char* GetPractisePronunciationButtonsScript()
            "}\n";
 }
 
+// Content-hashed file name, so an asset changed by an app update never collides with a stale copy
+static std::string AssetFileName( const std::string& content, const char* extension )
+{
+  UInt64 hash = 14695981039346656037ull;
+  for ( unsigned char c : content )
+  {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  std::ostringstream os;
+  os << "ASSET-" << std::hex << hash << extension;
+  return os.str();
+}
+
+const HtmlBuilder::StaticAssets& HtmlBuilder::GetStaticAssets()
+{
+  static const StaticAssets assets = []()
+  {
+    StaticAssets result;
+    AssetsText<UInt16>& text = result.utf16;
+    AddStringHelper( text.style, GetSoundAnimStyle() );
+
+    AddStringHelper( text.script, GetPractisePronunciationButtonsScript() );
+    AddStringHelper( text.script, mScript );
+    AddStringHelper( text.script, GetSoundAnimScript());
+    AddSldStringHelper( text.script, GetCrossRefInitScript() );
+    AddSldStringHelper( text.script, GetSearchHighlightScript() );
+    AddSldStringHelper( text.script, GetSwitchUncoverScript() );
+    AddSldStringHelper( text.script, GetHideControlScript() );
+    AddSldStringHelper( text.script, GetSwitchControlScript() );
+    AddSldStringHelper( text.script, GetCrossRefScript() );
+    AddStringHelper( text.script, GetInitScript() );
+
+    AppendSldStringHelper( result.utf8.style, text.style.data(), text.style.size() );
+    result.styleFileName = AssetFileName( result.utf8.style, ".css" );
+    AppendSldStringHelper( result.utf8.script, text.script.data(), text.script.size() );
+    result.scriptFileName = AssetFileName( result.utf8.script, ".js" );
+    return result;
+  }();
+  return assets;
+}
+
 void HtmlBuilder::EndBuilding()
 {
-  mHtmlBuffer.clear();
-  AddStringHelper( mHtmlBuffer, "<HTML>" );
-  AddStringHelper( mHtmlBuffer, "<HEAD>" );
-  AddStringHelper( mHtmlBuffer, "<meta http-equiv='Content-Type' content='text/html; charset=UTF-8'>" );
+  if ( mEncoding == Encoding::Utf8 )
+    endBuilding( mUtf8 );
+  else
+    endBuilding( mUtf16 );
+}
+
+template <typename Char>
+void HtmlBuilder::endBuilding( Document<Char>& doc )
+{
+  const StaticAssets& assets = GetStaticAssets();
+
+  JavaObjects::string stylePath, scriptPath;
+  if ( mSharedStaticAssets )
+  {
+    stylePath = mData->createAssetFile( assets.styleFileName, assets.utf8.style );
+    scriptPath = mData->createAssetFile( assets.scriptFileName, assets.utf8.script );
+  }
+  // Fall back to inline assets if the files could not be written
+  const bool sharedAssets = !stylePath.empty() && !scriptPath.empty();
+
+  const AssetsText<Char>& text = assets.in( doc );
+  typename Document<Char>::string& html = doc.html;
+  html.clear();
+  html.reserve( doc.body.size() + doc.fontFaces.size() + ( sharedAssets ? 0 : text.script.size() ) + 4096 );
+  AddStringHelper( html, "<HTML>" );
+  AddStringHelper( html, "<HEAD>" );
+  AddStringHelper( html, "<meta http-equiv='Content-Type' content='text/html; charset=UTF-8'>" );
   // Viewport 'width' parameter actually works like minimum supported width of page content layout.
   // If current WebView width is bigger when viewport width then the page content width would be stretched.
   // Setting small viewport width (like 1px) works well for article pages.
   std::string data = "<meta name='viewport' content='width=1, initial-scale=" + to_string(mScale) + ", maximum-scale=10.0, minimum-scale=0.1'>";
-  AddStringHelper( mHtmlBuffer, data.c_str() );
-  AddStringHelper( mHtmlBuffer, "<style type=\"text/css\" media=\"screen\">" );
-  AddStringHelper( mHtmlBuffer, "a { text-decoration: none; }" );
+  AddStringHelper( html, data.c_str() );
+  AddStringHelper( html, "<style type=\"text/css\" media=\"screen\">" );
+  AddStringHelper( html, "a { text-decoration: none; }" );
   for ( UInt32 id : mData->usedStyles )
   {
-    AddSldStringHelper( mHtmlBuffer, mData->GetStyleString( id ) );
+    AddSldStringHelper( html, mData->GetStyleString( id ) );
   }
   for ( UInt32 id : m_state.usedStyles )
   {
-    AddSldStringHelper( mHtmlBuffer, mData->GetStyleString( id ) );
+    AddSldStringHelper( html, mData->GetStyleString( id ) );
   }
   for ( UInt32 id: m_state.usedCSSStyles )
   {
-    AddSldStringHelper( mHtmlBuffer, mData->GetCSSStyleString( id ) );
+    AddSldStringHelper( html, mData->GetCSSStyleString( id ) );
+  }
+  html.append( doc.fontFaces );
+  if ( sharedAssets )
+  {
+    AddStringHelper( html, "</style>" );
+    AppendStringHelper( html, "<link rel=\"stylesheet\" type=\"text/css\" media=\"screen\" href=\"file://" );
+    AppendSldStringHelper( html, stylePath.data(), stylePath.size() );
+    AddStringHelper( html, "\">" );
+    AddStringHelper( html, "</HEAD>" );
+    AppendStringHelper( html, "<script type=\"text/javascript\" src=\"file://" );
+    AppendSldStringHelper( html, scriptPath.data(), scriptPath.size() );
+    AddStringHelper( html, "\"></script>" );
+  }
+  else
+  {
+    html.append( text.style );
+    AddStringHelper( html, "</style>" );
+    AddStringHelper( html, "</HEAD>" );
+    AddStringHelper( html, "<script type=\"text/javascript\">\n" );
+    html.append( text.script );
+    AddStringHelper( html, "</script>" );
   }
-  mHtmlBuffer.append(mFontFacesBuffer);
-  AddStringHelper( mHtmlBuffer, GetSoundAnimStyle() );
-  AddStringHelper( mHtmlBuffer, "</style>" );
-  AddStringHelper( mHtmlBuffer, "</HEAD>" );
-  AddStringHelper( mHtmlBuffer, "<script type=\"text/javascript\">\n" );
-  AddStringHelper( mHtmlBuffer, GetPractisePronunciationButtonsScript() );
-  AddStringHelper( mHtmlBuffer, mScript );
-  AddStringHelper( mHtmlBuffer, GetSoundAnimScript());
-  AddSldStringHelper( mHtmlBuffer, GetCrossRefInitScript() );
-  AddSldStringHelper( mHtmlBuffer, GetSearchHighlightScript() );
-  AddSldStringHelper( mHtmlBuffer, GetSwitchUncoverScript() );
-  AddSldStringHelper( mHtmlBuffer, GetHideControlScript() );
-  AddSldStringHelper( mHtmlBuffer, GetSwitchControlScript() );
-  AddSldStringHelper( mHtmlBuffer, GetCrossRefScript() );
-    AddStringHelper( mHtmlBuffer, GetInitScript() );
-  AddStringHelper( mHtmlBuffer, "</script>" );
   data = "<BODY  onload=\"Init(event);\" style= \"" + (mRemoveBodyMargin ? "margin:0;"  : ("padding-left:" + to_string(mHorizontalPadding) + "px; padding-right:" + to_string(mHorizontalPadding) + "px;")) + "\">";
-  AddStringHelper( mHtmlBuffer, data.c_str());
-  mHtmlBuffer.append( mBodyBuffer );
-  AddStringHelper( mHtmlBuffer, "" );
-  AddStringHelper( mHtmlBuffer, "</BODY>" );
-  AddStringHelper( mHtmlBuffer, "</HTML>" );
+  AddStringHelper( html, data.c_str());
+  html.append( doc.body );
+  AddStringHelper( html, "" );
+  AddStringHelper( html, "</BODY>" );
+  AddStringHelper( html, "</HTML>" );
 }
 
 const UInt16* HtmlBuilder::GetHtml()
 {
-  return mHtmlBuffer.c_str();
+  return mUtf16.html.c_str();
+}
+
+const std::string& HtmlBuilder::GetHtmlUtf8()
+{
+  return mUtf8.html;
+}
+
+void HtmlBuilder::setOutputEncoding( Encoding encoding )
+{
+  mEncoding = encoding;
 }
 
 CSldCSSUrlResolver* HtmlBuilder::GetUrlResolver()
@@ -409,6 +560,11 @@ void HtmlBuilder::setRemoveBodyMargin(bool removeBodyMargin)
     mRemoveBodyMargin = removeBodyMargin;
 }
 
+void HtmlBuilder::setSharedStaticAssets( bool sharedStaticAssets )
+{
+    mSharedStaticAssets = sharedStaticAssets;
+}
+
 void HtmlBuilder::initFontFaces( JNIEnv* env )
 {
   jobjectArray fonts = JavaFontUtils::GetAvailableFonts( env );
@@ -420,27 +576,29 @@ void HtmlBuilder::initFontFaces( JNIEnv* env )
     bool isBold = JavaFontUtils::IsBold(env, font);
     bool isSemiBold = JavaFontUtils::IsSemiBold(env, font);
     bool isItalic = JavaFontUtils::IsItalic(env, font);
-    AppendStringHelper(mFontFacesBuffer, "@font-face {\tfont-family: '");
-    AppendStringHelper(mFontFacesBuffer, family);
-    AppendStringHelper(mFontFacesBuffer, "';\tsrc: url('file:///android_asset/");
-    AppendStringHelper(mFontFacesBuffer, filePath);
-    AppendStringHelper(mFontFacesBuffer, "')");
+    AppendStringHelper(mUtf16.fontFaces, "@font-face {\tfont-family: '");
+    AppendStringHelper(mUtf16.fontFaces, family);
+    AppendStringHelper(mUtf16.fontFaces, "';\tsrc: url('file:///android_asset/");
+    AppendStringHelper(mUtf16.fontFaces, filePath);
+    AppendStringHelper(mUtf16.fontFaces, "')");
     if ( isSemiBold || isBold) {
-      AppendStringHelper( mFontFacesBuffer, ";\tfont-weight: " );
+      AppendStringHelper( mUtf16.fontFaces, ";\tfont-weight: " );
       if ( isSemiBold ) {
-        AppendStringHelper( mFontFacesBuffer, "600" );
+        AppendStringHelper( mUtf16.fontFaces, "600" );
       }
       else {
-        AppendStringHelper( mFontFacesBuffer, "bold" );
+        AppendStringHelper( mUtf16.fontFaces, "bold" );
       }
     }
     if (isItalic) {
-      AppendStringHelper(mFontFacesBuffer, ";\tfont-style: ");
-      AppendStringHelper(mFontFacesBuffer, "italic");
+      AppendStringHelper(mUtf16.fontFaces, ";\tfont-style: ");
+      AppendStringHelper(mUtf16.fontFaces, "italic");
     }
-    AppendStringHelper(mFontFacesBuffer, ";\tfont-variant: normal");
-    AddStringHelper(mFontFacesBuffer, "}");
+    AppendStringHelper(mUtf16.fontFaces, ";\tfont-variant: normal");
+    AddStringHelper(mUtf16.fontFaces, "}");
   }
+  mUtf8.fontFaces.clear();
+  AppendSldStringHelper(mUtf8.fontFaces, mUtf16.fontFaces.data(), mUtf16.fontFaces.size());
 }
 
 void HtmlBuilder::setVisibilitySentencesSoundButton(JNIEnv *env, jobject _htmlParams) {
@@ -453,19 +611,28 @@ void HtmlBuilder::setVisibilitySentencesSoundButton(JNIEnv *env, jobject _htmlPa
     }
 }
 void HtmlBuilder::BuildSound(SldU16StringRef aLang, SldU16StringRef aExtKey, SldU16StringRef aDictId, std::string soundId, bool isClosing)
+{
+  if ( mEncoding == Encoding::Utf8 )
+    buildSound( mUtf8, aLang, aExtKey, aDictId, soundId, isClosing );
+  else
+    buildSound( mUtf16, aLang, aExtKey, aDictId, soundId, isClosing );
+}
+
+template <typename Char>
+void HtmlBuilder::buildSound(Document<Char>& doc, SldU16StringRef aLang, SldU16StringRef aExtKey, SldU16StringRef aDictId, const std::string& soundId, bool isClosing)
 {
   if ( isClosing )
   {
-    std::map<JavaObjects::string, JavaObjects::string>::iterator it = m_SoundBlockLangToBaseImgMap.find(m_CurSoundBlockLang);
-    JavaObjects::string imgBlockBuffer = mBodyBuffer.substr(m_SoundBlockStartPos);
+    auto it = doc.soundBlockImgs.find(m_CurSoundBlockLang);
+    typename Document<Char>::string imgBlockBuffer = doc.body.substr(m_SoundBlockStartPos);
     JavaObjects::string lang;
     if ( imgBlockBuffer.empty() )
     {
-      if ( it != m_SoundBlockLangToBaseImgMap.end() && !it->second.empty() )
+      if ( it != doc.soundBlockImgs.end() && !it->second.empty() )
       {
 
           if (std::find(mHiddenSoundIcons.begin(), mHiddenSoundIcons.end(), it->first) == mHiddenSoundIcons.end()) {
-              mBodyBuffer.append(it->second);
+              doc.body.append(it->second);
           } else {
               AppendStringHelper(lang, "enUK");
               mIsPreviousIconHide = it->first == lang;
@@ -473,54 +640,54 @@ void HtmlBuilder::BuildSound(SldU16StringRef aLang, SldU16StringRef aExtKey, Sld
       }
       else
       {
-        mBodyBuffer.append( createSoundExtImgTag() );
+        appendSoundExtImgTag( doc.body );
       }
     }
     else
     {
-      if ( it == m_SoundBlockLangToBaseImgMap.end() || it->second.empty() )
+      if ( it == doc.soundBlockImgs.end() || it->second.empty() )
       {
-        m_SoundBlockLangToBaseImgMap[m_CurSoundBlockLang] = imgBlockBuffer;
+        doc.soundBlockImgs[m_CurSoundBlockLang] = imgBlockBuffer;
       }
     }
-    AppendStringHelper( mBodyBuffer, "</a>" );
+    AppendStringHelper( doc.body, "</a>" );
     m_SoundBlockStartPos = 0;
     m_CurSoundBlockLang.clear();
   }
   else
   {
-    AppendStringHelper( mBodyBuffer, "<a href=\"sld-sound:" );
+    AppendStringHelper( doc.body, "<a href=\"sld-sound:" );
 
     if(!aExtKey.empty()) {
-        mBodyBuffer.append(aExtKey.data(), aExtKey.size());
+        AppendSldStringHelper(doc.body, aExtKey);
     } else{
-        AppendStringHelper( mBodyBuffer, " ");
+        AppendStringHelper( doc.body, " ");
     }
 
-    AppendStringHelper( mBodyBuffer, ":");
+    AppendStringHelper( doc.body, ":");
     if(!aDictId.empty()) {
-        mBodyBuffer.append(aDictId.data(), aDictId.size());
+        AppendSldStringHelper(doc.body, aDictId);
     } else {
-        AppendStringHelper(mBodyBuffer, "0000");
+        AppendStringHelper(doc.body, "0000");
     }
 
-    AppendStringHelper( mBodyBuffer, ":");
-    AppendStringHelper(mBodyBuffer, soundId.data());
+    AppendStringHelper( doc.body, ":");
+    AppendStringHelper(doc.body, soundId.data());
 
-    AppendStringHelper( mBodyBuffer, ":");
+    AppendStringHelper( doc.body, ":");
     if(!aLang.empty()) {
-      mBodyBuffer.append(aLang.data(), aLang.size());
+      AppendSldStringHelper(doc.body, aLang);
     } else {
-      AppendStringHelper(mBodyBuffer, "0");
+      AppendStringHelper(doc.body, "0");
     }
 
       if (mIsPreviousIconHide) {
-          AppendStringHelper(mBodyBuffer, "\" style= \"position: relative;left: -8px;\"");
+          AppendStringHelper(doc.body, "\" style= \"position: relative;left: -8px;\"");
           mIsPreviousIconHide = false;
       }
-    AppendStringHelper( mBodyBuffer, "\">");
+    AppendStringHelper( doc.body, "\">");
     m_CurSoundBlockLang.assign( aLang.data(), aLang.size() );
-    m_SoundBlockStartPos = mBodyBuffer.size();
+    m_SoundBlockStartPos = doc.body.size();
   }
 }
 
@@ -529,17 +696,19 @@ void HtmlBuilder::addBlock(const CSldMetadataProxy<eMetaUiElement> &aUiElem)
     if (aUiElem.isClosing())
         return;
 
-    AddStringHelper( mBodyBuffer, "<uielementmarker></uielementmarker>");
+    if (mEncoding == Encoding::Utf8)
+        AddStringHelper( mUtf8.body, "<uielementmarker></uielementmarker>");
+    else
+        AddStringHelper( mUtf16.body, "<uielementmarker></uielementmarker>");
 }
 
-JavaObjects::string HtmlBuilder::createSoundExtImgTag()
+template <typename Char>
+void HtmlBuilder::appendSoundExtImgTag(std::basic_string<Char>& buffer)
 {
-  JavaObjects::string imgBlockBuffer;
   // TODO Create img tag using img from app resources
   // For now only stub implementation
-  AppendStringHelper( imgBlockBuffer, "SOUND " );
-  imgBlockBuffer.append( m_CurSoundBlockLang );
-  return imgBlockBuffer;
+  AppendStringHelper( buffer, "SOUND " );
+  AppendSldStringHelper( buffer, m_CurSoundBlockLang.data(), m_CurSoundBlockLang.size() );
 }
 
 const char* HtmlBuilder::mScript =
@@ -7,6 +7,7 @@
 
 #include <java/java_objects.h>
 #include <map>
+#include <string>
 #include "SldHTMLBuilder.h"
 #include "DataAccess.h"
 #include "vector"
@@ -14,14 +15,29 @@
 class HtmlBuilder : public CSldBasicHTMLBuilder
 {
   public:
+    // Encoding of the built document. Both encodings produce the same document,
+    // the UTF-8 one is written directly instead of being converted from UTF-16
+    enum class Encoding
+    {
+      Utf16,
+      Utf8
+    };
+
     HtmlBuilder( DataAccess* pData );
 
     void StartBuilding();
 
     void EndBuilding();
 
+    // Document built in Encoding::Utf16
     const UInt16* GetHtml();
 
+    // Document built in Encoding::Utf8
+    const std::string& GetHtmlUtf8();
+
+    // Must be set before StartBuilding()
+    void setOutputEncoding( Encoding encoding );
+
     CSldCSSUrlResolver* GetUrlResolver();
 
     void setScale( jfloat scale );
@@ -33,6 +49,10 @@ class HtmlBuilder : public CSldBasicHTMLBuilder
 
     void setRemoveBodyMargin( bool removeBodyMargin );
 
+    // Emit the static scripts and CSS as shared files in the cache dir referenced from
+    // the article instead of inlining them into every article
+    void setSharedStaticAssets( bool sharedStaticAssets );
+
     void initFontFaces( JNIEnv* env );
 
     void setVisibilitySentencesSoundButton(JNIEnv* env, jobject _htmlParams );
@@ -48,26 +68,66 @@ protected:
     virtual void addBlock(const CSldMetadataProxy<eMetaUiElement> &aUiElem) override;
 
 private:
+    // Buffers of the document in one of the output encodings
+    template <typename Char>
+    struct Document
+    {
+        typedef std::basic_string<Char> string;
+
+        string html, body, fontFaces;
+        std::map<JavaObjects::string, string> soundBlockImgs;
+    };
+
+    template <typename Char>
+    struct AssetsText
+    {
+        std::basic_string<Char> style, script;
+    };
+
+    // Static scripts and CSS of every article, encoded once per process
+    struct StaticAssets
+    {
+        AssetsText<UInt16> utf16;
+        AssetsText<char> utf8;
+        // Content-hashed names of the shared asset files
+        std::string styleFileName, scriptFileName;
+
+        const AssetsText<UInt16>& in( const Document<UInt16>& ) const { return utf16; }
+        const AssetsText<char>& in( const Document<char>& ) const { return utf8; }
+    };
+
+    static const StaticAssets& GetStaticAssets();
+
     static const char* mScript;
-    JavaObjects::string mHtmlBuffer, mBodyBuffer, mFontFacesBuffer;
+    Document<UInt16> mUtf16;
+    Document<char> mUtf8;
+    Encoding mEncoding;
     DataAccess* mData;
     jfloat mScale;
     jfloat mHorizontalPadding;
     bool mRemoveBodyMargin;
+    bool mSharedStaticAssets;
     ESldLanguage			m_LangCode;
 
     JavaObjects::string m_CurSoundBlockLang;
     std::vector<JavaObjects::string> mHiddenSoundIcons;
     bool mIsPreviousIconHide = false;
     size_t m_SoundBlockStartPos;
-    std::map<JavaObjects::string, JavaObjects::string> m_SoundBlockLangToBaseImgMap;
 
     bool isInLink() const { return isInsideMetaBlock(eMetaLink) ||
                                    isInsideMetaBlock(eMetaUrl) ||
                                    isInsideMetaBlock(eMetaPopupArticle); }
-    void addTextHelper(UInt32, SldU16StringRef, bool);
-
-    JavaObjects::string createSoundExtImgTag();
+    template <typename Char>
+    void addTextHelper(Document<Char>&, UInt32, SldU16StringRef, bool);
+    template <typename Char>
+    void addPhoneticsHelper(Document<Char>&, UInt32, SldU16StringRef);
+    template <typename Char>
+    void endBuilding(Document<Char>&);
+    template <typename Char>
+    void buildSound(Document<Char>&, SldU16StringRef, SldU16StringRef, SldU16StringRef, const std::string&, bool);
+
+    template <typename Char>
+    void appendSoundExtImgTag(std::basic_string<Char>&);
 };
 
 #endif //NATIVE_ENGINE_HTMLBUILDER_H
@@ -58,6 +58,7 @@ void LayerAccess::InitTranslation( CSldDictionary* dictionary, JNIEnv* env, jobj
                                 JavaHtmlBuilderParams::IsHidePhrase( env, _htmlParams ));
   m_pBuilder->setHorizontalPadding(JavaHtmlBuilderParams::GetHorizontalPadding( env, _htmlParams ));
   m_pBuilder->setRemoveBodyMargin(JavaHtmlBuilderParams::IsRemoveBodyMargin( env, _htmlParams ));
+  m_pBuilder->setSharedStaticAssets(JavaHtmlBuilderParams::IsSharedStaticAssets( env, _htmlParams ));
 }
 
 const UInt16* LayerAccess::GetTranslationHtml()
@@ -41,6 +41,11 @@ LayerAccess* CDictionaryContext::GetLayerAccess()
   return mpLayerAccess;
 }
 
+CSldWordReferenceCache* CDictionaryContext::GetWordReferenceCache()
+{
+  return &mWordReferenceCache;
+}
+
 bool CDictionaryContext::IsInternalMorphoAvailable( UInt32 language, CDictionaryContext::MorphoUsage usage )
 {
     ESldError error;
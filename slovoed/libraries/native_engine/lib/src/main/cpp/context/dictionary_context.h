@@ -4,6 +4,7 @@
 #include <vector>
 #include "context/builder/LayerAccess.h"
 #include "SldDictionary.h"
+#include "SldDictionaryHelper.h"
 #include "env_aware.h"
 #include "morpho_context.h"
 
@@ -14,6 +15,7 @@ class CDictionaryContext : public IEnvAware
     EnvAwareSdcReader* mpSDCFile;
     LayerAccess* mpLayerAccess;
     std::vector<MorphoContext*> mpMorphoContextList;
+    CSldWordReferenceCache mWordReferenceCache;
 
   public:
     enum MorphoUsage
@@ -29,6 +31,9 @@ class CDictionaryContext : public IEnvAware
 
     LayerAccess* GetLayerAccess();
 
+    // Word references resolved by previous GetWordReference* calls on this dictionary
+    CSldWordReferenceCache* GetWordReferenceCache();
+
     bool IsInternalMorphoAvailable( UInt32 language, MorphoUsage usage );
 
     MorphoData* GetExternalMorpho( UInt32 language, MorphoUsage usage );
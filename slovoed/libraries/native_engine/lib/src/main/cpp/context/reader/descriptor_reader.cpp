@@ -1,5 +1,6 @@
 #include "descriptor_reader.h"
 
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
 
@@ -31,3 +32,8 @@ UInt32 DescriptorReader::GetSize() const
   }
   return static_cast<UInt32>(res);
 }
+
+void DescriptorReader::Prefetch( UInt32 aOffset, UInt32 aSize )
+{
+  ::posix_fadvise( m_fd, off_t( m_offset ) + off_t( aOffset ), off_t( aSize ), POSIX_FADV_WILLNEED );
+}
@@ -22,6 +22,8 @@ class DescriptorReader final : public EnvAwareSdcReader
     UInt32 Read( void* aDestPtr, UInt32 aSize, UInt32 aOffset ) override;
 
     UInt32 GetSize() const override;
+
+    void Prefetch( UInt32 aOffset, UInt32 aSize ) override;
 };
 
 #endif //SEARCH_ALL_DICTIONARY_DESCRIPTOR_READER_H
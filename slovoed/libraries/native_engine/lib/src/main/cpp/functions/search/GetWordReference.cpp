@@ -14,6 +14,7 @@ jobject GetWordReference::native(
 ) const noexcept {
     CSldDictionary* dictionary = context->GetDictionary();
     CSldDictionaryHelper helper = CSldDictionaryHelper(*dictionary);
+    helper.SetWordReferenceCache(context->GetWordReferenceCache());
     jint listIndex = JavaObjects::GetInteger( env, _listIndex );
     JavaObjects::string phrase = JavaObjects::GetString(env, _phrase);
     ESldLanguage languageFrom = dictionary->GetListLanguageFrom( listIndex );
@@ -30,6 +30,7 @@ jobject GetWordReferenceInList::native(
 
   CSldDictionary* dictionary = context->GetDictionary();
   CSldDictionaryHelper helper = CSldDictionaryHelper( *dictionary );
+  helper.SetWordReferenceCache( context->GetWordReferenceCache() );
   ESldLanguage languageFrom = dictionary->GetListLanguageFrom( listIndex );
   bool isInternalMorphoAvailable = context->IsInternalMorphoAvailable( languageFrom, CDictionaryContext::eFts );
   CSldVector< TWordRefInfo > wordRefs;
@@ -306,6 +306,7 @@ static jmethodID m_jIsHideIdioms = nullptr;
 static jmethodID m_jIsHidePhrase = nullptr;
 static jmethodID m_jHiddenSoundIcons = nullptr;
 static jmethodID m_hRemoveBodyMargin = nullptr;
+static jmethodID m_jIsSharedStaticAssets = nullptr;
 
 void Init( JNIEnv* env )
 {
@@ -322,6 +323,7 @@ void Init( JNIEnv* env )
     m_jIsHidePhrase = env->GetMethodID( m_jHtmlBuilderParamsClass, "isHidePhrase", "()Z" );
     m_jHiddenSoundIcons = env->GetMethodID( m_jHtmlBuilderParamsClass, "getHiddenSoundIcons", "()[Ljava/lang/String;" );
     m_hRemoveBodyMargin = env->GetMethodID(m_jHtmlBuilderParamsClass, "isRemoveBodyMargin",  "()Z");
+    m_jIsSharedStaticAssets = env->GetMethodID( m_jHtmlBuilderParamsClass, "isSharedStaticAssets", "()Z" );
   }
 }
 
@@ -375,6 +377,11 @@ bool IsRemoveBodyMargin( JNIEnv* env, jobject jHtmlParams )
   return env->CallBooleanMethod( jHtmlParams, m_hRemoveBodyMargin );
 }
 
+bool IsSharedStaticAssets( JNIEnv* env, jobject jHtmlParams )
+{
+  return env->CallBooleanMethod( jHtmlParams, m_jIsSharedStaticAssets );
+}
+
 }
 
 
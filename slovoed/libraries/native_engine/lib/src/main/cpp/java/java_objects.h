@@ -99,6 +99,8 @@ bool IsHidePhrase( JNIEnv* env, jobject jHtmlParams );
 jobjectArray HiddenSoundIcons ( JNIEnv* env, jobject jHtmlParams);
 
 bool IsRemoveBodyMargin( JNIEnv* env, jobject jHtmlParams );
+
+bool IsSharedStaticAssets( JNIEnv* env, jobject jHtmlParams );
 };
 
 
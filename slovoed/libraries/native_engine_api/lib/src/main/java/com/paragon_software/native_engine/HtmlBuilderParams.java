@@ -12,6 +12,7 @@ public class HtmlBuilderParams
   private boolean hidePhrase;
   private String[] hiddenSoundIcons;
   private boolean removeBodyMargin;
+  private boolean sharedStaticAssets;
 
   private HtmlBuilderParams( Builder builder )
   {
@@ -24,6 +25,7 @@ public class HtmlBuilderParams
     hidePhrase = builder.hidePhrase;
     hiddenSoundIcons = builder.hiddenSoundIcons;
     removeBodyMargin = builder.removeBodyMargin;
+    sharedStaticAssets = builder.sharedStaticAssets;
   }
 
   public float getScale()
@@ -71,6 +73,11 @@ public class HtmlBuilderParams
     return removeBodyMargin;
   }
 
+  public boolean isSharedStaticAssets()
+  {
+    return sharedStaticAssets;
+  }
+
   public static class Builder
   {
     private float scale             = 1.0f;
@@ -83,6 +90,7 @@ public class HtmlBuilderParams
     private boolean hidePhrase    = false;
     private String[] hiddenSoundIcons = new String[]{};
     private boolean removeBodyMargin = false;
+    private boolean sharedStaticAssets = false;
 
     public Builder()
     {
@@ -142,6 +150,16 @@ public class HtmlBuilderParams
       return this;
     }
 
+    /**
+     * Reference the static article scripts and styles as shared files in the cache directory
+     * instead of inlining them into every article. The WebView must be allowed to load file:// URLs.
+     */
+    public Builder setSharedStaticAssets( boolean shared )
+    {
+      sharedStaticAssets = shared;
+      return this;
+    }
+
     public HtmlBuilderParams create()
     {
       return new HtmlBuilderParams(this);
@@ -0,0 +1,184 @@
+﻿#include "BenchLayerAccess.h"
+
+#include "SldDictionary.h"
+
+SldU16String CBenchDataAccess::ResolveImageUrl(UInt32)
+{
+	return SldU16String();
+}
+
+SldU16String CBenchDataAccess::ResolveImageUrl(SldU16StringRef, UInt32, SldU16StringRef)
+{
+	return SldU16String();
+}
+
+SldU16StringRef CBenchDataAccess::StyleName(UInt32 aStyleId)
+{
+	UInt16 number[16];
+	CSldCompare::UInt32ToStr(aStyleId, number);
+	m_StyleName.assign(SldU16StringRefLiteral("s"));
+	m_StyleName.append(number);
+	return m_StyleName;
+}
+
+void CBenchDataAccess::InjectCSSStyle(SldU16StringRef)
+{
+}
+
+SldU16StringRef CBenchDataAccess::CSSClassName(const CSldMetadataProxyBase&)
+{
+	return SldU16StringRef();
+}
+
+SldU16StringRef CBenchDataAccess::CSSClassName(const CSldMetadataProxy<eMetaMediaContainer>&)
+{
+	return SldU16StringRef();
+}
+
+SldU16StringRef CBenchDataAccess::CSSClassName(const CSldMetadataProxy<eMetaBackgroundImage>&)
+{
+	return SldU16StringRef();
+}
+
+/** *********************************************************************
+* Начинает сборку нового html документа
+************************************************************************/
+void CBenchHtmlBuilder::StartBuilding()
+{
+	Clear();
+	m_Html.clear();
+}
+
+CBenchLayerAccess::CBenchLayerAccess()
+	: m_SerialDictID(0), m_Builder(m_DataAccess), m_HtmlLength(0)
+{
+	CSldCompare::StrUTF8_2_UTF16(m_PlatformID, (const UInt8*)"L1");
+}
+
+/** *********************************************************************
+* Сбрасывает накопленные html и озвучку
+************************************************************************/
+void CBenchLayerAccess::ResetOutput()
+{
+	m_HtmlLength = 0;
+	m_Sound.clear();
+}
+
+/** *********************************************************************
+* Собирает html перевода так же, как это делает оболочка приложения
+*
+* @param[in]	aDictionary	- указатель на словарь
+* @param[in]	aText		- текст очередного блока перевода
+* @param[in]	aTree		- номер стиля блока или служебный код начала/конца перевода
+*
+* @return error code
+************************************************************************/
+ESldError CBenchLayerAccess::BuildTranslationRight(const CSldDictionary *aDictionary, const UInt16 *aText, ESldTranslationModeType aTree)
+{
+	switch (aTree)
+	{
+	case eTranslationStart:
+		if (!m_Parser)
+			m_Parser.reset(new CSldMetadataParser(const_cast<CSldDictionary*>(aDictionary), &m_DataAccess));
+		m_Builder.StartBuilding();
+		return eOK;
+
+	case eTranslationContinue:
+		return eOK;
+
+	case eTranslationStop:
+		m_HtmlLength += m_Builder.GetHtml().size();
+		return eOK;
+
+	default:
+		break;
+	}
+
+	if (!m_Parser)
+		return eMemoryNullPointer;
+
+	const CSldStyleInfo *styleInfo = NULL;
+	ESldError error = aDictionary->GetStyleInfo(aTree, &styleInfo);
+	if (error != eOK)
+		return error;
+
+	if (!styleInfo->IsVisible())
+		return eOK;
+
+	return m_Builder.Translate(*m_Parser, styleInfo->GetStyleMetaType(), styleInfo->GetGlobalIndex(), aText);
+}
+
+ESldError CBenchLayerAccess::BuildTranslationWrong(const CSldDictionary *aDictionary, const UInt16 *aText, ESldTranslationModeType aTree)
+{
+	return BuildTranslationRight(aDictionary, aText, aTree);
+}
+
+ESldError CBenchLayerAccess::WordFound(const ESldWordFoundCallbackType, const UInt32)
+{
+	return eOK;
+}
+
+ESldError CBenchLayerAccess::SaveSerialData(UInt32 aDictID, const UInt8 *aData, UInt32 aSize)
+{
+	if (!aData)
+		return eMemoryNullPointer;
+
+	m_SerialDictID = aDictID;
+	m_SerialData.assign(aData, aData + aSize);
+	return eOK;
+}
+
+ESldError CBenchLayerAccess::LoadSerialData(UInt32 aDictID, UInt8 *aData, UInt32 *aSize)
+{
+	if (!aSize)
+		return eMemoryNullPointer;
+
+	if (m_SerialData.empty() || m_SerialDictID != aDictID)
+		return eSNDictIDNotFound;
+
+	const UInt32 size = static_cast<UInt32>(m_SerialData.size());
+	if (aData)
+	{
+		if (*aSize < size)
+		{
+			*aSize = size;
+			return eMemoryNotEnoughMemory;
+		}
+		sldMemMove(aData, m_SerialData.data(), size);
+	}
+	*aSize = size;
+	return eOK;
+}
+
+/** *********************************************************************
+* Собирает раскодированные данные озвучки в память
+*
+* @param[in]	aBlockPtr		- указатель на очередной блок данных
+* @param[in]	aBlockSize		- размер блока данных
+* @param[in]	aPreviousSize	- количество данных, переданных на предыдущих итерациях
+* @param[in]	aFrequency		- частота дискретизации
+* @param[in]	aFinishFlag		- этап декодирования (SLD_SOUND_FLAG_*)
+*
+* @return error code
+************************************************************************/
+ESldError CBenchLayerAccess::BuildSoundRight(const UInt8 *aBlockPtr, UInt32 aBlockSize, UInt32, UInt32, UInt32 aFinishFlag)
+{
+	if (aFinishFlag == SLD_SOUND_FLAG_CONTINUE && aBlockPtr && aBlockSize)
+		m_Sound.insert(m_Sound.end(), aBlockPtr, aBlockPtr + aBlockSize);
+	return eOK;
+}
+
+ESldError CBenchLayerAccess::BuildSoundWrong(const UInt8 *aBlockPtr, UInt32 aBlockSize, UInt32 aPreviousSize, UInt32 aFrequency, UInt32 aFinishFlag)
+{
+	return BuildSoundRight(aBlockPtr, aBlockSize, aPreviousSize, aFrequency, aFinishFlag);
+}
+
+ESldError CBenchLayerAccess::LoadSoundByIndex(Int32, const UInt8**, UInt32*)
+{
+	return eResourceCantGetResource;
+}
+
+ESldError CBenchLayerAccess::LoadImageByIndex(Int32, const UInt8**, UInt32*)
+{
+	return eResourceCantGetResource;
+}
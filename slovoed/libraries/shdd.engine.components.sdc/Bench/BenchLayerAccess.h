@@ -0,0 +1,95 @@
+﻿#pragma once
+#ifndef _SDC_BENCH_LAYER_ACCESS_H_
+#define _SDC_BENCH_LAYER_ACCESS_H_
+
+#include <memory>
+#include <vector>
+
+#include "ISldLayerAccess.h"
+#include "SldHTMLBuilder.h"
+#include "SldMetadataParser.h"
+
+// Минимальный доступ к данным для html билдера: без картинок, css классы не генерируются
+class CBenchDataAccess : public CSldBasicHTMLBuilder::IDataAccess
+{
+public:
+	SldU16String ResolveImageUrl(UInt32 aIndex) override;
+	SldU16String ResolveImageUrl(SldU16StringRef aDictId, UInt32 aListId, SldU16StringRef aKey) override;
+	SldU16StringRef StyleName(UInt32 aStyleId) override;
+	void InjectCSSStyle(SldU16StringRef aStyleString) override;
+	SldU16StringRef CSSClassName(const CSldMetadataProxyBase &aData) override;
+	SldU16StringRef CSSClassName(const CSldMetadataProxy<eMetaMediaContainer> &aContainer) override;
+	SldU16StringRef CSSClassName(const CSldMetadataProxy<eMetaBackgroundImage> &aImage) override;
+
+private:
+	// Буфер для имени стиля
+	SldU16String m_StyleName;
+};
+
+// Html билдер, собирающий перевод в строку
+class CBenchHtmlBuilder : public CSldBasicHTMLBuilder
+{
+public:
+	explicit CBenchHtmlBuilder(IDataAccess &aData) : CSldBasicHTMLBuilder(aData) {}
+
+	// Начинает новый документ
+	void StartBuilding();
+
+	// Возвращает собранный html
+	const SldU16String& GetHtml() const { return m_Html; }
+
+protected:
+	void append(SldU16StringRef aString) override { m_Html.append(aString); }
+
+private:
+	// Собранный html
+	SldU16String m_Html;
+};
+
+// Реализация оболочки для замеров: собирает html переводов и данные озвучки в память
+class CBenchLayerAccess : public ISldLayerAccess
+{
+public:
+	CBenchLayerAccess();
+
+	// Сбрасывает накопленные html и озвучку
+	void ResetOutput();
+
+	// Возвращает количество символов html, собранного с последнего сброса
+	UInt64 GetHtmlLength() const { return m_HtmlLength; }
+
+	// Возвращает количество байт озвучки, собранной с последнего сброса
+	UInt64 GetSoundSize() const { return m_Sound.size(); }
+
+	ESldError BuildTranslationRight(const CSldDictionary *aDictionary, const UInt16 *aText, ESldTranslationModeType aTree) override;
+	ESldError BuildTranslationWrong(const CSldDictionary *aDictionary, const UInt16 *aText, ESldTranslationModeType aTree) override;
+	ESldError WordFound(const ESldWordFoundCallbackType aCallbackType, const UInt32 aIndex) override;
+	const UInt16* GetPlatformID() override { return m_PlatformID; }
+	ESldError SaveSerialData(UInt32 aDictID, const UInt8 *aData, UInt32 aSize) override;
+	ESldError LoadSerialData(UInt32 aDictID, UInt8 *aData, UInt32 *aSize) override;
+	ESldError BuildSoundRight(const UInt8 *aBlockPtr, UInt32 aBlockSize, UInt32 aPreviousSize, UInt32 aFrequency, UInt32 aFinishFlag) override;
+	ESldError BuildSoundWrong(const UInt8 *aBlockPtr, UInt32 aBlockSize, UInt32 aPreviousSize, UInt32 aFrequency, UInt32 aFinishFlag) override;
+	ESldError LoadSoundByIndex(Int32 aSoundIndex, const UInt8 **aDataPtr, UInt32 *aDataSize) override;
+	ESldError LoadImageByIndex(Int32 aImageIndex, const UInt8 **aDataPtr, UInt32 *aDataSize) override;
+
+private:
+	// Идентификатор платформы
+	UInt16 m_PlatformID[4];
+
+	// Регистрационные данные
+	UInt32 m_SerialDictID;
+	std::vector<UInt8> m_SerialData;
+
+	// Парсер метаданных (создается при первом переводе, т.к. ему нужен словарь)
+	std::unique_ptr<CSldMetadataParser> m_Parser;
+	CBenchDataAccess m_DataAccess;
+	CBenchHtmlBuilder m_Builder;
+
+	// Количество символов html, собранного с последнего сброса
+	UInt64 m_HtmlLength;
+
+	// Данные озвучки
+	std::vector<UInt8> m_Sound;
+};
+
+#endif // _SDC_BENCH_LAYER_ACCESS_H_
@@ -0,0 +1,86 @@
+﻿#include "SdcFile.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CSdcFile::~CSdcFile()
+{
+	Close();
+}
+
+/** *********************************************************************
+* Открывает файл контейнера
+*
+* @param[in]	aPath	- путь к файлу
+*
+* @return true, если файл открыт
+************************************************************************/
+bool CSdcFile::Open(const char *aPath)
+{
+	Close();
+
+	m_Fd = ::open(aPath, O_RDONLY);
+	if (m_Fd == -1)
+		return false;
+
+	struct stat st;
+	if (::fstat(m_Fd, &st) != 0 || st.st_size > 0xFFFFFFFF)
+	{
+		Close();
+		return false;
+	}
+
+	m_Size = static_cast<UInt32>(st.st_size);
+	return true;
+}
+
+/** *********************************************************************
+* Закрывает файл контейнера
+************************************************************************/
+void CSdcFile::Close()
+{
+	if (m_Fd != -1)
+		::close(m_Fd);
+
+	m_Fd = -1;
+	m_Size = 0;
+}
+
+/** *********************************************************************
+* Читает блок данных из файла
+*
+* @param[out]	aDestPtr	- указатель, куда будут записаны прочитанные данные
+* @param[in]	aSize		- размер блока данных в байтах
+* @param[in]	aOffset		- смещение блока от начала файла в байтах
+*
+* @return размер прочитанного блока данных в байтах
+************************************************************************/
+UInt32 CSdcFile::Read(void *aDestPtr, UInt32 aSize, UInt32 aOffset)
+{
+	if (m_Fd == -1 || !aDestPtr)
+		return 0;
+
+	UInt8 *dest = static_cast<UInt8*>(aDestPtr);
+	UInt32 done = 0;
+	while (done < aSize)
+	{
+		const ssize_t count = ::pread(m_Fd, dest + done, aSize - done, static_cast<off_t>(aOffset) + done);
+		if (count <= 0)
+			break;
+		done += static_cast<UInt32>(count);
+	}
+	return done;
+}
+
+/** *********************************************************************
+* Сообщает ядру ОС, что блок данных скоро будет прочитан
+*
+* @param[in]	aOffset	- смещение блока от начала файла в байтах
+* @param[in]	aSize	- размер блока данных в байтах
+************************************************************************/
+void CSdcFile::Prefetch(UInt32 aOffset, UInt32 aSize)
+{
+	if (m_Fd != -1)
+		::posix_fadvise(m_Fd, static_cast<off_t>(aOffset), static_cast<off_t>(aSize), POSIX_FADV_WILLNEED);
+}
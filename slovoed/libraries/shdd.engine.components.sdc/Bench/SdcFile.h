@@ -0,0 +1,39 @@
+﻿#pragma once
+#ifndef _SDC_BENCH_SDC_FILE_H_
+#define _SDC_BENCH_SDC_FILE_H_
+
+#include "ISDCFile.h"
+
+// Чтение файла контейнера через pread(): чтение не меняет позицию в файле и не требует буферизации
+class CSdcFile : public ISDCFile
+{
+public:
+	CSdcFile() : m_Fd(-1), m_Size(0) {}
+	~CSdcFile();
+
+	CSdcFile(const CSdcFile&) = delete;
+	CSdcFile& operator=(const CSdcFile&) = delete;
+
+	// Открывает файл. true - если файл открыт
+	bool Open(const char *aPath);
+
+	// Закрывает файл
+	void Close();
+
+	Int8 IsOpened() const override { return m_Fd != -1; }
+
+	UInt32 Read(void *aDestPtr, UInt32 aSize, UInt32 aOffset) override;
+
+	UInt32 GetSize() const override { return m_Size; }
+
+	void Prefetch(UInt32 aOffset, UInt32 aSize) override;
+
+private:
+	// Дескриптор открытого файла
+	int m_Fd;
+
+	// Размер файла
+	UInt32 m_Size;
+};
+
+#endif // _SDC_BENCH_SDC_FILE_H_
@@ -0,0 +1,552 @@
+﻿// Консольная утилита для замеров производительности ядра на Linux.
+//
+// Открывает базу и прогоняет по ней сценарий запросов через API CSldDictionary,
+// выводя пропускную способность и латентности (p50/p99) по каждому типу операций в JSON.
+//
+// Формат сценария (UTF-8, одна операция в строке, '#' - комментарий):
+//   list <index>            - список слов для последующих операций (по умолчанию 0)
+//   word <text>             - GetWordByText
+//   translate <text>        - Translate всех переводов слова (слово ищется один раз до замеров)
+//   fuzzy <distance> <text> - DoFuzzySearch
+//   fts <text>              - подготовка запроса и DoFullTextSearch
+//   wildcard <pattern>      - подготовка запроса и DoWildCardSearch
+//   morpho <text>           - получение всех словоформ
+//   sound <text>            - PlaySoundByText
+//   strings <count>         - пакетное получение строк метаданных через CSldMetadataManager::GetStrings
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "SldAuxiliary.h"
+#include "SldDictionary.h"
+#include "SldMetadataManager.h"
+
+#include "BenchLayerAccess.h"
+#include "SdcFile.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Типы операций сценария
+enum EBenchOp
+{
+	eOpWord = 0,
+	eOpTranslate,
+	eOpFuzzy,
+	eOpFullText,
+	eOpWildCard,
+	eOpMorpho,
+	eOpSound,
+	eOpStrings,
+
+	eOpCount
+};
+
+const char *const g_OpNames[eOpCount] = { "word", "translate", "fuzzy", "fts", "wildcard", "morpho", "sound", "strings" };
+
+// Одна операция сценария
+struct TBenchItem
+{
+	EBenchOp Op;
+	// Номер строки сценария
+	UInt32 Line;
+	// Индекс списка слов
+	Int32 List;
+	// Текст запроса
+	std::string Text;
+	SldU16String Query;
+	// Допустимое расстояние для нечеткого поиска
+	Int32 Distance;
+	// Индекс слова для перевода
+	Int32 WordIndex;
+	// Количество строк метаданных в пакете
+	UInt32 Count;
+};
+
+// Параметры запуска
+struct TBenchOptions
+{
+	const char *DictionaryPath = nullptr;
+	const char *ScriptPath = nullptr;
+	const char *MorphoPath = nullptr;
+	UInt32 Iterations = 10;
+	UInt32 Warmup = 1;
+	Int32 MaximumWords = 1000;
+	UInt32 ResidentResources = 0;
+	bool VerifyResources = false;
+};
+
+// Замеры по одному типу операций
+struct TBenchStats
+{
+	std::vector<double> Latencies;
+	UInt32 Errors = 0;
+};
+
+// Окружение, в котором выполняются операции
+struct TBenchContext
+{
+	CSldDictionary &Dictionary;
+	MorphoData *Morpho;
+	Int32 MaximumWords;
+};
+
+void PrintUsage()
+{
+	fprintf(stderr,
+		"Usage: sdc_bench [options] <dictionary.sdc> <script.txt>\n"
+		"  -n <count>       number of measured passes over the script (default 10)\n"
+		"  -w <count>       number of warm-up passes (default 1)\n"
+		"  -max <count>     maximum number of search results (default 1000)\n"
+		"  -morpho <file>   external morphology base used by fts, wildcard and morpho\n"
+		"  -resident <count> number of resident metadata string store resources\n"
+		"  -verify          check resource checksums as resources are loaded\n");
+}
+
+SldU16String FromUtf8(const std::string &aText)
+{
+	const UInt8 *utf8 = reinterpret_cast<const UInt8*>(aText.c_str());
+	std::vector<UInt16> buf(CSldCompare::StrUTF8_2_UTF16(nullptr, utf8) + 1);
+	CSldCompare::StrUTF8_2_UTF16(buf.data(), utf8);
+	return SldU16String(buf.data());
+}
+
+std::string JsonEscape(const std::string &aText)
+{
+	std::string out;
+	for (unsigned char ch : aText)
+	{
+		if (ch == '"' || ch == '\\')
+		{
+			out += '\\';
+			out += static_cast<char>(ch);
+		}
+		else if (ch < 0x20)
+		{
+			char buf[8];
+			snprintf(buf, sizeof(buf), "\\u%04x", ch);
+			out += buf;
+		}
+		else
+			out += static_cast<char>(ch);
+	}
+	return out;
+}
+
+bool ParseOptions(int argc, char **argv, TBenchOptions &aOptions)
+{
+	std::vector<const char*> positional;
+	for (int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (!strcmp(arg, "-n") && hasValue)
+			aOptions.Iterations = static_cast<UInt32>(atoi(argv[++i]));
+		else if (!strcmp(arg, "-w") && hasValue)
+			aOptions.Warmup = static_cast<UInt32>(atoi(argv[++i]));
+		else if (!strcmp(arg, "-max") && hasValue)
+			aOptions.MaximumWords = atoi(argv[++i]);
+		else if (!strcmp(arg, "-morpho") && hasValue)
+			aOptions.MorphoPath = argv[++i];
+		else if (!strcmp(arg, "-resident") && hasValue)
+			aOptions.ResidentResources = static_cast<UInt32>(atoi(argv[++i]));
+		else if (!strcmp(arg, "-verify"))
+			aOptions.VerifyResources = true;
+		else if (arg[0] == '-')
+			return false;
+		else
+			positional.push_back(arg);
+	}
+
+	if (positional.size() != 2 || !aOptions.Iterations || aOptions.MaximumWords <= 0)
+		return false;
+
+	aOptions.DictionaryPath = positional[0];
+	aOptions.ScriptPath = positional[1];
+	return true;
+}
+
+// Читает сценарий; возвращает false при синтаксической ошибке
+bool LoadScript(const char *aPath, std::vector<TBenchItem> &aItems)
+{
+	std::ifstream in(aPath);
+	if (!in)
+	{
+		fprintf(stderr, "Can't open script: %s\n", aPath);
+		return false;
+	}
+
+	Int32 list = 0;
+	std::string line;
+	for (UInt32 lineNumber = 1; std::getline(in, line); lineNumber++)
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+
+		const size_t start = line.find_first_not_of(" \t");
+		if (start == std::string::npos || line[start] == '#')
+			continue;
+
+		const size_t opEnd = line.find_first_of(" \t", start);
+		const std::string op = line.substr(start, opEnd - start);
+		const size_t textStart = opEnd == std::string::npos ? std::string::npos : line.find_first_not_of(" \t", opEnd);
+		std::string text = textStart == std::string::npos ? std::string() : line.substr(textStart);
+
+		if (op == "list")
+		{
+			list = atoi(text.c_str());
+			continue;
+		}
+
+		TBenchItem item;
+		item.Line = lineNumber;
+		item.List = list;
+		item.Distance = 0;
+		item.WordIndex = -1;
+		item.Count = 0;
+
+		const char *const *name = std::find_if(g_OpNames, g_OpNames + eOpCount, [&op](const char *n) { return op == n; });
+		if (name == g_OpNames + eOpCount || text.empty())
+		{
+			fprintf(stderr, "%s:%u: bad operation: %s\n", aPath, lineNumber, line.c_str());
+			return false;
+		}
+		item.Op = static_cast<EBenchOp>(name - g_OpNames);
+
+		if (item.Op == eOpFuzzy)
+		{
+			char *end = nullptr;
+			item.Distance = static_cast<Int32>(strtol(text.c_str(), &end, 10));
+			const size_t pos = text.find_first_not_of(" \t", end - text.c_str());
+			if (end == text.c_str() || pos == std::string::npos)
+			{
+				fprintf(stderr, "%s:%u: expected 'fuzzy <distance> <text>'\n", aPath, lineNumber);
+				return false;
+			}
+			text.erase(0, pos);
+		}
+		else if (item.Op == eOpStrings)
+		{
+			item.Count = static_cast<UInt32>(atoi(text.c_str()));
+			if (!item.Count)
+			{
+				fprintf(stderr, "%s:%u: expected 'strings <count>'\n", aPath, lineNumber);
+				return false;
+			}
+		}
+
+		item.Text = text;
+		item.Query = FromUtf8(text);
+		aItems.push_back(std::move(item));
+	}
+	return true;
+}
+
+// Находит слова для операций перевода, чтобы поиск слова не попадал в замеры перевода
+void ResolveTranslations(CSldDictionary &aDictionary, std::vector<TBenchItem> &aItems)
+{
+	for (TBenchItem &item : aItems)
+	{
+		if (item.Op != eOpTranslate)
+			continue;
+
+		UInt32 resultFlag = 0;
+		ESldError error = aDictionary.GetWordByTextExtended(item.List, item.Query.c_str(), &resultFlag);
+		if (error == eOK && resultFlag)
+			error = aDictionary.GetCurrentIndex(item.List, &item.WordIndex);
+
+		if (error != eOK || !resultFlag)
+		{
+			item.WordIndex = -1;
+			fprintf(stderr, "line %u: word not found for translation: %s\n", item.Line, item.Text.c_str());
+		}
+	}
+}
+
+ESldError RunItem(TBenchContext &aContext, const TBenchItem &aItem)
+{
+	CSldDictionary &dict = aContext.Dictionary;
+	ESldError error = eOK;
+
+	switch (aItem.Op)
+	{
+	case eOpWord:
+		return dict.GetWordByText(aItem.List, aItem.Query.c_str());
+
+	case eOpTranslate:
+	{
+		if (aItem.WordIndex < 0)
+			return eCommonWrongIndex;
+
+		Int32 count = 0;
+		error = dict.GetNumberOfTranslations(aItem.List, aItem.WordIndex, &count);
+		for (Int32 i = 0; error == eOK && i < count; i++)
+			error = dict.Translate(aItem.List, aItem.WordIndex, i, eTranslationFull);
+		return error;
+	}
+
+	case eOpFuzzy:
+		return dict.DoFuzzySearch(aItem.List, aItem.Query.c_str(), aContext.MaximumWords, aItem.Distance);
+
+	case eOpFullText:
+	{
+		SldU16String query;
+		if (aContext.Morpho)
+			error = PrepareQueryForFullTextSearch(aItem.Query.c_str(), &dict, aItem.List, aContext.Morpho, query);
+		else
+			error = PrepareQueryForFullTextSearch(aItem.Query.c_str(), &dict, aItem.List, query);
+		if (error != eOK)
+			return error;
+		return dict.DoFullTextSearch(aItem.List, query.c_str(), aContext.MaximumWords);
+	}
+
+	case eOpWildCard:
+	{
+		TExpressionBox box;
+		if (aContext.Morpho)
+			error = PrepareQueryForWildCardSearch(aItem.Query.c_str(), &dict, aItem.List, aContext.Morpho, &box);
+		else
+			error = PrepareQueryForWildCardSearch(aItem.Query.c_str(), &dict, aItem.List, &box);
+		if (error != eOK)
+			return error;
+		return dict.DoWildCardSearch(aItem.List, &box, aContext.MaximumWords);
+	}
+
+	case eOpMorpho:
+	{
+		CSldVector<TSldMorphologyWordStruct> forms;
+		if (aContext.Morpho)
+			return GetAllMorphoForms(aItem.Query.c_str(), aContext.Morpho, forms);
+		return GetAllMorphoForms(aItem.Query.c_str(), &dict, dict.GetListLanguageFrom(aItem.List), forms);
+	}
+
+	case eOpSound:
+	{
+		error = dict.SetCurrentWordlist(aItem.List);
+		if (error != eOK)
+			return error;
+
+		UInt32 resultFlag = 0;
+		return dict.PlaySoundByText(aItem.Query.c_str(), &resultFlag);
+	}
+
+	case eOpStrings:
+	{
+		CSldMetadataManager *metadata = nullptr;
+		error = dict.GetMetadataManager(&metadata);
+		if (error != eOK)
+			return error;
+
+		const UInt32 total = metadata ? metadata->GetStringCount() : 0;
+		if (!total)
+			return eCommonWrongIndex;
+
+		// индексы разбросаны по всему string store, так что соседние запросы попадают в разные ресурсы
+		std::vector<UInt32> indexes(std::min(aItem.Count, total));
+		for (UInt32 i = 0; i < indexes.size(); i++)
+			indexes[i] = static_cast<UInt32>(i * 2654435761ull % total);
+
+		return metadata->GetStrings(sld2::Span<const UInt32>(indexes.data(), static_cast<UInt32>(indexes.size())),
+									[](UInt32, SldU16StringRef) {});
+	}
+
+	default:
+		return eCommonWrongIndex;
+	}
+}
+
+// Выполняет один проход по сценарию; при aStats == nullptr замеры не сохраняются
+void RunPass(TBenchContext &aContext, const std::vector<TBenchItem> &aItems, TBenchStats *aStats)
+{
+	for (const TBenchItem &item : aItems)
+	{
+		const Clock::time_point start = Clock::now();
+		const ESldError error = RunItem(aContext, item);
+		const Clock::time_point stop = Clock::now();
+
+		// поисковые списки не накапливаются между операциями
+		aContext.Dictionary.ClearSearch();
+
+		if (!aStats)
+			continue;
+
+		TBenchStats &stats = aStats[item.Op];
+		stats.Latencies.push_back(std::chrono::duration<double, std::micro>(stop - start).count());
+		if (error != eOK)
+			stats.Errors++;
+	}
+}
+
+// Процентиль по методу ближайшего ранга; aSorted отсортирован по возрастанию
+double Percentile(const std::vector<double> &aSorted, double aRank)
+{
+	if (aSorted.empty())
+		return 0.0;
+
+	size_t index = static_cast<size_t>(std::ceil(aRank * aSorted.size()));
+	index = index ? index - 1 : 0;
+	return aSorted[std::min(index, aSorted.size() - 1)];
+}
+
+void PrintStats(const char *aName, std::vector<double> aLatencies, UInt32 aErrors, bool aLast)
+{
+	std::sort(aLatencies.begin(), aLatencies.end());
+	double total = 0.0;
+	for (double latency : aLatencies)
+		total += latency;
+
+	const double opsPerSec = total > 0.0 ? aLatencies.size() * 1e6 / total : 0.0;
+	printf("    \"%s\": {\"count\": %zu, \"errors\": %u, \"total_ms\": %.3f, \"ops_per_sec\": %.1f, "
+		   "\"mean_us\": %.2f, \"p50_us\": %.2f, \"p99_us\": %.2f, \"max_us\": %.2f}%s\n",
+		   aName, aLatencies.size(), aErrors, total / 1000.0, opsPerSec,
+		   aLatencies.empty() ? 0.0 : total / aLatencies.size(),
+		   Percentile(aLatencies, 0.5), Percentile(aLatencies, 0.99),
+		   aLatencies.empty() ? 0.0 : aLatencies.back(), aLast ? "" : ",");
+}
+
+} // anon namespace
+
+int main(int argc, char **argv)
+{
+	TBenchOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	std::vector<TBenchItem> items;
+	if (!LoadScript(options.ScriptPath, items))
+		return 2;
+
+	CSdcFile file;
+	if (!file.Open(options.DictionaryPath))
+	{
+		fprintf(stderr, "Can't open dictionary: %s\n", options.DictionaryPath);
+		return 1;
+	}
+
+	CBenchLayerAccess layer;
+	CSldDictionary dictionary;
+	dictionary.SetResourceVerification(options.VerifyResources);
+
+	const Clock::time_point openStart = Clock::now();
+	ESldError error = dictionary.Open(&file, &layer);
+	const double openMs = std::chrono::duration<double, std::milli>(Clock::now() - openStart).count();
+	if (error != eOK)
+	{
+		fprintf(stderr, "CSldDictionary::Open failed: 0x%x\n", error);
+		return 1;
+	}
+
+	if (options.ResidentResources)
+	{
+		CSldMetadataManager *metadata = nullptr;
+		error = dictionary.GetMetadataManager(&metadata);
+		if (error == eOK && metadata)
+			error = metadata->SetStringsResidentResourceCount(options.ResidentResources);
+		if (error != eOK)
+		{
+			fprintf(stderr, "Can't set resident string store resources: 0x%x\n", error);
+			return 1;
+		}
+	}
+
+	CSdcFile morphoFile;
+	MorphoData morpho;
+	TBenchContext context = { dictionary, nullptr, options.MaximumWords };
+	if (options.MorphoPath)
+	{
+		if (!morphoFile.Open(options.MorphoPath) || !morpho.Init(&morphoFile, &layer))
+		{
+			fprintf(stderr, "Can't load morphology: %s\n", options.MorphoPath);
+			return 1;
+		}
+		context.Morpho = &morpho;
+	}
+
+	ResolveTranslations(dictionary, items);
+
+	for (UInt32 pass = 0; pass < options.Warmup; pass++)
+		RunPass(context, items, nullptr);
+
+	layer.ResetOutput();
+	dictionary.ResetStatistics();
+
+	TBenchStats stats[eOpCount];
+	const Clock::time_point runStart = Clock::now();
+	for (UInt32 pass = 0; pass < options.Iterations; pass++)
+		RunPass(context, items, stats);
+	const double runMs = std::chrono::duration<double, std::milli>(Clock::now() - runStart).count();
+
+	std::vector<double> all;
+	UInt32 allErrors = 0;
+	for (const TBenchStats &s : stats)
+	{
+		all.insert(all.end(), s.Latencies.begin(), s.Latencies.end());
+		allErrors += s.Errors;
+	}
+
+	printf("{\n");
+	printf("  \"dictionary\": \"%s\",\n", JsonEscape(options.DictionaryPath).c_str());
+	printf("  \"script\": \"%s\",\n", JsonEscape(options.ScriptPath).c_str());
+	printf("  \"iterations\": %u,\n", options.Iterations);
+	printf("  \"warmup\": %u,\n", options.Warmup);
+	printf("  \"open_ms\": %.3f,\n", openMs);
+	printf("  \"run_ms\": %.3f,\n", runMs);
+	printf("  \"html_chars\": %llu,\n", static_cast<unsigned long long>(layer.GetHtmlLength()));
+	printf("  \"sound_bytes\": %llu,\n", static_cast<unsigned long long>(layer.GetSoundSize()));
+	printf("  \"operations\": {\n");
+	std::vector<UInt32> used;
+	for (UInt32 op = 0; op < eOpCount; op++)
+	{
+		if (!stats[op].Latencies.empty())
+			used.push_back(op);
+	}
+	for (size_t i = 0; i < used.size(); i++)
+		PrintStats(g_OpNames[used[i]], stats[used[i]].Latencies, stats[used[i]].Errors, false);
+	PrintStats("all", all, allErrors, true);
+
+	// engine counters are only available when the engine is built with SLD__HAVE_STATISTICS
+	TSldStatistics engineStats;
+	if (dictionary.GetStatistics(&engineStats) == eOK)
+	{
+		static const char *const operationNames[eStatisticsOperation_Count] = {
+			"open", "get_word_by_index", "get_word_by_text", "translate", "wildcard", "fuzzy",
+			"anagram", "spelling", "fts", "sort_relevant"
+		};
+
+		printf("  },\n");
+		printf("  \"engine\": {\n");
+		printf("    \"resources_loaded\": %llu,\n", static_cast<unsigned long long>(engineStats.ResourcesLoaded));
+		printf("    \"bytes_read\": %llu,\n", static_cast<unsigned long long>(engineStats.BytesRead));
+		printf("    \"bits_decoded\": %llu,\n", static_cast<unsigned long long>(engineStats.BitsDecoded));
+		printf("    \"words_decoded\": %llu,\n", static_cast<unsigned long long>(engineStats.WordsDecoded));
+		printf("    \"articles_skipped\": %llu,\n", static_cast<unsigned long long>(engineStats.ArticlesSkipped));
+		printf("    \"stricmp_calls\": %llu,\n", static_cast<unsigned long long>(engineStats.StrICmpCalls));
+		printf("    \"operations\": {");
+		const char *separator = "\n";
+		for (UInt32 op = 0; op < eStatisticsOperation_Count; op++)
+		{
+			if (!engineStats.OperationCalls[op])
+				continue;
+			printf("%s      \"%s\": {\"calls\": %llu, \"total_ms\": %.3f}", separator, operationNames[op],
+				   static_cast<unsigned long long>(engineStats.OperationCalls[op]), engineStats.OperationTime[op] / 1e6);
+			separator = ",\n";
+		}
+		printf("\n    }\n");
+	}
+	printf("  }\n");
+	printf("}\n");
+
+	dictionary.Close();
+	return allErrors ? 3 : 0;
+}
@@ -26,6 +26,19 @@ public:
 
 	// Returns the size of the file in bytes
 	virtual UInt32 GetSize() const = 0;
+
+	/**
+	 * Hints that a block of data will soon be read from the file
+	 *
+	 * The engine calls it when it detects a sequential scan through the data, so an
+	 * implementation can start reading ahead (e.g. posix_fadvise(POSIX_FADV_WILLNEED),
+	 * readahead() or a background read). The call must not block and must not fail;
+	 * the default implementation does nothing
+	 *
+	 * @param[in] aOffset  - offset (in bytes) relative to the beginning of the file
+	 * @param[in] aSize    - data block size (in bytes)
+	 */
+	virtual void Prefetch(UInt32 /*aOffset*/, UInt32 /*aSize*/) {}
 };
 
 #endif // _I_SDC_FILE_H_
@@ -4,6 +4,7 @@
 #include "SldError.h"
 #include "SldTypes.h"
 #include "SldSDCReadMy.h"
+#include "SldStatistics.h"
 
 
 // Class preliminary declaration.
@@ -160,6 +161,25 @@ public:
 	* @return error code
 	************************************************************************/
 	virtual ESldError LoadImageByIndex(Int32 aImageIndex, const UInt8** aDataPtr, UInt32* aDataSize) = 0;
+
+	/***********************************************************************
+	* Called before a dictionary operation starts.
+	* Only called if the Engine is built with SLD__HAVE_STATISTICS.
+	*
+	* @param aDictionary	- the dictionary performing the operation
+	* @param aOperation		- the operation
+	************************************************************************/
+	virtual void TraceBegin(const CSldDictionary * /*aDictionary*/, ESldStatisticsOperation /*aOperation*/) {}
+
+	/***********************************************************************
+	* Called after a dictionary operation finishes (calls are properly nested).
+	* Only called if the Engine is built with SLD__HAVE_STATISTICS.
+	*
+	* @param aDictionary	- the dictionary performing the operation
+	* @param aOperation		- the operation
+	* @param aTime			- the operation wall time in nanoseconds
+	************************************************************************/
+	virtual void TraceEnd(const CSldDictionary * /*aDictionary*/, ESldStatisticsOperation /*aOperation*/, UInt64 /*aTime*/) {}
 };
 
 
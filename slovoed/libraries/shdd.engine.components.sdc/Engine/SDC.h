@@ -37,11 +37,15 @@
 	[Resource record N]			\n
 								\n
 	[Data]						\n
+								\n
+	[Resource checksums]		\n
 
 	The SDC Header contains the header of the container that stores general information.
 	Resource record X are records with information about where resources are located.
 	Data - the actual data that should be stored in the container.
 	Attention! The actual resource data goes in the same order as the records in the Resource record.
+	Resource checksums - optional table with a CRC32 of every resource, which allows to check
+	the integrity of a resource when it is loaded instead of checking the whole file at once.
 */
 
 // File header structure
@@ -79,8 +83,12 @@ typedef struct SlovoEdContainerHeader
 	UInt8	HasCompressedResources;
 	// explicit alignment to next UInt32
 	UInt16	_pad0;
+	// Offset from the beginning of the file to the resource checksum table, 0 if there is no table.
+	// The table holds NumberOfResources CRC32 values of the stored resource data (including
+	// #SlovoEdContainerCompressedResourceHeader for compressed resources) in the resource table order
+	UInt32	ResourceCRCTableShift;
 	// Reserved
-	UInt32	Reserved[19];
+	UInt32	Reserved[18];
 }SlovoEdContainerHeader;
 
 // A structure describing the location of the resource.
@@ -159,6 +167,8 @@ enum SDCError
 	SDC_WRITE_CANT_WRITE,
 	// Resource table sorting error
 	SDC_WRITE_CANT_SORT_RESOURCE_TABLE,
+	// Spilling resources to disk can't be enabled (resources already added or temporary file creation error)
+	SDC_WRITE_CANT_ENABLE_SPILL,
 
 	// Errors of the class responsible for reading.
 	SDC_READ_ERRORS = 0x0300,
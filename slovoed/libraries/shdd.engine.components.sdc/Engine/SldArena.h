@@ -0,0 +1,362 @@
+﻿#ifndef _SLD_ARENA_H_
+#define _SLD_ARENA_H_
+
+#include "SldPlatform.h"
+#include "SldStatistics.h"
+#include "SldUtil.h"
+
+namespace sld2 {
+
+// Счетчики арены
+struct ArenaStats
+{
+	// Количество выделений из арены
+	UInt64 Allocations;
+	// Суммарный объем выделений из арены в байтах (с учетом выравнивания)
+	UInt64 AllocatedBytes;
+	// Количество блоков, запрошенных ареной у sldMemNew()
+	UInt32 ChunkAllocations;
+	// Суммарный размер блоков, которыми сейчас владеет арена, в байтах
+	UInt32 ReservedBytes;
+	// Максимальный объем одновременно занятой памяти арены в байтах
+	UInt32 PeakBytes;
+};
+
+/**
+ * Arena - "линейный" (bump) распределитель памяти для временных буферов
+ *
+ * Память выделяется последовательно из крупных блоков. Отдельные выделения не освобождаются:
+ * вся память, выделенная после mark(), возвращается в арену вызовом rewind(). Сами блоки при
+ * этом остаются у арены и переиспользуются следующими выделениями, так что после "прогрева"
+ * повторяющиеся операции вообще не обращаются к sldMemNew() (и не конкурируют за общую кучу
+ * с другими потоками).
+ *
+ * Деструкторы размещенных в арене объектов не вызываются. Класс не потокобезопасен - арена
+ * должна принадлежать одному потоку (или одному словарю).
+ */
+class Arena
+{
+	struct Chunk
+	{
+		// Следующий блок
+		Chunk *next;
+		// Размер данных блока
+		UInt32 size;
+		// Количество занятых байт
+		UInt32 used;
+
+		UInt8* data() { return reinterpret_cast<UInt8*>(this + 1); }
+	};
+
+public:
+	// Размер блока по умолчанию
+	enum : UInt32 { DefaultChunkSize = 16 * 1024 };
+
+	// Позиция в арене, см. mark()/rewind()
+	struct Marker
+	{
+		Chunk *chunk;
+		UInt32 used;
+		UInt32 bytes;
+	};
+
+	explicit Arena(UInt32 aChunkSize = DefaultChunkSize)
+		: m_Head(nullptr), m_Current(nullptr), m_ChunkSize(aChunkSize), m_UsedBytes(0)
+	{
+		sldMemZero(&m_Stats, sizeof(m_Stats));
+	}
+
+	~Arena() { release(); }
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	/**
+	 * Выделяет aSize байт с выравниванием aAlign (степень двойки)
+	 *
+	 * @return указатель на память или nullptr, если память выделить не удалось
+	 */
+	void* allocate(UInt32 aSize, UInt32 aAlign = sizeof(UInt64))
+	{
+		if (m_Current)
+		{
+			const UInt32 padding = paddingFor(m_Current, aAlign);
+			if (m_Current->size - m_Current->used >= padding && m_Current->size - m_Current->used - padding >= aSize)
+				return take(m_Current, padding, aSize);
+		}
+
+		// В текущий блок не помещается - переходим к следующему
+		if (aSize > 0xFFFFFFFFU - aAlign - sizeof(Chunk))
+			return nullptr;
+
+		Chunk *chunk = nextChunk(aSize + aAlign);
+		if (!chunk)
+			return nullptr;
+
+		return take(chunk, paddingFor(chunk, aAlign), aSize);
+	}
+
+	// Выделяет память под aCount объектов типа T (объекты не конструируются)
+	template <typename T>
+	T* allocate(UInt32 aCount)
+	{
+		if (aCount > 0xFFFFFFFFU / sizeof(T))
+			return nullptr;
+		return static_cast<T*>(allocate(aCount * sizeof(T), alignof(T)));
+	}
+
+	// Возвращает текущую позицию арены
+	Marker mark() const
+	{
+		Marker marker = { m_Current, m_Current ? m_Current->used : 0, m_UsedBytes };
+		return marker;
+	}
+
+	// Возвращает в арену всю память, выделенную после получения aMarker
+	void rewind(const Marker &aMarker)
+	{
+		m_Current = aMarker.chunk;
+		if (m_Current)
+			m_Current->used = aMarker.used;
+		m_UsedBytes = aMarker.bytes;
+	}
+
+	// Возвращает в арену всю выделенную память (блоки остаются у арены)
+	void reset()
+	{
+		m_Current = nullptr;
+		m_UsedBytes = 0;
+	}
+
+	// Освобождает все блоки арены
+	void release()
+	{
+		while (m_Head)
+		{
+			Chunk *next = m_Head->next;
+			sldMemFree(m_Head);
+			m_Head = next;
+		}
+		m_Current = nullptr;
+		m_UsedBytes = 0;
+		m_Stats.ReservedBytes = 0;
+	}
+
+	// Возвращает счетчики арены
+	const ArenaStats& stats() const { return m_Stats; }
+
+	// Обнуляет накопительные счетчики арены (кроме ReservedBytes)
+	void clearStats()
+	{
+		const UInt32 reserved = m_Stats.ReservedBytes;
+		sldMemZero(&m_Stats, sizeof(m_Stats));
+		m_Stats.ReservedBytes = reserved;
+	}
+
+private:
+
+	static UInt32 paddingFor(Chunk *aChunk, UInt32 aAlign)
+	{
+		const UInt4Ptr address = reinterpret_cast<UInt4Ptr>(aChunk->data() + aChunk->used);
+		return static_cast<UInt32>((0 - address) & (aAlign - 1));
+	}
+
+	void* take(Chunk *aChunk, UInt32 aPadding, UInt32 aSize)
+	{
+		UInt8 *ptr = aChunk->data() + aChunk->used + aPadding;
+		aChunk->used += aPadding + aSize;
+
+		m_UsedBytes += aPadding + aSize;
+		if (m_UsedBytes > m_Stats.PeakBytes)
+			m_Stats.PeakBytes = m_UsedBytes;
+		m_Stats.Allocations++;
+		m_Stats.AllocatedBytes += aPadding + aSize;
+		return ptr;
+	}
+
+	// Делает текущим следующий блок, в котором есть хотя бы aSize свободных байт
+	Chunk* nextChunk(UInt32 aSize)
+	{
+		Chunk *next = m_Current ? m_Current->next : m_Head;
+		if (next && next->size >= aSize)
+		{
+			next->used = 0;
+			m_Current = next;
+			return next;
+		}
+
+		// Подходящего блока нет - выделяем новый и вставляем его перед следующим
+		const UInt32 size = aSize > m_ChunkSize ? aSize : m_ChunkSize;
+		Chunk *chunk = static_cast<Chunk*>(sldMemNew(sizeof(Chunk) + size));
+		if (!chunk)
+			return nullptr;
+
+		chunk->next = next;
+		chunk->size = size;
+		chunk->used = 0;
+		if (m_Current)
+			m_Current->next = chunk;
+		else
+			m_Head = chunk;
+		m_Current = chunk;
+
+		m_Stats.ChunkAllocations++;
+		m_Stats.ReservedBytes += size;
+		return chunk;
+	}
+
+	// Первый блок
+	Chunk *m_Head;
+	// Текущий блок (nullptr - арена пуста)
+	Chunk *m_Current;
+	// Размер блока
+	UInt32 m_ChunkSize;
+	// Количество занятых байт во всех блоках до текущей позиции
+	UInt32 m_UsedBytes;
+	// Счетчики
+	ArenaStats m_Stats;
+};
+
+#ifdef SLD__HAVE_SCRATCH_ARENA
+
+namespace arena {
+
+// Возвращает ссылку на арену временных буферов текущего потока (nullptr вне ArenaScope)
+inline Arena*& current()
+{
+	static thread_local Arena *arena = nullptr;
+	return arena;
+}
+
+} // namespace arena
+
+/**
+ * ArenaScope - область жизни временных буферов операции
+ *
+ * Делает арену текущей для потока (см. arena::current()) и при выходе из области возвращает
+ * в нее всю память, выделенную внутри области. Области могут быть вложенными.
+ */
+class ArenaScope
+{
+public:
+	explicit ArenaScope(Arena &aArena)
+		: m_Arena(aArena), m_Marker(aArena.mark()), m_Previous(arena::current())
+	{
+		arena::current() = &aArena;
+	}
+
+	~ArenaScope()
+	{
+		m_Arena.rewind(m_Marker);
+		arena::current() = m_Previous;
+	}
+
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+	Arena &m_Arena;
+	Arena::Marker m_Marker;
+	Arena *m_Previous;
+};
+
+#endif // SLD__HAVE_SCRATCH_ARENA
+
+/**
+ * ScratchArray - временный буфер тривиальных объектов
+ *
+ * Если ядро собрано с SLD__HAVE_SCRATCH_ARENA и буфер создается внутри ArenaScope, память
+ * берется из текущей арены потока и возвращается в нее при выходе из области. Иначе память
+ * выделяется обычным sldMemNew() и освобождается в деструкторе.
+ *
+ * Интерфейс повторяет нужную для временных буферов часть DynArray. Буфер нельзя
+ * возвращать из области, внутри которой он создан.
+ */
+template <typename T>
+class ScratchArray
+{
+	static_assert(is_trivial<T>::value, "ScratchArray supports only trivial types.");
+
+public:
+	using value_type = T;
+	using size_type = UInt32;
+
+	ScratchArray() : ptr_(nullptr), size_(0), heap_(false) {}
+
+	explicit ScratchArray(size_type size) : ScratchArray() { resize(size); }
+
+	ScratchArray(default_init_t, size_type size) : ScratchArray() { resize(default_init, size); }
+
+	~ScratchArray() { _free(); }
+
+	ScratchArray(const ScratchArray&) = delete;
+	ScratchArray& operator=(const ScratchArray&) = delete;
+
+	T& operator[](size_type pos)             { return ptr_[pos]; }
+	const T& operator[](size_type pos) const { return ptr_[pos]; }
+	T* data()                                { return ptr_; }
+	const T* data() const                    { return ptr_; }
+
+	bool empty() const     { return size_ == 0; }
+	size_type size() const { return size_; }
+
+	// Перевыделяет буфер под count объектов, заполненных нулями (содержимое не сохраняется)
+	bool resize(size_type count)
+	{
+		if (!resize(default_init, count))
+			return false;
+		if (count)
+			sldMemZero(ptr_, count * sizeof(T));
+		return true;
+	}
+
+	// Перевыделяет буфер под count объектов без инициализации (содержимое не сохраняется)
+	bool resize(default_init_t, size_type count)
+	{
+		_free();
+		if (count == 0 || count > 0xFFFFFFFFU / sizeof(T))
+			return count == 0;
+
+#ifdef SLD__HAVE_SCRATCH_ARENA
+		if (Arena *scratch = arena::current())
+		{
+			ptr_ = scratch->allocate<T>(count);
+			if (!ptr_)
+				return false;
+			size_ = count;
+			SLD_STATISTICS_ADD(ScratchAllocations, 1);
+			SLD_STATISTICS_ADD(ScratchBytes, count * sizeof(T));
+			return true;
+		}
+#endif
+
+		ptr_ = sldMemNew<T>(count);
+		if (!ptr_)
+			return false;
+		size_ = count;
+		heap_ = true;
+		return true;
+	}
+
+	// conversion to sld2::Span
+	operator Span<T>()             { return{ ptr_, size_ }; }
+	operator Span<const T>() const { return{ ptr_, size_ }; }
+
+private:
+	void _free()
+	{
+		if (heap_)
+			sldMemFree(ptr_);
+		ptr_ = nullptr;
+		size_ = 0;
+		heap_ = false;
+	}
+
+	T *ptr_;
+	size_type size_;
+	bool heap_;
+};
+
+} // namespace sld2
+
+#endif // _SLD_ARENA_H_
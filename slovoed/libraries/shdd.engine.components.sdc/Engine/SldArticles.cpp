@@ -2,6 +2,7 @@
 
 #include "SldTools.h"
 #include "SldSerialNumber.h"
+#include "SldStatistics.h"
 
 // initializes a styles array
 static ESldError initStyles(const TDictionaryHeader &aHeader, CSDCReadMy &aReader,
@@ -52,7 +53,7 @@ static ESldError initStyles(const TDictionaryHeader &aHeader, CSDCReadMy &aReade
  * Если aError != eOK объект находится в "неопределенном" состоянии с единственным
  * возможноым (определенным) действием - деструкцией
  */
-CSldArticles::CSldArticles(CSldDictionary &aDict, ISldLayerAccess &aLayerAccess, CSDCReadMy &aData,
+CSldArticles::CSldArticles(const CSldDictionary &aDict, ISldLayerAccess &aLayerAccess, CSDCReadMy &aData,
 						   const TDictionaryHeader &aHeader, ESldError &aError) :
 	m_LayerAccess(aLayerAccess),
 	m_CurrentIndex(-1),
@@ -160,6 +161,7 @@ ESldError CSldArticles::Translate(Int32 aIndex, ESldTranslationFullnesType aFull
 
 	while (m_CurrentIndex < aIndex)
 	{
+		SLD_STATISTICS_ADD(ArticlesSkipped, m_CurrentIndex+1 < aIndex ? 1 : 0);
 		error = GetNextArticle(m_CurrentIndex+1 < aIndex? eTranslationWithoutTranslation : aFullness, aStartBlock, aEndBlock );
 		if (error != eOK)
 			return error;
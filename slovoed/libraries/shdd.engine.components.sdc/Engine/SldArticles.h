@@ -15,7 +15,7 @@ class CSldArticles
 {
 public:
 	// Constructor
-	CSldArticles(CSldDictionary &aDict, ISldLayerAccess &aLayerAccess, CSDCReadMy &aData,
+	CSldArticles(const CSldDictionary &aDict, ISldLayerAccess &aLayerAccess, CSDCReadMy &aData,
 				 const TDictionaryHeader &aHeader, ESldError &aError);
 
 	// Устанавливает указатель на данные, необходимые для системы защиты
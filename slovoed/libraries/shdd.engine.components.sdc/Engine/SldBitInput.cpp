@@ -1,5 +1,7 @@
 ﻿#include "SldBitInput.h"
 
+#include "SldStatistics.h"
+
 /** ********************************************************************
 * Инициализация 
 *
@@ -16,6 +18,8 @@ ESldError CSldBitInput::Init(CSDCReadMy &aData, UInt32 aDataType, UInt32 aBlockS
 	m_DataType = aDataType;
 	m_BlockSize = aBlockSize;
 	m_CurrentDataIndex = MAX_UINT_VALUE;
+	m_SequentialCount = 0;
+	m_PrefetchEnd = 0;
 
 	if (!m_CurrentData.resize(sld2::default_init, sld2::div_round_up(m_BlockSize, sizeof(UInt32))))
 		return eMemoryNotEnoughMemory;
@@ -50,6 +54,7 @@ ESldError CSldBitInput::GetBit(UInt32 *aBit)
 		m_BitBuffer = m_CurrentData[m_Shift++];
 	}
 
+	SLD_STATISTICS_ADD(BitsDecoded, 1);
 	*aBit = m_BitBuffer & 1;
 	m_Bit--;
 	m_BitBuffer>>=1;
@@ -77,6 +82,8 @@ ESldError CSldBitInput::GetData(UInt32 *aDataBuffer, UInt32 aDataSize)
 			m_Shift = 0;
 			m_ShiftBit = 0;
 			m_CurrentDataIndex++;
+
+			OnDataLoaded(true);
 		}
 
 		if (m_ShiftBit > m_Bit)
@@ -101,6 +108,7 @@ ESldError CSldBitInput::GetData(UInt32 *aDataBuffer, UInt32 aDataSize)
 			return GetData(aDataBuffer, aDataSize);
 	}
 
+	SLD_STATISTICS_ADD(BitsDecoded, aDataSize);
 	*aDataBuffer = m_BitBuffer&((1<<aDataSize)-1);
 	m_BitBuffer>>=aDataSize;
 	m_Bit-=aDataSize;
@@ -120,16 +128,9 @@ ESldError CSldBitInput::GoTo(UInt32 aPosition)
 	ESldError error;
 	
 	// Индекс необходимого ресурса с данными
-	UInt32 NewDataIndex = aPosition/(m_BlockSize*8);
-
-	if (NewDataIndex != m_CurrentDataIndex)
-	{		
-		m_CurrentDataIndex = NewDataIndex;
-		
-		error = m_data->GetResourceData(m_CurrentData.data(), m_DataType, m_CurrentDataIndex, m_BlockSize);
-		if (error != eOK)
-			return error;
-	}
+	error = SetDataIndex(aPosition/(m_BlockSize*8));
+	if (error != eOK)
+		return error;
 
 	m_Shift = (aPosition % (m_BlockSize*8))/OUT_BIT_COUNT;
 
@@ -146,6 +147,79 @@ ESldError CSldBitInput::GoTo(UInt32 aPosition)
 	return eOK;
 }
 
+/** ********************************************************************
+* Получаем из входного потока подряд идущие байты, начиная с указанной позиции
+*
+* Байты копируются напрямую из ресурсов, без побитового чтения. После вызова
+* позиция чтения находится сразу за последним считанным байтом
+*
+* @param[in]	aPosition	- позиция первого байта в БИТАХ, должна быть кратна 8
+* @param[out]	aBuffer		- буфер, в который копируются байты
+* @param[in]	aCount		- количество байт
+*
+* @return error code
+************************************************************************/
+ESldError CSldBitInput::GetBytes(UInt32 aPosition, UInt8 *aBuffer, UInt32 aCount)
+{
+	if (!aBuffer)
+		return eMemoryNullPointer;
+
+	if (aPosition % 8)
+		return eCommonWrongShiftSize;
+
+	if (!aCount)
+		return GoTo(aPosition);
+
+	ESldError error;
+	UInt32 bytePosition = aPosition / 8;
+	for (UInt32 count = aCount; count;)
+	{
+		error = SetDataIndex(bytePosition / m_BlockSize);
+		if (error != eOK)
+			return error;
+
+		const UInt32 shift = bytePosition % m_BlockSize;
+		const UInt32 size = sld2::min(count, m_BlockSize - shift);
+		for (UInt32 i = shift; i < shift + size; i++)
+			*aBuffer++ = (UInt8)(m_CurrentData[i / 4] >> ((i % 4) * 8));
+
+		bytePosition += size;
+		count -= size;
+	}
+
+	// Последний байт дочитываем обычным образом, чтобы позиция чтения оказалась сразу за ним
+	UInt32 lastByte;
+	error = GoTo(aPosition + (aCount - 1) * 8);
+	if (error != eOK)
+		return error;
+
+	return GetData(&lastByte, 8);
+}
+
+/** ********************************************************************
+* Делает текущим ресурс с указанным номером (при необходимости считывает его)
+*
+* @param[in]	aDataIndex	- номер ресурса
+*
+* @return error code
+************************************************************************/
+ESldError CSldBitInput::SetDataIndex(UInt32 aDataIndex)
+{
+	if (aDataIndex == m_CurrentDataIndex)
+		return eOK;
+
+	const bool isSequential = m_CurrentDataIndex != MAX_UINT_VALUE && aDataIndex == m_CurrentDataIndex + 1;
+	m_CurrentDataIndex = aDataIndex;
+
+	ESldError error = m_data->GetResourceData(m_CurrentData.data(), m_DataType, m_CurrentDataIndex, m_BlockSize);
+	if (error != eOK)
+		return error;
+
+	OnDataLoaded(isSequential);
+
+	return eOK;
+}
+
 /** ********************************************************************
 * Возвращает текущее положение в битах.
 *
@@ -158,4 +232,36 @@ UInt32 CSldBitInput::GetCurrentPosition()
 	pos -= m_Bit;
 	pos += (m_CurrentDataIndex * m_BlockSize * 8);
 	return pos;
-}
\ No newline at end of file
+}
+
+/** ********************************************************************
+* Отслеживает последовательное чтение ресурсов
+*
+* Если несколько ресурсов подряд были считаны друг за другом (полный перебор
+* списка слов при поиске), заранее сообщает файлу контейнера о следующих
+* ресурсах, чтобы их чтение шло параллельно с декодированием текущих.
+* Следующая порция запрашивается, когда прочитана половина предыдущей
+*
+* @param[in]	aSequential	- true, если только что считанный ресурс следует
+*							  сразу за предыдущим
+************************************************************************/
+void CSldBitInput::OnDataLoaded(bool aSequential)
+{
+	if (!aSequential)
+	{
+		m_SequentialCount = 0;
+		m_PrefetchEnd = 0;
+		return;
+	}
+
+	if (++m_SequentialCount < BIT_INPUT_READAHEAD_TRIGGER)
+		return;
+
+	const UInt32 nextIndex = m_CurrentDataIndex + 1;
+	if (nextIndex + BIT_INPUT_READAHEAD_BLOCKS / 2 < m_PrefetchEnd)
+		return;
+
+	const UInt32 firstIndex = (sld2::max)(nextIndex, m_PrefetchEnd);
+	m_PrefetchEnd = nextIndex + BIT_INPUT_READAHEAD_BLOCKS;
+	m_data->PrefetchResources(m_DataType, firstIndex, m_PrefetchEnd - firstIndex);
+}
@@ -8,6 +8,11 @@
 // Количество бит на единицу хранения данных.
 #define OUT_BIT_COUNT	(32)
 
+// Количество ресурсов подряд, после последовательного чтения которых включается упреждающее чтение
+#define BIT_INPUT_READAHEAD_TRIGGER	(2)
+// Количество ресурсов, которые запрашиваются заранее при последовательном чтении
+#define BIT_INPUT_READAHEAD_BLOCKS	(8)
+
 // Класс предназначенный для бинарного чтения данных
 /** ********************************************************************
 *	Класс предназначенный для бинарного чтения данных
@@ -27,7 +32,9 @@ public:
 		m_Bit(0),
 		m_BitBuffer(0),
 		m_Shift(0),
-		m_ShiftBit(0)
+		m_ShiftBit(0),
+		m_SequentialCount(0),
+		m_PrefetchEnd(0)
 		{}
 
 	// Initialization
@@ -43,11 +50,20 @@ public:
 	// Получаем  из входного потока слово нужной разрядности(1-32)
 	ESldError GetData(UInt32 *aDataBuffer, UInt32 aDataSize);
 
+	// Получаем из входного потока подряд идущие байты, начиная с указанной позиции
+	ESldError GetBytes(UInt32 aPosition, UInt8 *aBuffer, UInt32 aCount);
+
 	// Возвращает текущее положение в битах.
 	UInt32 GetCurrentPosition();
 
 
 private:
+	// Делает текущим ресурс с указанным номером (при необходимости считывает его)
+	ESldError SetDataIndex(UInt32 aDataIndex);
+
+	// Отслеживает последовательное чтение ресурсов и заранее запрашивает следующие
+	void OnDataLoaded(bool aSequential);
+
 	// Указатель на класс блочного чтения.
 	CSDCReadMy		*m_data;
 
@@ -70,6 +86,11 @@ private:
 	// Количество бит которые были использованы из текущего элемента массива считанных данных.
 	UInt32			m_ShiftBit;
 
+	// Количество ресурсов, считанных подряд друг за другом
+	UInt32			m_SequentialCount;
+	// Номер первого ресурса после уже запрошенных заранее
+	UInt32			m_PrefetchEnd;
+
 };
 
 #endif
@@ -10,9 +10,8 @@
 #include "SldTools.h"
 #include "SldUtil.h"
 
-CSldCSSDataManager::CSldCSSDataManager(CSldDictionary &aDict, CSDCReadMy &aReader,
-									   const CSDCReadMy::Resource &aHeaderResource, ESldError &aError)
-	: m_dictionary(aDict), m_reader(aReader), m_resourceHeaderSize(0), m_propsIndexBits(0)
+CSldCSSDataManager::CSldCSSDataManager(CSDCReadMy &aReader, const CSDCReadMy::Resource &aHeaderResource, ESldError &aError)
+	: m_reader(aReader), m_resourceHeaderSize(0), m_propsIndexBits(0)
 {
 #define error_out(_err) do { aError = _err; return; } while(0)
 
@@ -370,7 +369,7 @@ static ESldError toString(Context &ctx, const TSldCSSProperty &aProp, SldU16Stri
 } // anon namespace
 
 // Выдает строку css параметров по глобальному индексу блока
-ESldError CSldCSSDataManager::GetCSSStyleString(UInt32 aIndex, SldU16String *aString, CSldCSSUrlResolver *aResolver)
+ESldError CSldCSSDataManager::GetCSSStyleString(UInt32 aIndex, SldU16String *aString, CSldCSSUrlResolver *aResolver, CSldDictionary &aDict)
 {
 	if (!aString || !aResolver)
 		return eMemoryNullPointer;
@@ -382,7 +381,7 @@ ESldError CSldCSSDataManager::GetCSSStyleString(UInt32 aIndex, SldU16String *aSt
 	if (error != eOK)
 		return error;
 
-	Context ctx(*aResolver, m_dictionary, m_strings.get());
+	Context ctx(*aResolver, aDict, m_strings.get());
 
 	for (UInt32 i = 0; i < block->count; i++)
 	{
@@ -43,8 +43,7 @@ public:
 class CSldCSSDataManager
 {
 public:
-	CSldCSSDataManager(CSldDictionary &aDict, CSDCReadMy &aReader,
-					   const CSDCReadMy::Resource &aHeaderResource, ESldError &aError);
+	CSldCSSDataManager(CSDCReadMy &aReader, const CSDCReadMy::Resource &aHeaderResource, ESldError &aError);
 
 	/**
 	 *  Выдает строку css параметров по глобальному индексу блока
@@ -52,13 +51,14 @@ public:
 	 *  @param [in] aIndex     - индекс блока css параметров
 	 *  @param [in] aString    - указатель куда будет записана строка параметров
 	 *  @param [in] aResolver  - указатель на объект "резолвящий" ссылки на внутренние ресурсы в url'ы
+	 *  @param [in] aDict      - словарь, из списка слов которого берутся строки (если в базе нет string store)
 	 *
 	 *  @return error code
 	 *  ВАЖНО:
 	 *   необходимо проверять длину полученой строки
 	 *   функция может вернуть eOK и при этом выдать пустую строку, это "нормально"
 	 */
-	ESldError GetCSSStyleString(UInt32 aIndex, SldU16String *aString, CSldCSSUrlResolver *aResolver);
+	ESldError GetCSSStyleString(UInt32 aIndex, SldU16String *aString, CSldCSSUrlResolver *aResolver, CSldDictionary &aDict);
 
 private:
 
@@ -68,9 +68,6 @@ private:
 	// loads a single css property
 	ESldError LoadCSSProperty(UInt32 aIndex, const TSldCSSProperty **aProperty);
 
-	// backref to the dictionary for strings
-	CSldDictionary &m_dictionary;
-
 	//
 	CSDCReadMy &m_reader;
 
@@ -106,12 +106,14 @@ static inline const THierarchyElement* GetElement(const CSDCReadMy::Resource &aR
 /** ********************************************************************
 * Производим инициализацию класса доступа к каталогу
 *
-* @param[in]	aData			- 
-* @param[in]	aCatalogType	- 
+* @param[in]	aData				- 
+* @param[in]	aCatalogType		- 
+* @param[in]	aLevelParentsType	- тип ресурса с таблицей родителей уровней иерархии,
+*									  0 - таблицы нет
 *
 * @return error code
 ************************************************************************/
-ESldError CSldCatalog::Init(CSDCReadMy &aData, UInt32 aCatalogType)
+ESldError CSldCatalog::Init(CSDCReadMy &aData, UInt32 aCatalogType, UInt32 aLevelParentsType)
 {
 	if (!aCatalogType)
 		return eCommonWrongCatalogType;
@@ -130,6 +132,22 @@ ESldError CSldCatalog::Init(CSDCReadMy &aData, UInt32 aCatalogType)
 
 	m_EngineVersion = tmpDictHeader->Version;
 
+	if (aLevelParentsType)
+	{
+		auto parents = m_data->GetResource(aLevelParentsType, 0);
+		if (parents != eOK)
+			return parents.error();
+
+		// Хотя бы один уровень и терминальный элемент
+		if (parents.size() < 2 * sizeof(THierarchyLevelParent) || parents.size() % sizeof(THierarchyLevelParent))
+			return eInputWrongStructSize;
+		if (((const THierarchyLevelParent*)parents.ptr())->LevelStart != 0)
+			return eCommonCatalogSearchError;
+
+		m_LevelParents = parents.resource();
+		m_LevelParentsCount = parents.size() / sizeof(THierarchyLevelParent) - 1;
+	}
+
 	return GoToByShift(0);
 }
 
@@ -420,6 +438,14 @@ ESldError CSldCatalog::GoToByShift(UInt32 aShift)
 ESldError CSldCatalog::GetPathByGlobalIndex(UInt32 aIndex, TCatalogPath *aPath)
 {
 	ESldError error;
+
+	if (!aPath)
+		return eMemoryNullPointer;
+
+	// Если есть таблица родителей уровней - ресурсы иерархии не нужны
+	const THierarchyLevelParent *levels = (const THierarchyLevelParent*)m_LevelParents.ptr();
+	if (levels && aIndex < levels[m_LevelParentsCount].LevelStart)
+		return GetPathByLevelParents(aIndex, aPath);
 	
 	// Сохраняем текущее состояние
 	THierarchyLevelHeader tmpLevelHeader = m_LevelHeader;
@@ -430,9 +456,6 @@ ESldError CSldCatalog::GetPathByGlobalIndex(UInt32 aIndex, TCatalogPath *aPath)
 	
 	const THierarchyElement *element;
 
-	if (!aPath)
-		return eMemoryNullPointer;
-
 	aPath->Clear();
 
 	// Перемещаемся в начало и начинаем искать нужный нам элемент
@@ -534,6 +557,49 @@ ESldError CSldCatalog::GetPathByGlobalIndex(UInt32 aIndex, TCatalogPath *aPath)
 	return eOK;
 }
 
+/** ********************************************************************
+* Возвращает путь в каталоге к элементу с глобальным номером по таблице
+* родителей уровней: находит уровень, содержащий слово, и поднимается по
+* родителям до корня. Текущее состояние каталога не меняется.
+*
+* @param[in]	aIndex	- номер слова без учета иерархии, меньше количества слов в списке
+* @param[out]	aPath	- указатель на структуру, в которую будет прописан путь к 
+*						  указанному элементу списка слов
+*
+* @return error code
+************************************************************************/
+ESldError CSldCatalog::GetPathByLevelParents(UInt32 aIndex, TCatalogPath *aPath)
+{
+	const THierarchyLevelParent *levels = (const THierarchyLevelParent*)m_LevelParents.ptr();
+
+	// Уровни идут подряд, поэтому слово лежит в последнем уровне, который начинается не позже него
+	UInt32 level = sld2::lower_bound(levels, m_LevelParentsCount, [aIndex](const THierarchyLevelParent &aLevel) {
+		return aLevel.LevelStart <= aIndex;
+	}) - 1;
+
+	m_PathBuffer.clear();
+	m_PathBuffer.push_back(aIndex - levels[level].LevelStart);
+	while (levels[level].ParentLevel != MAX_UINT_VALUE)
+	{
+		// Родитель всегда расположен раньше потомка, иначе таблица испорчена и мы бы зациклились
+		if (levels[level].ParentLevel >= level)
+			return eCommonCatalogSearchError;
+
+		m_PathBuffer.push_back(levels[level].ParentWordIndex);
+		level = levels[level].ParentLevel;
+	}
+
+	aPath->Clear();
+	for (UInt32 i = m_PathBuffer.size(); i > 0; i--)
+	{
+		ESldError error = aPath->PushList(m_PathBuffer[i - 1]);
+		if (error != eOK)
+			return error;
+	}
+
+	return eOK;
+}
+
 /** ********************************************************************
 * Возвращает индекс ресурса для запрашиваемого элемента
 * Используется только для случаев когда уровень не помещается полностью в один ресурс
@@ -47,7 +47,8 @@ public:
 	CSldCatalog(void):
 		m_data(NULL),
 		m_CatalogType(0),
-		m_CurrentResource(MAX_UINT_VALUE)
+		m_CurrentResource(MAX_UINT_VALUE),
+		m_LevelParentsCount(0)
 		{
 			sldMemZero(&m_LevelHeader, sizeof(m_LevelHeader));
 		};
@@ -57,7 +58,7 @@ public:
 	CSldCatalog& operator=(const CSldCatalog &aOld) = delete;
 
 	// Производим инициализацию класса доступа к каталогу
-	ESldError Init(CSDCReadMy &aData, UInt32 aCatalogType);
+	ESldError Init(CSDCReadMy &aData, UInt32 aCatalogType, UInt32 aLevelParentsType = 0);
 
 	// Возвращает количество слов имеющихся в текущем уровне иерархии
 	// (не включая подуровни). 
@@ -91,6 +92,9 @@ private:
 	// Возвращает указатель на запрашиваемый элемент
 	ESldError GetElementPtr(UInt32 aIndex, const THierarchyElement **aElement);
 
+	// Возвращает путь к элементу по таблице родителей уровней
+	ESldError GetPathByLevelParents(UInt32 aIndex, TCatalogPath *aPath);
+
 	// Возвращает индекс ресурса для запрашиваемого элемента (в случае уровней не влезающих в один ресурс)
 	ESldError FindResourceIndexCached(UInt32 aIndex, UInt32 *aResourceIndex);
 
@@ -133,6 +137,15 @@ private:
 
 	// Кэш индексов ресурсов
 	TResourceCache			m_resourceCache;
+
+	// Ресурс с таблицей родителей уровней иерархии (может отсутствовать в старых базах)
+	CSDCReadMy::Resource	m_LevelParents;
+
+	// Количество уровней в таблице родителей (без терминального элемента)
+	UInt32					m_LevelParentsCount;
+
+	// Буфер для сборки пути по таблице родителей
+	CSldVector<UInt32>		m_PathBuffer;
 };
 
 #endif
\ No newline at end of file
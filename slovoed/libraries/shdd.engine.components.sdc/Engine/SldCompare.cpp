@@ -2,6 +2,7 @@
 
 #include "SldUnicode.h"
 #include "SldStack.h"
+#include "SldStatistics.h"
 
 // Unicode support based on SldUnicode.h
 namespace {
@@ -1056,6 +1057,8 @@ ESldError CSldCompare::ToLowerStr(const UInt16* aStr, UInt16* aOutStr) const
 ************************************************************************/
 Int32 CSldCompare::StrICmp(const UInt16 *str1, const UInt16 *str2, UInt32 aTableIndex) const
 {
+	SLD_STATISTICS_ADD(StrICmpCalls, 1);
+
 	UInt16 mass1[CMP_CHAIN_LEN + 1] = {0};
 	UInt16 mass2[CMP_CHAIN_LEN + 1] = {0};
 	UInt16 *cmp1=mass1, *cmp2=mass2;
@@ -1216,6 +1219,8 @@ static UInt16 GetComplex(const UInt16 *str, const UInt32 len, UInt16 index, UInt
  */
 Int32 CSldCompare::StrICmp(SldU16StringRef aStr1, SldU16StringRef aStr2, UInt32 aTableIndex) const
 {
+	SLD_STATISTICS_ADD(StrICmpCalls, 1);
+
 	if (aTableIndex >= m_CMPTable.size())
 		return aStr1.compare(aStr2);
 
@@ -1344,6 +1349,222 @@ Int32 CSldCompare::StrICmp(SldU16StringRef aStr1, SldU16StringRef aStr2) const
 	return StrICmp(aStr1, aStr2, m_DefaultTable);
 }
 
+// Дописывает к ключу сортировки 2 байта числа, начиная со старшего
+static inline void AppendSortKeyBytes(CSldVector<UInt8> &aKey, UInt16 aValue)
+{
+	aKey.push_back((UInt8)(aValue >> 8));
+	aKey.push_back((UInt8)(aValue & 0xFF));
+}
+
+/**
+ * Дописывает ключ сортировки строки
+ *
+ * Ключ состоит из тех же весов, которые сравнивает StrICmp, по 2 байта на вес начиная со старшего.
+ * Нулевой вес (его может дать только сложный символ) записывается как 00 00 01, поэтому веса можно
+ * отделить от следующей части ключа байтами 00 00 00, которые меньше любого веса.
+ * Для уровня eSortKeyMassAndCode после весов и разделителя идут коды символов строки.
+ * Без таблицы сравнения ключ состоит из кодов символов, как и сравнение в StrICmp.
+ *
+ * @param[in]  aText       - строка
+ * @param[in]  aLevel      - уровень ключа
+ * @param[in]  aTableIndex - номер таблицы сравнения
+ * @param[out] aKey        - вектор, к которому дописывается ключ
+ */
+void CSldCompare::AppendSortKey(SldU16StringRef aText, ESldSortKeyLevel aLevel, UInt32 aTableIndex, CSldVector<UInt8> &aKey) const
+{
+	if (aTableIndex < m_CMPTable.size())
+	{
+		UInt16 mass[CMP_CHAIN_LEN + 1] = { 0 };
+		UInt16 *cmp = mass;
+
+		const CMPHeaderType *header = m_CMPTable[aTableIndex].Header;
+		const UInt16 *simple = m_CMPTable[aTableIndex].SimpleMassTable.data();
+		const CMPComplexType *complex = m_CMPTable[aTableIndex].Complex;
+		const UInt16 EOL = header->EOL;
+
+		const UInt16 *str = aText.begin();
+		const UInt16 *strend = aText.end();
+
+		// Веса выбираются из строки точно так же, как в StrICmp
+		while ((str < strend && *str != EOL) || *(cmp + 1))
+		{
+			UInt16 last_char_mass = CMP_IGNORE_SYMBOL;
+
+			// Пропускаем все игнорируемые символы.
+			while (str < strend && (last_char_mass = GetMass(*str, simple, CMP_IGNORE_SYMBOL)) == CMP_IGNORE_SYMBOL)
+				str++;
+
+			// Проверяем, не закончилась ли строка
+			if (!((str < strend && *str != EOL) || *(cmp + 1)))
+				break;
+
+			if (!*(cmp + 1))
+			{
+				if (last_char_mass & CMP_MASK_OF_INDEX_FLAG)
+				{
+					str += ::GetComplex(str, strend - str, last_char_mass & CMP_MASK_OF_INDEX, mass, complex);
+					cmp = mass;
+				}
+				else
+				{
+					*cmp = last_char_mass;
+					str++;
+				}
+			}
+			else
+			{
+				cmp++;
+			}
+
+			if (*cmp)
+			{
+				AppendSortKeyBytes(aKey, *cmp);
+			}
+			else
+			{
+				aKey.push_back(0);
+				aKey.push_back(0);
+				aKey.push_back(1);
+			}
+		}
+
+		if (aLevel != eSortKeyMassAndCode)
+			return;
+
+		aKey.push_back(0);
+		aKey.push_back(0);
+		aKey.push_back(0);
+	}
+
+	for (UInt16 ch : aText)
+		AppendSortKeyBytes(aKey, ch);
+}
+
+/**
+ * Формирует ключ сортировки строки по таблице сравнения с заданным номером
+ *
+ * Побайтное сравнение ключей (см. CompareSortKeys) дает тот же результат, что и сравнение
+ * самих строк: StrICmp для уровня eSortKeyMass, StrICmp и затем StrCmp для eSortKeyMassAndCode
+ *
+ * @param[in]  aText       - строка
+ * @param[in]  aLevel      - уровень ключа
+ * @param[in]  aTableIndex - номер таблицы сравнения
+ * @param[out] aKey        - ключ сортировки
+ */
+void CSldCompare::MakeSortKey(SldU16StringRef aText, ESldSortKeyLevel aLevel, UInt32 aTableIndex, CSldVector<UInt8> &aKey) const
+{
+	aKey.clear();
+	AppendSortKey(aText, aLevel, aTableIndex, aKey);
+}
+
+/**
+ * Формирует ключ сортировки строки по таблице сравнения по умолчанию
+ *
+ * @param[in]  aText  - строка
+ * @param[in]  aLevel - уровень ключа
+ * @param[out] aKey   - ключ сортировки
+ */
+void CSldCompare::MakeSortKey(SldU16StringRef aText, ESldSortKeyLevel aLevel, CSldVector<UInt8> &aKey) const
+{
+	MakeSortKey(aText, aLevel, m_DefaultTable, aKey);
+}
+
+/**
+ * Побайтное сравнение 2 ключей сортировки
+ *
+ * @param[in] aKey1  - первый ключ
+ * @param[in] aSize1 - размер первого ключа
+ * @param[in] aKey2  - второй ключ
+ * @param[in] aSize2 - размер второго ключа
+ *
+ * @return  0 - ключи равны
+ *          1 - первый ключ больше второго
+ *         -1 - первый ключ меньше второго
+ */
+Int32 CSldCompare::CompareSortKeys(const UInt8 *aKey1, UInt32 aSize1, const UInt8 *aKey2, UInt32 aSize2)
+{
+	const UInt32 size = aSize1 < aSize2 ? aSize1 : aSize2;
+	for (UInt32 i = 0; i < size; i++)
+	{
+		if (aKey1[i] != aKey2[i])
+			return aKey1[i] < aKey2[i] ? -1 : 1;
+	}
+	return aSize1 == aSize2 ? 0 : aSize1 < aSize2 ? -1 : 1;
+}
+
+/// Удаляет все ключи
+void CSldSortKeys::Clear()
+{
+	m_Data.clear();
+	m_Ends.clear();
+}
+
+/**
+ * Резервирует память под ключи
+ *
+ * @param[in] aCount      - количество ключей
+ * @param[in] aTextLength - суммарная длина строк, по которым будут построены ключи
+ */
+void CSldSortKeys::Reserve(UInt32 aCount, UInt32 aTextLength)
+{
+	m_Ends.reserve(aCount);
+	// Обычно на символ приходится один вес
+	m_Data.reserve(aTextLength * 2);
+}
+
+/**
+ * Добавляет ключ сортировки строки по таблице сравнения с заданным номером
+ *
+ * @param[in] aCMP        - класс сравнения строк
+ * @param[in] aText       - строка
+ * @param[in] aLevel      - уровень ключа
+ * @param[in] aTableIndex - номер таблицы сравнения
+ */
+void CSldSortKeys::Add(const CSldCompare &aCMP, SldU16StringRef aText, ESldSortKeyLevel aLevel, UInt32 aTableIndex)
+{
+	aCMP.AppendSortKey(aText, aLevel, aTableIndex, m_Data);
+	m_Ends.push_back(m_Data.size());
+}
+
+/**
+ * Добавляет ключ сортировки строки по таблице сравнения по умолчанию
+ *
+ * @param[in] aCMP   - класс сравнения строк
+ * @param[in] aText  - строка
+ * @param[in] aLevel - уровень ключа
+ */
+void CSldSortKeys::Add(const CSldCompare &aCMP, SldU16StringRef aText, ESldSortKeyLevel aLevel)
+{
+	Add(aCMP, aText, aLevel, aCMP.m_DefaultTable);
+}
+
+/**
+ * Сравнивает ключи
+ *
+ * @param[in] aIndex1 - номер первого ключа
+ * @param[in] aIndex2 - номер второго ключа
+ *
+ * @return  0 - ключи равны
+ *          1 - первый ключ больше второго
+ *         -1 - первый ключ меньше второго
+ */
+Int32 CSldSortKeys::Compare(UInt32 aIndex1, UInt32 aIndex2) const
+{
+	return CSldCompare::CompareSortKeys(Begin(aIndex1), Size(aIndex1), Begin(aIndex2), Size(aIndex2));
+}
+
+/**
+ * Сортирует номера ключей по возрастанию ключей, номера равных ключей остаются по возрастанию
+ *
+ * @param[in,out] aIndexes - номера ключей
+ */
+void CSldSortKeys::Sort(sld2::Span<Int32> aIndexes) const
+{
+	sld2::sort_indexes(aIndexes.data(), aIndexes.size(), [this](Int32 aIndex1, Int32 aIndex2) {
+		return Compare(aIndex1, aIndex2);
+	});
+}
+
 /** ********************************************************************
 * Возвращает массу переданного символа
 * @param	aChr			- символ, массу которого нужно определить
@@ -2270,6 +2491,245 @@ UInt32 CSldCompare::WildCompare(const UInt16* aWildCard, const UInt16* aText) co
 	return 0;
 }
 
+// Возвращает бит сигнатуры для последовательности масс
+static inline UInt64 WildCardSignatureBit(UInt16 aMass0, UInt16 aMass1 = 0, UInt16 aMass2 = 0)
+{
+	UInt32 hash = aMass0;
+	hash = hash * 0x9E3779B1 + aMass1;
+	hash = hash * 0x9E3779B1 + aMass2;
+	hash *= 0x9E3779B1;
+	return (UInt64)1 << (hash >> 26);
+}
+
+/** *********************************************************************
+* Добавляет строчку масс к сигнатуре для поиска по шаблону
+*
+* В сигнатуру попадают триграммы масс в пределах слов строчки и первые одна и две массы
+* каждого слова (именно с начала слов WildCompare() пытается сопоставить шаблон).
+* Нулевые символы при этом пропускаются, так же как это делает DoWildCompare()
+*
+* @param[in]	aMassStr	- строчка масс с разделителями (см. GetStrOfMassWithDelimiters())
+* @param[out]	aSignature	- сигнатура, в которую добавляются биты строчки
+************************************************************************/
+void CSldCompare::AddWildCardSignature(const UInt16* aMassStr, TSldWildCardSignature &aSignature)
+{
+	if (!aMassStr)
+		return;
+
+	UInt16 prev2 = 0;
+	UInt16 prev1 = 0;
+	UInt32 posInWord = 0;
+	for (; *aMassStr; aMassStr++)
+	{
+		const UInt16 mass = *aMassStr;
+		if (mass == CMP_MASS_ZERO)
+			continue;
+
+		if (mass == CMP_MASS_DELIMITER)
+		{
+			posInWord = 0;
+			continue;
+		}
+
+		if (posInWord == 0)
+			aSignature.Heads |= WildCardSignatureBit(mass);
+		else if (posInWord == 1)
+			aSignature.Heads |= WildCardSignatureBit(prev1, mass);
+		else
+			aSignature.Grams |= WildCardSignatureBit(prev2, prev1, mass);
+
+		prev2 = prev1;
+		prev1 = mass;
+		posInWord++;
+	}
+}
+
+/** *********************************************************************
+* Возвращает сигнатуру, которую должна содержать любая строчка, подходящая под шаблон
+*
+* Непрерывные участки шаблона без спец. символов сопоставляются с непрерывными участками
+* слова, поэтому их триграммы обязаны присутствовать в сигнатуре слова
+*
+* @param[in]	aWildCard	- строка масс шаблона (см. GetSearchPatternOfMass())
+*
+* @return сигнатура шаблона
+************************************************************************/
+TSldWildCardSignature CSldCompare::GetWildCardPatternSignature(const UInt16* aWildCard)
+{
+	TSldWildCardSignature signature = { 0, 0 };
+	if (!aWildCard)
+		return signature;
+
+	UInt16 prev2 = 0;
+	UInt16 prev1 = 0;
+	UInt32 runLength = 0;
+	bool isHead = true;
+	for (; *aWildCard; aWildCard++)
+	{
+		const UInt16 mass = *aWildCard;
+		if (mass == CMP_MASS_SPECIAL_SYMBOL_ANY_CHARS || mass == CMP_MASS_SPECIAL_SYMBOL_ONE_CHAR ||
+			mass == CMP_MASS_ZERO || mass == CMP_MASS_DELIMITER)
+		{
+			runLength = 0;
+			isHead = false;
+			continue;
+		}
+
+		if (isHead && runLength == 0)
+			signature.Heads |= WildCardSignatureBit(mass);
+		else if (isHead && runLength == 1)
+			signature.Heads |= WildCardSignatureBit(prev1, mass);
+
+		if (runLength >= 2)
+			signature.Grams |= WildCardSignatureBit(prev2, prev1, mass);
+
+		prev2 = prev1;
+		prev1 = mass;
+		runLength++;
+	}
+
+	return signature;
+}
+
+/** *********************************************************************
+* Компилирует шаблон поиска
+*
+* Состояние автомата - позиция в шаблоне и признак активности режима "любые символы"
+* (так же как у DoWildCompare()), каждой позиции соответствует бит маски.
+* Шаблоны длиннее MaxLength не компилируются, для них используется WildCompare()
+*
+* @param[in]	aCMP		- класс сравнения строк, которым был получен шаблон
+* @param[in]	aWildCard	- строка масс шаблона (см. CSldCompare::GetSearchPatternOfMass())
+************************************************************************/
+void CSldWildCardPattern::Compile(const CSldCompare &aCMP, const UInt16* aWildCard)
+{
+	m_CMP = &aCMP;
+	m_WildCard = aWildCard ? aWildCard : SldU16StringLiteral("");
+	m_Compiled = false;
+
+	const UInt32 length = m_WildCard.length();
+	if (length > MaxLength)
+		return;
+
+	sldMemZero(m_Masses, sizeof(m_Masses));
+	sldMemZero(m_MassMasks, sizeof(m_MassMasks));
+	m_AnyChars = 0;
+	m_OneChar = 0;
+	m_EndBit = (UInt64)1 << length;
+
+	for (UInt32 pos = 0; pos < length; pos++)
+	{
+		const UInt16 mass = m_WildCard[pos];
+		const UInt64 bit = (UInt64)1 << pos;
+
+		// Спец. символы тоже попадают в таблицу: DoWildCompare() сначала сравнивает символы на равенство
+		UInt32 slot = ((UInt32)mass * 0x9E3779B1) >> 25;
+		while (m_Masses[slot] && m_Masses[slot] != mass)
+			slot = (slot + 1) & (MassTableSize - 1);
+		m_Masses[slot] = mass;
+		m_MassMasks[slot] |= bit;
+
+		if (mass == CMP_MASS_SPECIAL_SYMBOL_ANY_CHARS)
+			m_AnyChars |= bit;
+		else if (mass == CMP_MASS_SPECIAL_SYMBOL_ONE_CHAR)
+			m_OneChar |= bit;
+	}
+
+	m_EmptyTail = m_EndBit;
+	m_EmptyTailAny = m_EndBit;
+	for (UInt32 pos = length; pos--;)
+	{
+		const UInt64 bit = (UInt64)1 << pos;
+		if ((m_AnyChars & bit) && (m_EmptyTail & (bit << 1)))
+			m_EmptyTail |= bit;
+		if (((m_AnyChars | m_OneChar) & bit) && (m_EmptyTailAny & (bit << 1)))
+			m_EmptyTailAny |= bit;
+	}
+
+	m_Compiled = true;
+}
+
+/** *********************************************************************
+* Возвращает маску позиций шаблона, в которых находится заданная масса
+*
+* @param[in]	aMass	- масса символа
+*
+* @return маска позиций
+************************************************************************/
+UInt64 CSldWildCardPattern::GetMassMask(UInt16 aMass) const
+{
+	UInt32 slot = ((UInt32)aMass * 0x9E3779B1) >> 25;
+	while (m_Masses[slot])
+	{
+		if (m_Masses[slot] == aMass)
+			return m_MassMasks[slot];
+		slot = (slot + 1) & (MassTableSize - 1);
+	}
+	return 0;
+}
+
+/** *********************************************************************
+* Проверяет строчку масс на соответствие шаблону
+*
+* Автомат запускается с начала строчки и после каждой группы разделителей,
+* как это делает WildCompare(). Все ветви перебора DoWildCompare() обрабатываются
+* одновременно, поэтому строчка просматривается один раз
+*
+* @param[in]	aText	- строчка масс с разделителями (см. CSldCompare::GetStrOfMassWithDelimiters())
+*
+* @return	0 - строчка не соответствует шаблону
+*			1 - строчка соответствует шаблону
+************************************************************************/
+UInt32 CSldWildCardPattern::Match(const UInt16* aText) const
+{
+	if (!m_Compiled)
+		return m_CMP ? m_CMP->WildCompare(m_WildCard.c_str(), aText) : 0;
+
+	if (!aText)
+		return 0;
+
+	// Достигнутые позиции шаблона с неактивным и активным режимом "любые символы"
+	UInt64 positions = 0;
+	UInt64 anyPositions = 0;
+	// Сравнение начинается с начала строчки и с первого символа после каждой группы разделителей
+	bool isStringStart = true;
+	bool afterDelimiter = false;
+	for (; *aText; aText++)
+	{
+		const UInt16 mass = *aText;
+		if (isStringStart || (afterDelimiter && mass != CMP_MASS_DELIMITER))
+			positions |= 1;
+		isStringStart = false;
+		afterDelimiter = mass == CMP_MASS_DELIMITER;
+
+		const UInt64 equal = GetMassMask(mass);
+		const UInt64 rest = positions & ~equal;
+		UInt64 nextPositions = (positions & equal) << 1;
+
+		if (mass == CMP_MASS_ZERO)
+		{
+			nextPositions |= rest;
+		}
+		else
+		{
+			// Символ не подходит под позицию шаблона: либо это конец шаблона на границе слова, либо несовпадение
+			if (mass == CMP_MASS_DELIMITER && (rest & m_EndBit))
+				return 1;
+
+			nextPositions |= (rest & m_OneChar) << 1;
+			anyPositions |= (rest & m_AnyChars) << 1;
+		}
+
+		nextPositions |= (anyPositions & equal) << 1;
+		positions = nextPositions;
+	}
+
+	if (isStringStart || afterDelimiter)
+		positions |= 1;
+
+	return ((positions & m_EmptyTail) || (anyPositions & m_EmptyTailAny)) ? 1 : 0;
+}
+
 UInt8 CSldCompare::GetCompareLen(const UInt16* aWildCard, const UInt16* aText) const
 {
 	UInt8 Result = (UInt8)(~0);
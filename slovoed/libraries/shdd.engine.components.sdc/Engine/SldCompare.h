@@ -357,9 +357,35 @@ void StrReverse(Char *aBegin, Char *aEnd)
 
 } // namespace sld2
 
+// Signature of a string of masses, used to discard words during wildcard search without comparing them
+struct TSldWildCardSignature
+{
+	// Bits of the trigrams of masses inside the words of the string
+	UInt64 Grams;
+	// Bits of the first one and two masses of every word of the string
+	UInt64 Heads;
+
+	// Checks if a string with the signature aText can match a pattern with this signature
+	bool MayMatch(const TSldWildCardSignature &aText) const
+	{
+		return (aText.Grams & Grams) == Grams && (aText.Heads & Heads) == Heads;
+	}
+};
+
+// Level of a sort key (see CSldCompare::MakeSortKey)
+enum ESldSortKeyLevel
+{
+	// Keys are ordered like the strings by CSldCompare::StrICmp
+	eSortKeyMass = 0,
+	// Keys of strings equal by CSldCompare::StrICmp are further ordered like the strings by CSldCompare::StrCmp
+	eSortKeyMassAndCode
+};
+
 // Class for working with strings.
 class CSldCompare
 {
+	friend class CSldSortKeys;
+
 public:
 
 	// Constructor
@@ -429,6 +455,17 @@ public:
 	// Comparison of 2 strings by comparison table (compare weights of characters)
 	Int32 StrICmp(SldU16StringRef str1, SldU16StringRef str2) const;
 
+	// Builds a byte string whose bytewise order (see CompareSortKeys) is the order of the strings
+	// by the comparison table with the given index
+	void MakeSortKey(SldU16StringRef aText, ESldSortKeyLevel aLevel, UInt32 aTableIndex, CSldVector<UInt8> &aKey) const;
+
+	// Builds a byte string whose bytewise order (see CompareSortKeys) is the order of the strings
+	// by the default comparison table
+	void MakeSortKey(SldU16StringRef aText, ESldSortKeyLevel aLevel, CSldVector<UInt8> &aKey) const;
+
+	// Bytewise comparison of 2 sort keys
+	static Int32 CompareSortKeys(const UInt8 *aKey1, UInt32 aSize1, const UInt8 *aKey2, UInt32 aSize2);
+
 
 	Int32 StrICmpByLanguage(const UInt16 *str1, const UInt16 *str2, ESldLanguage aLanguageCode) const;
 
@@ -582,6 +619,11 @@ public:
 	UInt32 WildCompare(const UInt16* aWildCard, const UInt16* aText) const;
 
 	UInt8 GetCompareLen(const UInt16* aWildCard, const UInt16* aText) const;
+
+	// Adds a string of masses with delimiters to the wildcard search signature
+	static void AddWildCardSignature(const UInt16* aMassStr, TSldWildCardSignature &aSignature);
+	// Returns the signature which any string matching the pattern of masses must contain
+	static TSldWildCardSignature GetWildCardPatternSignature(const UInt16* aWildCard);
 	// Anagram comparison method
 	UInt8 AnagramCompare(UInt16* aSearchStr, const UInt16* aCurrentWord, UInt8* aFlagArray, UInt32 aSearchStrLen) const;
 
@@ -698,6 +740,9 @@ private:
 	// Returns the mass for a complex symbol
 	UInt32 GetComplex(const UInt16 *str, UInt16 index, UInt16 *mass, const CMPComplexType *complex) const;
 
+	// Appends the sort key of a string to aKey
+	void AppendSortKey(SldU16StringRef aText, ESldSortKeyLevel aLevel, UInt32 aTableIndex, CSldVector<UInt8> &aKey) const;
+
 	// Method of comparing pattern and word for matching
 	Int8 DoWildCompare(const UInt16* aTemplate, const UInt16* aText) const;
 
@@ -726,4 +771,96 @@ private:
 	sld2::DynArray<CSldSymbolsTable>	m_LanguageDelimiterSymbolsTable;
 };
 
+// Sort keys of a set of strings (see CSldCompare::MakeSortKey) stored in a single buffer.
+// Sorting by them builds the masses of every string once instead of on every comparison
+class CSldSortKeys
+{
+public:
+	// Removes all keys
+	void Clear();
+
+	// Reserves memory for aCount keys built from strings of aTextLength characters in total
+	void Reserve(UInt32 aCount, UInt32 aTextLength);
+
+	// Adds the key of a string by the comparison table with the given index, the key gets the next index
+	void Add(const CSldCompare &aCMP, SldU16StringRef aText, ESldSortKeyLevel aLevel, UInt32 aTableIndex);
+
+	// Adds the key of a string by the default comparison table, the key gets the next index
+	void Add(const CSldCompare &aCMP, SldU16StringRef aText, ESldSortKeyLevel aLevel);
+
+	// Returns the number of keys
+	UInt32 Count() const { return m_Ends.size(); }
+
+	// Compares the keys with the given indexes
+	Int32 Compare(UInt32 aIndex1, UInt32 aIndex2) const;
+
+	// Sorts the key indexes in the ascending order of the keys, indexes of equal keys stay ascending
+	void Sort(sld2::Span<Int32> aIndexes) const;
+
+private:
+	// Returns the first byte of the key
+	const UInt8* Begin(UInt32 aIndex) const { return m_Data.data() + (aIndex ? m_Ends[aIndex - 1] : 0); }
+
+	// Returns the size of the key
+	UInt32 Size(UInt32 aIndex) const { return m_Ends[aIndex] - (aIndex ? m_Ends[aIndex - 1] : 0); }
+
+private:
+	// Keys one after another
+	CSldVector<UInt8>	m_Data;
+
+	// End offsets of the keys
+	CSldVector<UInt32>	m_Ends;
+};
+
+// Wildcard pattern compiled once per query into a bit-parallel automaton over the mass alphabet.
+// Gives exactly the same results as CSldCompare::WildCompare, but checks a string in a single pass
+// without backtracking
+class CSldWildCardPattern
+{
+public:
+	CSldWildCardPattern() : m_CMP(NULL), m_Compiled(false) {}
+
+	// Compiles a pattern of masses (see CSldCompare::GetSearchPatternOfMass)
+	void Compile(const CSldCompare &aCMP, const UInt16* aWildCard);
+
+	// Checks a string of masses with delimiters against the pattern (see CSldCompare::WildCompare)
+	UInt32 Match(const UInt16* aText) const;
+
+private:
+	// Returns the mask of the pattern positions holding the given mass
+	UInt64 GetMassMask(UInt16 aMass) const;
+
+private:
+	// Size of the hash table of pattern masses
+	enum { MassTableSize = 128 };
+
+	// Maximum length of a pattern that can be compiled (one bit per position plus the end)
+	enum { MaxLength = 63 };
+
+	// Class used to match patterns which are too long to be compiled
+	const CSldCompare*	m_CMP;
+
+	// Source pattern
+	SldU16String		m_WildCard;
+
+	// Whether the pattern was compiled
+	bool				m_Compiled;
+
+	// Hash table: pattern mass -> mask of the positions holding it
+	UInt16				m_Masses[MassTableSize];
+	UInt64				m_MassMasks[MassTableSize];
+
+	// Positions holding "any chars" and "one char" symbols
+	UInt64				m_AnyChars;
+	UInt64				m_OneChar;
+
+	// Bit of the position after the last pattern symbol
+	UInt64				m_EndBit;
+
+	// Positions from which the rest of the pattern matches an empty string
+	// (with inactive and active "any chars" mode)
+	UInt64				m_EmptyTail;
+	UInt64				m_EmptyTailAny;
+};
+
 #endif //_SLD_COMPARE_H_
@@ -100,16 +100,6 @@ CSldCustomList::~CSldCustomList()
 
 	if (m_SortedWordIndexes)
 		sldMemFree(m_SortedWordIndexes);
-
-	if (m_TmpWordBuff)
-	{
-		for (UInt32 wordIndex = 0; wordIndex < m_TmpWordSize; wordIndex++)
-		{
-			if (m_TmpWordBuff[wordIndex])
-				sldMemFree(m_TmpWordBuff[wordIndex]);
-		}
-		sldMemFree(m_TmpWordBuff);
-	}
 }
 
 /** *********************************************************************
@@ -2063,30 +2053,137 @@ ESldError CSldCustomList::InsertWords(const Int32 aRealListIndex, const Int32 aB
 ************************************************************************/
 ESldError CSldCustomList::CheckAllocateMemory()
 {
-	if(m_NumbersOfWords && m_NumbersOfWords >= m_MaxNumbersOfWords)
+	if (m_NumbersOfWords && m_NumbersOfWords >= m_MaxNumbersOfWords)
 	{
-		UInt32 newNumberOfWords = m_MaxNumbersOfWords ? 3 * m_NumbersOfWords / 2 : SLD_DEFAULT_WORDS_COUNT_IN_CUSTOM_LIST;
+		const Int32 newNumberOfWords = m_MaxNumbersOfWords ? 3 * m_NumbersOfWords / 2 : SLD_DEFAULT_WORDS_COUNT_IN_CUSTOM_LIST;
+		return ResizeWordVector(sld2::max(newNumberOfWords, m_NumbersOfWords + 1));
+	}
 
-		TSldCustomListWordInfo* tmpWordVector = m_WordVector;
+	return eOK;
+}
 
-		m_WordVector = NULL;
-		m_WordVector = (TSldCustomListWordInfo*)sldMemNew(newNumberOfWords * sizeof(TSldCustomListWordInfo));
-		if(!m_WordVector)
-			return eMemoryNotEnoughMemory;
+/** *********************************************************************
+* Перевыделяет массив со словами под заданное количество слов
+*
+* @param[in]	aMaxNumberOfWords	- новое максимальное количество слов, должно быть больше текущего
+*
+* @return error code
+************************************************************************/
+ESldError CSldCustomList::ResizeWordVector(const Int32 aMaxNumberOfWords)
+{
+	TSldCustomListWordInfo* tmpWordVector = m_WordVector;
+
+	m_WordVector = (TSldCustomListWordInfo*)sldMemNew(aMaxNumberOfWords * sizeof(TSldCustomListWordInfo));
+	if (!m_WordVector)
+	{
+		m_WordVector = tmpWordVector;
+		return eMemoryNotEnoughMemory;
+	}
+
+	if (tmpWordVector)
+	{
+		sldMemMove(m_WordVector, tmpWordVector, m_MaxNumbersOfWords * sizeof(TSldCustomListWordInfo));
+		sldMemFree(tmpWordVector);
+	}
+
+	sldMemZero(m_WordVector + m_MaxNumbersOfWords, (aMaxNumberOfWords - m_MaxNumbersOfWords) * sizeof(TSldCustomListWordInfo));
+	m_MaxNumbersOfWords = aMaxNumberOfWords;
+
+	return eOK;
+}
+
+/** *********************************************************************
+* Резервирует память под заданное общее количество слов в списке, чтобы
+* последующее добавление этих слов обошлось без перевыделений
+*
+* @param[in]	aNumberOfWords	- ожидаемое количество слов в списке
+*
+* @return error code
+************************************************************************/
+ESldError CSldCustomList::ReserveWords(const Int32 aNumberOfWords)
+{
+	// CheckAllocateMemory() держит в массиве хотя бы одну свободную запись
+	if (aNumberOfWords < m_MaxNumbersOfWords)
+		return eOK;
+
+	return ResizeWordVector(aNumberOfWords + 1);
+}
+
+/** *********************************************************************
+* Добавляет в конец списка набор слов из словарных списков
+*
+* Память под все слова выделяется один раз, слова хранятся как ссылки на записи
+* в словарных списках и получаются из них только при обращении.
+* Иерархия добавляемых слов не раскрывается
+*
+* @param[in]	aWords	- пары (индекс списка, индекс слова) добавляемых слов
+*
+* @return error code
+************************************************************************/
+ESldError CSldCustomList::AddWords(sld2::Span<const TSldWordIndexes> aWords)
+{
+	if (aWords.empty())
+		return eOK;
+
+	ESldError error = ReserveWords(m_NumbersOfWords + aWords.size());
+	if (error != eOK)
+		return error;
+
+	if (m_SortedWordIndexes)
+	{
+		sldMemFree(m_SortedWordIndexes);
+		m_SortedWordIndexes = NULL;
+	}
 
-		if(tmpWordVector)
+	// Указатель на список и его тип меняются только при смене списка, а слова обычно идут из одного
+	Int32 listIndex = SLD_DEFAULT_LIST_INDEX;
+	ISldList* listPtr = NULL;
+	bool isSearchList = false;
+	for (const TSldWordIndexes & word : aWords)
+	{
+		if (!listPtr || word.ListIndex != listIndex)
 		{
-			sldMemMove(m_WordVector, tmpWordVector, m_MaxNumbersOfWords * sizeof(TSldCustomListWordInfo));
-			sldMemZero(m_WordVector + m_MaxNumbersOfWords, (newNumberOfWords - m_MaxNumbersOfWords) * sizeof(TSldCustomListWordInfo));
-			sldMemFree(tmpWordVector);
+			error = m_RealListVector.GetListPtr(word.ListIndex, &listPtr);
+			if (error != eOK)
+				return error;
+
+			const CSldListInfo* listInfo = NULL;
+			error = listPtr->GetWordListInfo(&listInfo);
+			if (error != eOK)
+				return error;
+
+			isSearchList = listInfo->GetUsage() == eWordListType_RegularSearch || listInfo->GetUsage() == eWordListType_CustomList;
+			listIndex = word.ListIndex;
 		}
-		else
+
+		TSldCustomListWordInfo* newWordPtr = &m_WordVector[m_NumbersOfWords];
+		newWordPtr->Clear();
+		newWordPtr->RealListIndex = word.ListIndex;
+		newWordPtr->RealWordIndex = word.WordIndex;
+		newWordPtr->RealListPtr = listPtr;
+
+		if (isSearchList)
 		{
-			sldMemZero(m_WordVector, newNumberOfWords * sizeof(TSldCustomListWordInfo));
+			error = listPtr->GetRealListIndex(word.WordIndex, &newWordPtr->RealListIndex);
+			if (error != eOK)
+				return error;
+
+			error = listPtr->GetRealGlobalIndex(word.WordIndex, &newWordPtr->RealWordIndex);
+			if (error != eOK)
+				return error;
+
+			error = m_RealListVector.GetListPtr(newWordPtr->RealListIndex, &newWordPtr->RealListPtr);
+			if (error != eOK)
+				return error;
 		}
-		m_MaxNumbersOfWords = newNumberOfWords;
+
+		m_NumbersOfWords++;
 	}
 
+	// В список добавлен первый элемент, установим его в качестве текущего
+	if (m_CurrentIndex == SLD_DEFAULT_WORD_INDEX)
+		m_CurrentIndex = 0;
+
 	return eOK;
 }
 
@@ -2229,8 +2326,8 @@ ESldError CSldCustomList::EraseWords(const Int32 aBeginIndex, const Int32 aEndIn
 * Индексирует все слова, содержащиеся в списке в соответсвии с заданным вариантом написания
 *
 * @param[in]	aVariantIndex		- номер индексируемого варианта написания
-* @param[in]	aCreateWordsBuffer	- в процессе индексации все слова будут буфферизированы,
-*									  данный флаг определяет, нужно ли оставить этот буфер для ускорения поиска
+* @param[in]	aCreateWordsBuffer	- флаг буферизации слов, передается базовому списку при сортировке
+*									  по индексам из него
 *
 * @return error code
 ************************************************************************/
@@ -2272,239 +2369,43 @@ ESldError CSldCustomList::SortListByVariant(const Int32 aVariantIndex, const Int
 		m_SortedWordIndexes = NULL;
 	}
 
-	m_SortedWordIndexes = (Int32*)sldMemNew(m_NumbersOfWords * 2 * sizeof(*m_SortedWordIndexes));
+	m_SortedWordIndexes = (Int32*)sldMemNew(m_NumbersOfWords * sizeof(*m_SortedWordIndexes));
 	if (!m_SortedWordIndexes)
 		return eMemoryNotEnoughMemory;
 
 	m_SortedVariantIndex = aVariantIndex;
 
-	Int32 firstIndex = 0;
-	Int32 secondIndex = m_NumbersOfWords;
-	Int32 medIndex = m_NumbersOfWords >> 1;
-	UInt16* tmpWord = NULL;
-
-	if (!sortByIndex)
-	{
-		m_TmpWordSize = m_NumbersOfWords;
-		m_TmpWordBuff = (UInt16**)sldMemNewZero(m_TmpWordSize * sizeof(UInt16*));
-		if (!m_TmpWordBuff)
-			return eMemoryNotEnoughMemory;
-
-		error = GetWordByGlobalIndex(medIndex);
-		if (error != eOK)
-			return error;
-
-		error = GetCurrentWord(m_SortedVariantIndex, &tmpWord);
-		if (error != eOK)
-			return error;
-
-		m_TmpWordBuff[medIndex] = (UInt16*)sldMemNew((CSldCompare::StrLen(tmpWord) + 1) * sizeof(UInt16));
-		if (!m_TmpWordBuff[medIndex])
-			return eMemoryNotEnoughMemory;
-
-		CSldCompare::StrCopy(m_TmpWordBuff[medIndex], tmpWord);
-	}
-
-	Int32 compareResult = 0;
 	for (Int32 wordIndex = 0; wordIndex < m_NumbersOfWords; wordIndex++)
-	{
-		if (wordIndex == medIndex)
-		{
-			m_SortedWordIndexes[firstIndex] = wordIndex;
-			firstIndex++;
-			continue;
-		}
+		m_SortedWordIndexes[wordIndex] = wordIndex;
 
-		if (sortByIndex)
-		{
-			compareResult = m_WordVector[wordIndex].RealWordIndex - m_WordVector[medIndex].RealWordIndex;
-		}
-		else
-		{
-			error = GetWordByGlobalIndex(wordIndex);
-			if (error != eOK)
-				return error;
-
-			error = GetCurrentWord(m_SortedVariantIndex, &tmpWord);
-			if (error != eOK)
-				return error;
-
-			m_TmpWordBuff[wordIndex] = (UInt16*)sldMemNew((CSldCompare::StrLen(tmpWord) + 1) * sizeof(UInt16));
-			if (!m_TmpWordBuff[wordIndex])
-				return eMemoryNotEnoughMemory;
-
-			CSldCompare::StrCopy(m_TmpWordBuff[wordIndex], tmpWord);
-
-			error = CompareWords(m_TmpWordBuff[wordIndex], m_TmpWordBuff[medIndex], &compareResult);
-			if (error != eOK)
-				return error;
-		}
-
-		if (compareResult <= 0)
-		{
-			m_SortedWordIndexes[firstIndex] = wordIndex;
-			firstIndex++;
-		}
-		else
-		{
-			m_SortedWordIndexes[secondIndex] = wordIndex;
-			secondIndex++;
-		}	
-	}
-
-	sldMemMove(&m_SortedWordIndexes[firstIndex], &m_SortedWordIndexes[m_NumbersOfWords], (secondIndex - m_NumbersOfWords) * sizeof(*m_SortedWordIndexes));
-
-	if (firstIndex - 1 > 0)
+	if (sortByIndex)
 	{
-		error = QuickSortSearchVector(0, firstIndex - 1, sortByIndex);
-		if (error != eOK)
-			return error;
+		sld2::sort_indexes(m_SortedWordIndexes, m_NumbersOfWords, [this](Int32 aFirst, Int32 aSecond) {
+			return m_WordVector[aFirst].RealWordIndex - m_WordVector[aSecond].RealWordIndex;
+		});
+		return eOK;
 	}
 
-	if (firstIndex < m_NumbersOfWords - 1)
+	// Каждое слово получаем и переводим в ключ сортировки один раз, дальше сравниваются только ключи.
+	// В списке могут быть слиты слова из разных языковых направлений, поэтому сравниваем по первой таблице,
+	// а равные по ней слова - по кодам символов
+	CSldSortKeys keys;
+	for (Int32 wordIndex = 0; wordIndex < m_NumbersOfWords; wordIndex++)
 	{
-		error = QuickSortSearchVector(firstIndex, m_NumbersOfWords - 1, sortByIndex);
+		error = GetWordByGlobalIndex(wordIndex);
 		if (error != eOK)
 			return error;
-	}
-
-	if (m_TmpWordBuff && !aCreateWordsBuffer)
-	{
-		for (UInt32 wordIndex = 0; wordIndex < m_TmpWordSize; wordIndex++)
-		{
-			if (m_TmpWordBuff[wordIndex])
-			{
-				sldMemFree(m_TmpWordBuff[wordIndex]);
-			}
-		}
-		sldMemFree(m_TmpWordBuff);
-		m_TmpWordBuff = NULL;
-		m_TmpWordSize = 0;
-	}
-
-	return eOK;
-}
-
-/** *********************************************************************
-* Сортирует записи в поисковом индексе
-*
-* @param[in]	aFirstIndex		- первый индекс сортируемого диапазона
-* @param[in]	aLastIndex		- последний индекс сортируемого диапазона
-* @param[in]	aSortByIndex	- флаг того что нужно отсортировать
-*								0 - записи сортируются по тексту
-*								1 - записи сортируются по реальным индексам из базового списка
-*
-* @return error code
-************************************************************************/
-ESldError CSldCustomList::QuickSortSearchVector(const Int32 aFirstIndex, const Int32 aLastIndex, const Int8 aSortByIndex)
-{
-	ESldError error = eOK;
-	Int32 medIndex = (aFirstIndex + aLastIndex) >> 1;
 
-	UInt16* medWord = NULL;
-	Int32 medWordIndex = SLD_DEFAULT_WORD_INDEX;
-	if (aSortByIndex)
-	{
-		medWordIndex = m_WordVector[m_SortedWordIndexes[medIndex]].RealWordIndex;
-	}
-	else
-	{
-		medWord = m_TmpWordBuff[m_SortedWordIndexes[medIndex]];
-	}
-
-	Int32 firstIndex = aFirstIndex;
-	Int32 secondIndex = m_NumbersOfWords;
-	Int32 medCount = 0;
-
-	Int32 compareResult = 0;
-	for (Int32 currentIndex = aFirstIndex; currentIndex <= aLastIndex; currentIndex++)
-	{
-		if (currentIndex == medIndex)
-		{
-			compareResult = 0;
-		}
-		else if (aSortByIndex)
-		{
-			compareResult = m_WordVector[m_SortedWordIndexes[currentIndex]].RealWordIndex - medWordIndex;
-		}
-		else
-		{
-			error = CompareWords(m_TmpWordBuff[m_SortedWordIndexes[currentIndex]], medWord, &compareResult);
-			if (error != eOK)
-				return error;
-		}
-
-		if (compareResult < 0)
-		{
-			m_SortedWordIndexes[firstIndex] = m_SortedWordIndexes[currentIndex];
-			firstIndex++;
-		}
-		else if (compareResult > 0)
-		{
-			m_SortedWordIndexes[secondIndex] = m_SortedWordIndexes[currentIndex];
-			secondIndex++;
-		}
-		else
-		{
-			medCount++;
-			m_SortedWordIndexes[2 * m_NumbersOfWords - medCount] = m_SortedWordIndexes[currentIndex];
-		}
-	}
-
-	if (medCount > 1)
-	{
-		for (Int32 i = 0; i < medCount; i++)
-		{
-			m_SortedWordIndexes[firstIndex + i] = m_SortedWordIndexes[2 * m_NumbersOfWords - 1 - i];
-		}
-	}
-	else
-	{
-		sldMemMove(&m_SortedWordIndexes[firstIndex], &m_SortedWordIndexes[2 * m_NumbersOfWords - medCount], medCount * sizeof(*m_SortedWordIndexes));
-	}
-
-	sldMemMove(&m_SortedWordIndexes[firstIndex + medCount], &m_SortedWordIndexes[m_NumbersOfWords], (secondIndex - m_NumbersOfWords) * sizeof(*m_SortedWordIndexes));
-
-	if (firstIndex - 1 > aFirstIndex)
-	{
-		error = QuickSortSearchVector(aFirstIndex, firstIndex - 1, aSortByIndex);
+		UInt16* word = NULL;
+		error = GetCurrentWord(m_SortedVariantIndex, &word);
 		if (error != eOK)
 			return error;
-	}
 
-	if (secondIndex - medCount > m_NumbersOfWords)
-	{
-		error = QuickSortSearchVector(firstIndex + medCount, aLastIndex, aSortByIndex);
-		if (error != eOK)
-			return error;
+		keys.Add(*m_CMP, word, eSortKeyMassAndCode, 0);
 	}
 
-	return eOK;
-}
-
-/** *********************************************************************
-* Сравнивает два слова
-*
-* @param[in]	aFirstWord		- указатель на первое слово
-* @param[in]	aSecondWord		- указатель на второе слово
-* @param[in]	aResult			- указатель, по которому будет записан результат
-*								  0 - строки равны, 
-*								  1 первая строка больше второй, 
-*								 -1 первая строка меньше второй
-*
-* @return error code
-************************************************************************/
-ESldError CSldCustomList::CompareWords(const UInt16* aFirstWord, const UInt16* aSecondWord, Int32* aResult)
-{
-	if (!aResult || !aFirstWord || !aSecondWord)
-		return eMemoryNullPointer;
-
-	// В списке могут быть слиты слова из разных языковых направлений
-	*aResult = m_CMP->StrICmp(aFirstWord, aSecondWord, 0);
-	if (*aResult)
-		return eOK;
+	keys.Sort(sld2::make_span(m_SortedWordIndexes, (UInt32)m_NumbersOfWords));
 
-	*aResult = m_CMP->StrCmp(aFirstWord, aSecondWord);
 	return eOK;
 }
 
@@ -127,8 +127,6 @@ public:
 	m_SortedWordIndexes(NULL),
 	m_SortedVariantIndex(0),
 	m_CMP(NULL),
-	m_TmpWordBuff(NULL),
-	m_TmpWordSize(0),
 	m_SearchSourceListIndex(SLD_DEFAULT_LIST_INDEX)
 	{
 	};
@@ -450,6 +448,12 @@ public:
 	// Добавляет диапазон слов в список
 	ESldError InsertWords(const Int32 aRealListIndex, const Int32 aBeginRealWordIndex, const Int32 aEndRealWordIndex, Int32 aInsertAfterIndex = SLD_DEFAULT_WORD_INDEX);
 
+	// Добавляет в конец списка набор слов из словарных списков
+	ESldError AddWords(sld2::Span<const TSldWordIndexes> aWords);
+
+	// Резервирует память под заданное общее количество слов в списке
+	ESldError ReserveWords(const Int32 aNumberOfWords);
+
 	// Удаляет записи из списка
 	ESldError EraseWords(const Int32 aBeginIndex, const Int32 aEndIndex);
 
@@ -481,11 +485,8 @@ private:
 	// Выделяет память, если это необходимо
 	ESldError CheckAllocateMemory();
 
-	// Сравнивает два слова
-	ESldError CompareWords(const UInt16* aFirstWord, const UInt16* aSecondWord, Int32* aResult);
-
-	// Сортирует записи в поисковом индексе
-	ESldError QuickSortSearchVector(const Int32 aFirstIndex, const Int32 aLastIndex, const Int8 aSortByIndex);
+	// Перевыделяет массив со словами под заданное количество слов
+	ESldError ResizeWordVector(const Int32 aMaxNumberOfWords);
 
 	// Устанавливает вариант написания для уже добавленного слова
 	ESldError SetCurrentWord(TSldCustomListWordInfo* aWordInfoPtr, const  UInt16* aText, const Int32 aVariantIndex, const UInt32 aResetSearchVector);
@@ -531,12 +532,6 @@ private:
 	// Таблица сортировки
 	const CSldCompare*			m_CMP;
 
-	// Временный буфер, для сортировки слов
-	UInt16**					m_TmpWordBuff;
-
-	// Размер временного буфера
-	UInt32						m_TmpWordSize;
-
 	// Индекс базового списка, в котором нужно проводить поиск
 	Int32						m_SearchSourceListIndex;
 };
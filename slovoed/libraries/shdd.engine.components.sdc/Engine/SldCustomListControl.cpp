@@ -64,6 +64,44 @@ ESldError CSldCustomListControl::AddWord(const Int32 aRealListIndex)
 	return customList()->AddWord(aRealListIndex);
 }
 
+/** *********************************************************************
+* Добавляет в список набор слов на основе уже существующих записей в словаре
+*
+* В отличие от поочередного вызова AddWord() память выделяется один раз,
+* иерархия добавляемых слов не раскрывается
+*
+* @param[in]	aWords	- пары (индекс списка, индекс слова) добавляемых слов
+*
+* @return error code
+************************************************************************/
+ESldError CSldCustomListControl::AddWords(sld2::Span<const TSldWordIndexes> aWords)
+{
+	for (const TSldWordIndexes & word : aWords)
+	{
+		if (word.ListIndex >= static_cast<Int32>(m_WordLists.size()))
+			return eCommonWrongList;
+	}
+
+	return customList()->AddWords(aWords);
+}
+
+/** *********************************************************************
+* Резервирует память под заданное количество слов, которые еще будут добавлены в список
+*
+* @param[in]	aCount	- количество добавляемых слов
+*
+* @return error code
+************************************************************************/
+ESldError CSldCustomListControl::ReserveWords(const Int32 aCount)
+{
+	Int32 numberOfWords = 0;
+	ESldError error = customList()->GetNumberOfWords(&numberOfWords);
+	if (error != eOK)
+		return error;
+
+	return customList()->ReserveWords(numberOfWords + aCount);
+}
+
 /** *********************************************************************
 * Привязывает слово к записи из списка
 *
@@ -44,6 +44,12 @@ public:
 	ESldError AddWord(const Int32 aRealListIndex, const Int32 aRealWordIndex, const UInt32 aUncoverHierarchy = 0);
 	ESldError AddWord(const Int32 aRealListIndex = SLD_DEFAULT_LIST_INDEX);
 
+	// Добавляет в список набор слов, выделяя память один раз
+	ESldError AddWords(sld2::Span<const TSldWordIndexes> aWords);
+
+	// Резервирует память под заданное количество слов, которые еще будут добавлены
+	ESldError ReserveWords(const Int32 aCount);
+
 	// Привязывает слово к записи из списка
 	ESldError AddSubWord(const Int32 aWordIndex, const Int32 aSubWordIndex, const Int32 aSubWordListIndex = SLD_DEFAULT_LIST_INDEX);
 
@@ -45,6 +45,12 @@
 	For the second wordlist, it will be BCAT
 */
 #define SLD_RESOURCE_HIERARCHY		'TACA'
+// The resource type for the hierarchy level parents table (basic).
+/** 
+	For the first wordlist, it will be ACAP
+	For the second wordlist, it will be BCAP
+*/
+#define SLD_RESOURCE_HIERARCHY_PARENTS	'PACA'
 // The resource type for the quick access table (basic).
 /** 
 	For the first wordlist it will be AQAT
@@ -227,6 +233,12 @@ For the second wordlist, it will be BSDT
 // Количество слов в пользовательском списке, для которых будет выделена память по умолчанию
 #define SLD_DEFAULT_WORDS_COUNT_IN_CUSTOM_LIST					(0x10)
 
+// Количество одновременно загруженных (декодируемых) ресурсов в string store
+// Каждый ресурс занимает отдельный буфер; во время работы значение меняется через SetResidentResourceCount()
+#ifndef SLD_DEFAULT_STRING_STORE_RESIDENT_RESOURCES
+#define SLD_DEFAULT_STRING_STORE_RESIDENT_RESOURCES				(2)
+#endif
+
 
 // Макрос для изменения порядка байт в машинном слове. На x86,ARM,MIPS,SH3 и т.д.(кроме PowerPC/DragonBall/Motorolla68000) ничего делаться не должно.
 #define MORPHO_SWAP_16(x)    REVERSE_INT16(x)
@@ -262,6 +274,9 @@ For the second wordlist, it will be BSDT
 // Флаг того, что индексы имеют в своем составе смещения в статье (иначе смещение == 0)
 #define SLD_INDEXES_IS_SHIFT_INDEX	(0x00000010UL)
 
+// Флаг того, что все поля данных индексов занимают целое число байт (данные можно распаковывать побайтово)
+#define SLD_INDEXES_IS_BYTE_ALIGNED	(0x00000020UL)
+
 // Перечисление разновидностей полноты перевода
 enum ESldTranslationFullnesType
 {
@@ -1324,6 +1339,10 @@ enum EMetadataUnitType
 ///
 #define  SLD_FTS_NUMBER_OF_WORDS_FOR_FULL_MODE	(256)
 
+// Количество слов, окончательно упорядочиваемых за раз при сортировке результатов полнотекстового поиска по релевантности;
+// остальные слова досортировываются по мере обращения к ним
+#define SLD_FTS_RELEVANT_SORT_PAGE_SIZE	(64)
+
 // Максимальное число слов в запросе в TExpressionBox
 #define		SLD_DEFAULT_NUMBER_OF_REQUEST_WORD	(512)
 
@@ -6,6 +6,63 @@
 #include "SldStringStore.h"
 #include "SldTools.h"
 
+#ifdef SLD__HAVE_STATISTICS
+
+namespace {
+
+// Учитывает вызов операции словаря: направляет счетчики текущего потока в статистику словаря,
+// замеряет время выполнения операции и вызывает хуки трассировки прослойки
+class StatisticsScope
+{
+public:
+	StatisticsScope(const CSldDictionary *aDictionary, TSldStatistics &aStatistics,
+					ISldLayerAccess *aLayerAccess, ESldStatisticsOperation aOperation) :
+		m_Dictionary(aDictionary), m_Statistics(aStatistics), m_LayerAccess(aLayerAccess),
+		m_Operation(aOperation), m_Previous(sld2::statistics::current())
+	{
+		sld2::statistics::current() = &m_Statistics;
+		if (m_LayerAccess)
+			m_LayerAccess->TraceBegin(m_Dictionary, m_Operation);
+		m_StartTime = sldMonotonicTime();
+	}
+
+	~StatisticsScope()
+	{
+		const UInt64 time = sldMonotonicTime() - m_StartTime;
+		m_Statistics.OperationCalls[m_Operation]++;
+		m_Statistics.OperationTime[m_Operation] += time;
+		sld2::statistics::current() = m_Previous;
+		if (m_LayerAccess)
+			m_LayerAccess->TraceEnd(m_Dictionary, m_Operation, time);
+	}
+
+private:
+	const CSldDictionary *m_Dictionary;
+	TSldStatistics &m_Statistics;
+	ISldLayerAccess *m_LayerAccess;
+	ESldStatisticsOperation m_Operation;
+	TSldStatistics *m_Previous;
+	UInt64 m_StartTime;
+};
+
+} // anon namespace
+
+#define SLD_STATISTICS_SCOPE(_layerAccess, _operation) \
+	StatisticsScope statisticsScope_(this, m_Statistics, _layerAccess, _operation)
+
+#else
+
+#define SLD_STATISTICS_SCOPE(_layerAccess, _operation) ((void)0)
+
+#endif // SLD__HAVE_STATISTICS
+
+// Область временных буферов операции словаря (см. SldArena.h)
+#ifdef SLD__HAVE_SCRATCH_ARENA
+#define SLD_SCRATCH_SCOPE() sld2::ArenaScope scratchScope_(m_ScratchArena)
+#else
+#define SLD_SCRATCH_SCOPE() ((void)0)
+#endif
+
 
 // Стандартный конструктор
 CSldDictionary::CSldDictionary(void)
@@ -37,6 +94,9 @@ void CSldDictionary::Clear(void)
 	m_AtomicInfo = NULL;
 	m_MetadataStringsListIndex = SLD_DEFAULT_LIST_INDEX;
 	m_cssDataStringsListIndex = SLD_DEFAULT_LIST_INDEX;
+	m_InitializedParts = 0;
+	m_ContentError = eOK;
+	m_SearchContext = NULL;
 }
 
 /** *********************************************************************
@@ -52,6 +112,11 @@ void CSldDictionary::Clear(void)
 ************************************************************************/
 ESldError CSldDictionary::Open(ISDCFile *aFile, ISldLayerAccess *aLayerAccess)
 {
+#ifdef SLD__HAVE_STATISTICS
+	m_Statistics.Clear();
+#endif
+	SLD_STATISTICS_SCOPE(aLayerAccess, eStatisticsOperation_Open);
+
 	ESldError error = LoadBaseHeader(aFile);
 	if (error != eOK)
 	{
@@ -73,48 +138,6 @@ ESldError CSldDictionary::Open(ISDCFile *aFile, ISldLayerAccess *aLayerAccess)
 		return eCommonTooHighDictionaryVersion;
 	}
 
-	//////////////////////////////////////////////////////////////////////////
-	// Загружаем дополнительную информацию о базе
-	auto res = m_data.GetResource(SLD_RESOURCE_INFO, eInfoIndex_CommonInfo);
-	if (res)
-	{
-		// Выделяем память для структуры с описанием базы
-		m_AdditionalInfo = (TAdditionalInfo*)sldMemNewZero(sizeof(*m_AdditionalInfo));
-		if (!m_AdditionalInfo)
-		{
-			Close();
-			return eMemoryNotEnoughMemory;
-		}
-
-		// Простая проверка на корректность ресурса с описанием базы
-		TAdditionalInfo* tmpAdditionalInfo = (TAdditionalInfo*)res.ptr();
-		if (tmpAdditionalInfo->StructSize != res.size())
-		{
-			Close();
-			return eInputWrongStructSize;
-		}
-
-		// Копируем данные
-		sldMemMove(m_AdditionalInfo, tmpAdditionalInfo, tmpAdditionalInfo->StructSize);
-	}
-
-	// Загружаем аннотацию к базе
-	res = m_data.GetResource(SLD_RESOURCE_INFO, eInfoIndex_Annotation);
-	if (res)
-	{
-		// Выделяем память для аннотации
-		m_Annotation = (UInt16*)sldMemNewZero(res.size());
-		if (!m_Annotation)
-		{
-			Close();
-			return eMemoryNotEnoughMemory;
-		}
-
-		// Копируем данные
-		sldMemMove(m_Annotation, res.ptr(), res.size());
-	}
-	//////////////////////////////////////////////////////////////////////////
-
 	// Выделяем память для информации о версии словарной базы
 	m_DictionaryVersionInfo = (TDictionaryVersionInfo*)sldMemNewZero(sizeof(*m_DictionaryVersionInfo));
 	if (!m_DictionaryVersionInfo)
@@ -124,7 +147,7 @@ ESldError CSldDictionary::Open(ISDCFile *aFile, ISldLayerAccess *aLayerAccess)
 	}
 	
 	// Загружаем информацию о версии словарной базы
-	res = m_data.GetResource(SLD_RESOURCE_DICTIONARY_VERSION_INFO, 0);
+	auto res = m_data.GetResource(SLD_RESOURCE_DICTIONARY_VERSION_INFO, 0);
 	if (res)
 	{
 		// Простая проверка на корректность данных
@@ -139,32 +162,6 @@ ESldError CSldDictionary::Open(ISDCFile *aFile, ISldLayerAccess *aLayerAccess)
 	}
 	
 	
-	// Инициализируем систему сравнения строчек
-	error = m_CMP.Open(m_data, m_Header->NumberOfLanguageSymbolsTable, m_Header->NumberOfLanguageDelimitersSymbolsTable);
-	if (error != eOK)
-	{
-		Close();
-		return error;
-	}
-
-	// Инициализируем менеджера морфологий
-	if (m_Header->HasMorphologyData)
-	{
-		m_MorphologyManager = sld2::make_unique<CSldMorphology>();
-		if (!m_MorphologyManager)
-		{
-			Close();
-			return eMemoryNotEnoughMemory;
-		}
-
-		error = m_MorphologyManager->Init(m_data);
-		if (error != eOK)
-		{
-			Close();
-			return error;
-		}
-	}
-	
 	// Загружаем информацию о списках слов.
 	res = m_data.GetResource(SLD_RESOURCE_HEADER, 1);
 	if (res != eOK)
@@ -216,31 +213,6 @@ ESldError CSldDictionary::Open(ISDCFile *aFile, ISldLayerAccess *aLayerAccess)
 	}
 	m_ListCount = m_Header->NumberOfLists;
 	
-	// Переводы
-	if (m_Header->NumberOfArticles)
-	{
-		auto articles = sld2::make_unique<CSldArticles>(*this, *m_LayerAccess, m_data, *m_Header, error);
-		if (!articles || error != eOK)
-		{
-			Close();
-			return articles ? error : eMemoryNotEnoughMemory;
-		}
-
-		m_Articles = sld2::move(articles);
-	}
-
-	// Локализованные строчки
-	{
-		auto strings = sld2::make_unique<CSldLocalizedString>(m_data, m_Header->NumberOfStringsLanguages, error);
-		if (!strings || error != eOK)
-		{
-			Close();
-			return strings ? error : eMemoryNotEnoughMemory;
-		}
-
-		m_Strings = sld2::move(strings);
-	}
-
 	// Загружаем тематики блоков switch
 	if (IsDictionaryHasSwitchThematics())
 	{
@@ -260,30 +232,224 @@ ESldError CSldDictionary::Open(ISDCFile *aFile, ISldLayerAccess *aLayerAccess)
 		sldMemMove(&m_SwitchThematicsBitmap, res.ptr(), res.size());
 	}
 
-	res = m_data.GetResource(SLD_AO_ARTICLE_TABLE, 0);
-	if (res && res.size())
+	error = InitRegistration();
+	if (error != eOK)
 	{
-		m_AtomicInfo = (TAtomicObjectInfo*)sldMemNew(res.size());
-		sldMemMove(m_AtomicInfo, res.ptr(), res.size());
+		Close();
+		return error;
 	}
 
-	error = InitRegistration();
+	// Таблицы сравнения нужны любому списку слов, а GetCMP() не может вернуть ошибку, поэтому
+	// они загружаются сразу; остальные подсистемы загружаются при первом обращении (см. InitContent())
+	error = InitCompare();
 	if (error != eOK)
 	{
 		Close();
 		return error;
 	}
 
-	// Инициализация менеджера бинарных метаданных
-	res = m_data.GetResource(SLD_RESOURCE_STRUCTURED_METADATA_HEADER, 0);
+	// Выбираем метод для декодирования озвучки
+	m_SoundBuilder[1] = &ISldLayerAccess::BuildSoundWrong;
+	m_SoundBuilder[2] = &ISldLayerAccess::BuildSoundRight;
+	SLD_VALIDATE_SECURITY(&m_RegistrationData, &m_RandomSeed, m_SoundBuilder);
+	
+	return eOK;
+}
+
+/** *********************************************************************
+* Загружает дополнительную информацию о базе и аннотацию к ней
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::InitAdditionalInfo()
+{
+	if (m_InitializedParts & eLazyInit_AdditionalInfo)
+		return eOK;
+
+	auto res = m_data.GetResource(SLD_RESOURCE_INFO, eInfoIndex_CommonInfo);
+	if (res)
+	{
+		// Простая проверка на корректность ресурса с описанием базы
+		TAdditionalInfo* tmpAdditionalInfo = (TAdditionalInfo*)res.ptr();
+		if (tmpAdditionalInfo->StructSize != res.size())
+			return eInputWrongStructSize;
+
+		// Выделяем память для структуры с описанием базы
+		m_AdditionalInfo = (TAdditionalInfo*)sldMemNewZero(sizeof(*m_AdditionalInfo));
+		if (!m_AdditionalInfo)
+			return eMemoryNotEnoughMemory;
+
+		// Копируем данные
+		sldMemMove(m_AdditionalInfo, tmpAdditionalInfo, tmpAdditionalInfo->StructSize);
+	}
+
+	// Загружаем аннотацию к базе
+	res = m_data.GetResource(SLD_RESOURCE_INFO, eInfoIndex_Annotation);
+	if (res)
+	{
+		// Выделяем память для аннотации
+		m_Annotation = (UInt16*)sldMemNewZero(res.size());
+		if (!m_Annotation)
+			return eMemoryNotEnoughMemory;
+
+		// Копируем данные
+		sldMemMove(m_Annotation, res.ptr(), res.size());
+	}
+
+	m_InitializedParts |= eLazyInit_AdditionalInfo;
+	return eOK;
+}
+
+/** *********************************************************************
+* Инициализирует систему сравнения строчек
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::InitCompare()
+{
+	return m_CMP.Open(m_data, m_Header->NumberOfLanguageSymbolsTable, m_Header->NumberOfLanguageDelimitersSymbolsTable);
+}
+
+/** *********************************************************************
+* Инициализирует менеджер морфологий (если в базе есть данные морфологии)
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::InitMorphology()
+{
+	if (m_InitializedParts & eLazyInit_Morphology)
+		return eOK;
+
+	if (m_Header->HasMorphologyData)
+	{
+		auto manager = sld2::make_unique<CSldMorphology>();
+		if (!manager)
+			return eMemoryNotEnoughMemory;
+
+		ESldError error = manager->Init(m_data);
+		if (error != eOK)
+			return error;
+
+		m_MorphologyManager = sld2::move(manager);
+	}
+
+	m_InitializedParts |= eLazyInit_Morphology;
+	return eOK;
+}
+
+/** *********************************************************************
+* Инициализирует переводы, локализованные строчки, таблицу атомарных объектов
+* и менеджеры метаданных
+*
+* Инициализация выполняется один раз при первом обращении к любой из этих подсистем;
+* ее результат запоминается, и все последующие вызовы возвращают ту же ошибку
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::InitContent() const
+{
+	if (m_InitializedParts & eLazyInit_Content)
+		return m_ContentError;
+
+	m_InitializedParts |= eLazyInit_Content;
+
+	ESldError (CSldDictionary::*const initParts[])() const = {
+		&CSldDictionary::InitArticles,
+		&CSldDictionary::InitLocalizedStrings,
+		&CSldDictionary::InitAtomicInfo,
+		&CSldDictionary::InitMetadataManager,
+		&CSldDictionary::InitCSSDataManager
+	};
+	for (auto initPart : initParts)
+	{
+		m_ContentError = (this->*initPart)();
+		if (m_ContentError != eOK)
+			break;
+	}
+	return m_ContentError;
+}
+
+/** *********************************************************************
+* Инициализирует переводы (если в базе есть статьи)
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::InitArticles() const
+{
+	if (m_Header->NumberOfArticles)
+	{
+		ESldError error;
+		auto articles = sld2::make_unique<CSldArticles>(*this, *m_LayerAccess, m_data, *m_Header, error);
+		if (!articles)
+			return eMemoryNotEnoughMemory;
+		if (error != eOK)
+			return error;
+
+		// Регистрационные данные к этому моменту уже загружены в InitRegistration()
+		error = articles->SetRegisterData(&m_RegistrationData);
+		if (error != eOK)
+			return error;
+
+		m_Articles = sld2::move(articles);
+	}
+
+	return eOK;
+}
+
+/** *********************************************************************
+* Загружает локализованные строчки словаря
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::InitLocalizedStrings() const
+{
+	ESldError error;
+	auto strings = sld2::make_unique<CSldLocalizedString>(m_data, m_Header->NumberOfStringsLanguages, error);
+	if (!strings)
+		return eMemoryNotEnoughMemory;
+	if (error != eOK)
+		return error;
+
+	m_Strings = sld2::move(strings);
+	return eOK;
+}
+
+/** *********************************************************************
+* Загружает таблицу с информацией об атомарных объектах
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::InitAtomicInfo() const
+{
+	auto res = m_data.GetResource(SLD_AO_ARTICLE_TABLE, 0);
 	if (res && res.size())
 	{
+		m_AtomicInfo = (TAtomicObjectInfo*)sldMemNew(res.size());
+		if (!m_AtomicInfo)
+			return eMemoryNotEnoughMemory;
+
+		sldMemMove(m_AtomicInfo, res.ptr(), res.size());
+	}
+
+	return eOK;
+}
+
+/** *********************************************************************
+* Инициализирует менеджер структурированных метаданных
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::InitMetadataManager() const
+{
+	auto res = m_data.GetResource(SLD_RESOURCE_STRUCTURED_METADATA_HEADER, 0);
+	if (res && res.size())
+	{
+		ESldError error;
 		auto manager = sld2::make_unique<CSldMetadataManager>(m_data, res.resource(), error);
-		if (!manager || error != eOK)
-		{
-			Close();
-			return manager ? error : eMemoryNotEnoughMemory;
-		}
+		if (!manager)
+			return eMemoryNotEnoughMemory;
+		if (error != eOK)
+			return error;
 
 		m_MetadataManager = sld2::move(manager);
 		// there is no point initializing the list index if there are no structured metadata
@@ -291,26 +457,50 @@ ESldError CSldDictionary::Open(ISDCFile *aFile, ISldLayerAccess *aLayerAccess)
 		m_MetadataStringsListIndex = FindListIndex(eWordListType_StructuredMetadataStrings);
 	}
 
-	// Инициализация менеджера css метаданных
-	res = m_data.GetResource(SLD_RESOURCE_CSS_DATA_HEADER, 0);
+	return eOK;
+}
+
+/** *********************************************************************
+* Инициализирует менеджер css метаданных
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::InitCSSDataManager() const
+{
+	auto res = m_data.GetResource(SLD_RESOURCE_CSS_DATA_HEADER, 0);
 	if (res && res.size())
 	{
-		auto manager = sld2::make_unique<CSldCSSDataManager>(*this, m_data, res.resource(), error);
-		if (!manager || error != eOK)
-		{
-			Close();
-			return manager ? error : eMemoryNotEnoughMemory;
-		}
+		ESldError error;
+		auto manager = sld2::make_unique<CSldCSSDataManager>(m_data, res.resource(), error);
+		if (!manager)
+			return eMemoryNotEnoughMemory;
+		if (error != eOK)
+			return error;
 
 		m_cssDataManager = sld2::move(manager);
 		m_cssDataStringsListIndex = FindListIndex(eWordListType_CSSDataStrings);
 	}
-	
-	// Выбираем метод для декодирования озвучки
-	m_SoundBuilder[1] = &ISldLayerAccess::BuildSoundWrong;
-	m_SoundBuilder[2] = &ISldLayerAccess::BuildSoundRight;
-	SLD_VALIDATE_SECURITY(&m_RegistrationData, &m_RandomSeed, m_SoundBuilder);
-	
+
+	return eOK;
+}
+
+/** *********************************************************************
+* Инициализирует все базовые списки слов словаря
+*
+* Нужно перед передачей массива списков слов классам, которые обращаются
+* к произвольным спискам по индексу (полнотекстовый поиск, пользовательские списки)
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::InitAllWordLists()
+{
+	for (UInt32 i = 0; i < GetDictionaryHeader()->NumberOfLists; i++)
+	{
+		ISldList* pList = 0;
+		ESldError error = GetWordList(i, &pList);
+		if (error != eOK)
+			return error;
+	}
 	return eOK;
 }
 
@@ -411,6 +601,82 @@ ESldError CSldDictionary::Close(void)
 	return eOK;
 }
 
+/** *********************************************************************
+* Возвращает счетчики производительности, собранные с момента открытия словаря
+* или последнего сброса счетчиков
+*
+* @param[out]	aStatistics	- указатель на структуру, куда будут помещены счетчики
+*
+* @return error code (eCommonStatisticsNotAvailable, если ядро собрано без SLD__HAVE_STATISTICS)
+************************************************************************/
+ESldError CSldDictionary::GetStatistics(TSldStatistics *aStatistics) const
+{
+	if (!aStatistics)
+		return eMemoryNullPointer;
+
+#ifdef SLD__HAVE_STATISTICS
+	*aStatistics = m_Statistics;
+	return eOK;
+#else
+	return eCommonStatisticsNotAvailable;
+#endif
+}
+
+/** *********************************************************************
+* Сбрасывает счетчики производительности
+*
+* @return error code (eCommonStatisticsNotAvailable, если ядро собрано без SLD__HAVE_STATISTICS)
+************************************************************************/
+ESldError CSldDictionary::ResetStatistics()
+{
+#ifdef SLD__HAVE_STATISTICS
+	m_Statistics.Clear();
+	return eOK;
+#else
+	return eCommonStatisticsNotAvailable;
+#endif
+}
+
+/** *********************************************************************
+* Возвращает счетчики арены временных буферов операций словаря
+*
+* @return счетчики арены (нули, если ядро собрано без SLD__HAVE_SCRATCH_ARENA)
+************************************************************************/
+sld2::ArenaStats CSldDictionary::GetScratchArenaStats() const
+{
+#ifdef SLD__HAVE_SCRATCH_ARENA
+	return m_ScratchArena.stats();
+#else
+	sld2::ArenaStats stats;
+	sldMemZero(&stats, sizeof(stats));
+	return stats;
+#endif
+}
+
+/** *********************************************************************
+* Освобождает память, которую арена временных буферов удерживает между операциями
+************************************************************************/
+void CSldDictionary::ReleaseScratchMemory()
+{
+#ifdef SLD__HAVE_SCRATCH_ARENA
+	m_ScratchArena.release();
+#endif
+}
+
+/** *********************************************************************
+* Включает проверку контрольной суммы каждого ресурса при его первой загрузке
+* (вместо проверки всего контейнера целиком через CSDCReadMy::CheckData())
+*
+* Должен вызываться до открытия словаря, для контейнеров без контрольных сумм
+* ресурсов ничего не делает
+*
+* @param[in]	aEnable	- флаг включения проверки
+************************************************************************/
+void CSldDictionary::SetResourceVerification(bool aEnable)
+{
+	m_data.SetResourceVerification(aEnable);
+}
+
 /** *********************************************************************
 * Устанавливает список слов в качестве текущего; таблица сравнения также
 * переключается на язык нового списка
@@ -780,6 +1046,8 @@ ESldError CSldDictionary::GetWordByIndex(Int32 aWordIndex)
 ************************************************************************/
 ESldError CSldDictionary::GetWordByIndex(Int32 aListIndex, Int32 aWordIndex)
 {
+	SLD_STATISTICS_SCOPE(m_LayerAccess, eStatisticsOperation_GetWordByIndex);
+
 	ISldList* pList = 0;
 	ESldError error = GetWordList(aListIndex, &pList);
 	if (error != eOK)
@@ -852,39 +1120,89 @@ ESldError CSldDictionary::GetWordByGlobalIndex(Int32 aGlobalWordIndex)
 * Получает слово по номеру списка слов, глобальному номеру слова в списке слов и
 * номеру варианта написания; меняет состояние иерархии
 *
-* @param[in]	aListIndex			- word list number
-* @param[in]	aGlobalWordIndex	- глобальный номер слова
-* @param[in]	aVariantIndex		- номер варианта написания в списке слов
-* @param[out]	aWord				- указатель, по которому записывается указатель на слово
+* @param[in]	aListIndex			- word list number
+* @param[in]	aGlobalWordIndex	- глобальный номер слова
+* @param[in]	aVariantIndex		- номер варианта написания в списке слов
+* @param[out]	aWord				- указатель, по которому записывается указатель на слово
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::GetWordByGlobalIndex(Int32 aListIndex, Int32 aGlobalWordIndex, Int32 aVariantIndex, UInt16** aWord)
+{
+	if (!aWord)
+		return eMemoryNullPointer;
+
+	*aWord = 0;
+	
+	ISldList* pList = 0;
+	ESldError error = GetWordList(aListIndex, &pList);
+	if (error != eOK)
+		return error;
+	
+	if (!pList)
+		return eMemoryNullPointer;
+	
+	error = pList->GoToByGlobalIndex(aGlobalWordIndex);
+	if (error != eOK)
+		return error;
+
+	// @todo delete
+	// если список с иерархией и переход к слову происходит по глобальному индексу, то текущий индекс списка
+	// более не будет синхронизирован с состоянием каталога и базовым индексом
+	//if (pList->HasHierarchy())
+	//	pList->SetCatalogSynchronizedFlag(0);
+	
+	return pList->GetCurrentWord(aVariantIndex, aWord);
+}
+
+/** *********************************************************************
+* Устанавливает емкость кэша декодированных слов списка слов
+* Кэш поддерживают только обычные списки слов
+*
+* @param[in]	aListIndex	- word list number
+* @param[in]	aCapacity	- количество кэшируемых слов; 0 отключает кэш
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::SetDecodedWordsCacheSize(Int32 aListIndex, UInt32 aCapacity)
+{
+	ISldList* pList = 0;
+	ESldError error = GetWordList(aListIndex, &pList);
+	if (error != eOK)
+		return error;
+
+	if (!pList)
+		return eMemoryNullPointer;
+
+	if (pList->GetHereditaryListType() != eHereditaryListTypeNormal)
+		return eCommonWrongList;
+
+	return ((CSldList*)pList)->SetDecodedWordsCacheSize(aCapacity);
+}
+
+/** *********************************************************************
+* Включает или выключает кэш сигнатур слов списка слов для поиска по шаблону
+* Кэш поддерживают только обычные списки слов
+*
+* @param[in]	aListIndex	- word list number
+* @param[in]	aEnable		- true - включить кэш, false - выключить и освободить память
 *
 * @return error code
 ************************************************************************/
-ESldError CSldDictionary::GetWordByGlobalIndex(Int32 aListIndex, Int32 aGlobalWordIndex, Int32 aVariantIndex, UInt16** aWord)
+ESldError CSldDictionary::SetWildCardSignaturesCache(Int32 aListIndex, bool aEnable)
 {
-	if (!aWord)
-		return eMemoryNullPointer;
-
-	*aWord = 0;
-	
 	ISldList* pList = 0;
 	ESldError error = GetWordList(aListIndex, &pList);
 	if (error != eOK)
 		return error;
-	
+
 	if (!pList)
 		return eMemoryNullPointer;
-	
-	error = pList->GoToByGlobalIndex(aGlobalWordIndex);
-	if (error != eOK)
-		return error;
 
-	// @todo delete
-	// если список с иерархией и переход к слову происходит по глобальному индексу, то текущий индекс списка
-	// более не будет синхронизирован с состоянием каталога и базовым индексом
-	//if (pList->HasHierarchy())
-	//	pList->SetCatalogSynchronizedFlag(0);
-	
-	return pList->GetCurrentWord(aVariantIndex, aWord);
+	if (pList->GetHereditaryListType() != eHereditaryListTypeNormal)
+		return eCommonWrongList;
+
+	return ((CSldList*)pList)->SetWildCardSignaturesCache(aEnable);
 }
 
 /** *********************************************************************
@@ -909,6 +1227,9 @@ ESldError CSldDictionary::GetWordByText(const UInt16* aText)
 ************************************************************************/
 ESldError CSldDictionary::GetWordByText(Int32 aListIndex, const UInt16* aText)
 {
+	SLD_STATISTICS_SCOPE(m_LayerAccess, eStatisticsOperation_GetWordByText);
+	SLD_SCRATCH_SCOPE();
+
 	ISldList* pList = 0;
 	ESldError error = GetWordList(aListIndex, &pList);
 	if (error != eOK)
@@ -2280,6 +2601,29 @@ ESldError CSldDictionary::GetNumberOfLists(Int32* aNumberOfLists) const
 	return eOK;
 }
 
+/** *********************************************************************
+* Проверяет, что список слов записан в словаре и его содержимое не меняется
+*
+* Поисковые и пользовательские списки добавляются после списков словаря
+* и пересоздаются под тем же индексом
+*
+* @param[in]	aListIndex	- номер списка слов
+*
+* @return true, если список статический
+************************************************************************/
+bool CSldDictionary::IsStaticList(Int32 aListIndex) const
+{
+	if (!m_Header || aListIndex < 0 || (UInt32)aListIndex >= m_Header->NumberOfLists)
+		return false;
+
+	const CSldListInfo* listInfo = NULL;
+	if (GetWordListInfo(aListIndex, &listInfo) != eOK)
+		return false;
+
+	const UInt32 listUsage = listInfo->GetUsage();
+	return listUsage != eWordListType_RegularSearch && listUsage != eWordListType_CustomList;
+}
+
 /** *********************************************************************
 * Определяет, имеет или нет слово с локальным номером в текущем списке слов поддерево иерархии
 *
@@ -2538,6 +2882,10 @@ ESldError CSldDictionary::GetAdditionalInfo(TAdditionalInfo *aAdditionalInfo)
 	if (!aAdditionalInfo)
 		return eMemoryNullPointer;
 
+	ESldError error = InitAdditionalInfo();
+	if (error != eOK)
+		return error;
+
 	if (m_AdditionalInfo)
 		*aAdditionalInfo = *m_AdditionalInfo;
 
@@ -2563,6 +2911,10 @@ ESldError CSldDictionary::GetAnnotation(UInt16 **aAnnotation)
 	if (!(aAnnotation && *aAnnotation))
 		return eMemoryNullPointer;
 
+	ESldError error = InitAdditionalInfo();
+	if (error != eOK)
+		return error;
+
 	const Int32 iAnnotationLength = CSldCompare::StrLen(m_Annotation) + 1;
 	const Int32 iAnnotationSize = iAnnotationLength * sizeof((*aAnnotation)[0]);
 
@@ -3029,6 +3381,9 @@ ESldError CSldDictionary::Translate(Int32 aIndex, Int32 aVariantIndex, ESldTrans
 ************************************************************************/
 ESldError CSldDictionary::Translate(Int32 aListIndex, Int32 aIndex, Int32 aVariantIndex, ESldTranslationFullnesType aFullness, UInt32 aStartBlock, UInt32 aEndBlock)
 {
+	SLD_STATISTICS_SCOPE(m_LayerAccess, eStatisticsOperation_Translate);
+	SLD_SCRATCH_SCOPE();
+
 	Int32 globalIndex = aIndex;
 	ESldError error = LocalIndex2GlobalIndex(aListIndex, aIndex, &globalIndex);
 	if (error != eOK)
@@ -3070,6 +3425,10 @@ ESldError CSldDictionary::Translate(Int32 aListIndex, Int32 aIndex, Int32 aVaria
 	if (error != eOK)
 		return error;
 
+	error = InitContent();
+	if (error != eOK)
+		return error;
+
 	Int32 ArticleIndex = 0;
 	if (listType == eWordListType_Atomic && m_AtomicInfo)
 	{
@@ -3107,6 +3466,10 @@ ESldError CSldDictionary::Translate(Int32 aListIndex, Int32 aIndex, Int32 aVaria
 ************************************************************************/
 ESldError CSldDictionary::TranslateByArticleIndex(Int32 aIndex, ESldTranslationFullnesType aFullness, UInt32 aStartBlock, UInt32 aEndBlock)
 {
+	ESldError error = InitContent();
+	if (error != eOK)
+		return error;
+
 	if (m_Articles == NULL)
 		return eCommonDictionaryHasNoTranslations;
 	return m_Articles->Translate(aIndex, aFullness, aStartBlock, aEndBlock);
@@ -3121,6 +3484,10 @@ ESldError CSldDictionary::TranslateByArticleIndex(Int32 aIndex, ESldTranslationF
 ************************************************************************/
 ESldError CSldDictionary::TranslateContinue(ESldTranslationFullnesType aFullness)
 {
+	ESldError error = InitContent();
+	if (error != eOK)
+		return error;
+
 	if (m_Articles == NULL)
 		return eCommonDictionaryHasNoTranslations;
 	return m_Articles->TranslateContinue(aFullness);
@@ -3135,6 +3502,10 @@ ESldError CSldDictionary::TranslateContinue(ESldTranslationFullnesType aFullness
 ************************************************************************/
 ESldError CSldDictionary::TranslateClear()
 {
+	ESldError error = InitContent();
+	if (error != eOK)
+		return error;
+
 	if (m_Articles == NULL)
 		return eCommonDictionaryHasNoTranslations;
 
@@ -3713,6 +4084,11 @@ ESldError CSldDictionary::GetStyleInfo(Int32 aIndex, const CSldStyleInfo **aStyl
 {
 	if (!aStyleInfo)
 		return eMemoryNullPointer;
+
+	ESldError error = InitContent();
+	if (error != eOK)
+		return error;
+
 	if (m_Articles == NULL)
 		return eCommonDictionaryHasNoTranslations;
 
@@ -3722,10 +4098,13 @@ ESldError CSldDictionary::GetStyleInfo(Int32 aIndex, const CSldStyleInfo **aStyl
 /** *********************************************************************
 * Возвращает количество стилей
 *
-* @return количество стилей
+* @return количество стилей (0, если переводы не удалось загрузить)
 ************************************************************************/
 UInt32 CSldDictionary::GetNumberOfStyles() const
 {
+	if (InitContent() != eOK)
+		return 0;
+
 	return m_Articles ? m_Articles->GetNumberOfStyles() : 0;
 }
 
@@ -3739,10 +4118,14 @@ UInt32 CSldDictionary::GetNumberOfStyles() const
 ************************************************************************/
 ESldError CSldDictionary::SetDefaultStyleVariant(Int32 aStyleIndex, Int32 aVariantIndex)
 {
+	ESldError error = InitContent();
+	if (error != eOK)
+		return error;
+
 	if (m_Articles == NULL)
 		return eCommonDictionaryHasNoTranslations;
 	
-	ESldError error = m_Articles->SetDefaultStyleVariant(aStyleIndex, aVariantIndex);
+	error = m_Articles->SetDefaultStyleVariant(aStyleIndex, aVariantIndex);
 	if (error != eOK)
 		return error;
 	
@@ -3759,12 +4142,16 @@ ESldError CSldDictionary::SetDefaultStyleVariant(Int32 aStyleIndex, Int32 aVaria
 ************************************************************************/
 ESldError CSldDictionary::SetDefaultStyleVariant(Int32 aVariantIndex)
 {
+	ESldError error = InitContent();
+	if (error != eOK)
+		return error;
+
 	if (m_Articles == NULL)
 		return eCommonDictionaryHasNoTranslations;
 
 	Int32 numberOfStyles;
 
-	ESldError error = GetStylesWithStressVariants(NULL, &numberOfStyles);
+	error = GetStylesWithStressVariants(NULL, &numberOfStyles);
 	if (error != eOK)
 		return error;
 	
@@ -3808,6 +4195,10 @@ ESldError CSldDictionary::GetLocalizedStrings(const CSldLocalizedString** aStrin
 	if (!aStrings)
 		return eMemoryNullPointer;
 
+	ESldError error = InitContent();
+	if (error != eOK)
+		return error;
+
 	*aStrings = m_Strings.get();
 
 	return eOK;
@@ -3886,6 +4277,9 @@ ESldError CSldDictionary::DoWildCardSearch(TExpressionBox* aExpressionBox, Int32
 ************************************************************************/
 ESldError CSldDictionary::DoWildCardSearch(Int32 aListIndex, TExpressionBox* aExpressionBox, Int32 aMaximumWords)
 {
+	SLD_STATISTICS_SCOPE(m_LayerAccess, eStatisticsOperation_WildCardSearch);
+	SLD_SCRATCH_SCOPE();
+
 	if (!aExpressionBox)
 		return eMemoryNullPointer;
 
@@ -3951,6 +4345,8 @@ ESldError CSldDictionary::DoWildCardSearch(Int32 aListIndex, TExpressionBox* aEx
 	if (error != eOK)
 		return error;
 
+	pSearchList->SetSearchContext(GetSearchContext());
+
 	// Устанавливаем максимальное количество списков, в которых мы можем производить поиск
 	error = pSearchList->SetMaximumLists(ListCount);
 	if (error != eOK)
@@ -4019,6 +4415,9 @@ ESldError CSldDictionary::DoFuzzySearch(const UInt16 *aText, Int32 aMaximumWords
 ************************************************************************/
 ESldError CSldDictionary::DoFuzzySearch(Int32 aListIndex, const UInt16 *aText, Int32 aMaximumWords, Int32 aMaximumDifference, EFuzzySearchMode aSearchMode)
 {
+	SLD_STATISTICS_SCOPE(m_LayerAccess, eStatisticsOperation_FuzzySearch);
+	SLD_SCRATCH_SCOPE();
+
 	if (!aText)
 		return eMemoryNullPointer;
 	
@@ -4082,6 +4481,8 @@ ESldError CSldDictionary::DoFuzzySearch(Int32 aListIndex, const UInt16 *aText, I
 	error = pSearchList->Init(m_data, GetLayerAccess(), listInfo, NULL, 0);
 	if (error != eOK)
 		return error;
+
+	pSearchList->SetSearchContext(GetSearchContext());
 	
 	// Устанавливаем максимальное количество списков, в которых мы можем производить поиск
 	error = pSearchList->SetMaximumLists(ListCount);
@@ -4141,6 +4542,9 @@ ESldError CSldDictionary::DoAnagramSearch(const UInt16 *aText, Int32 aMaximumWor
 ************************************************************************/
 ESldError CSldDictionary::DoAnagramSearch(Int32 aListIndex, const UInt16 *aText, Int32 aMaximumWords)
 {
+	SLD_STATISTICS_SCOPE(m_LayerAccess, eStatisticsOperation_AnagramSearch);
+	SLD_SCRATCH_SCOPE();
+
 	if (!aText)
 		return eMemoryNullPointer;
 	
@@ -4182,6 +4586,8 @@ ESldError CSldDictionary::DoAnagramSearch(Int32 aListIndex, const UInt16 *aText,
 	if (error != eOK)
 		return error;
 
+	pSearchList->SetSearchContext(GetSearchContext());
+
 	// Устанавливаем максимальное количество списков, в которых мы можем производить поиск
 	error = pSearchList->SetMaximumLists(ListCount);
 	if (error != eOK)
@@ -4253,6 +4659,9 @@ ESldError CSldDictionary::DoSpellingSearch(const UInt16 *aText, Int32 aMaximumWo
 ************************************************************************/
 ESldError CSldDictionary::DoSpellingSearch(Int32 aListIndex, const UInt16 *aText, Int32 aMaximumWords)
 {
+	SLD_STATISTICS_SCOPE(m_LayerAccess, eStatisticsOperation_SpellingSearch);
+	SLD_SCRATCH_SCOPE();
+
 	if (!aText)
 		return eMemoryNullPointer;
 	
@@ -4294,6 +4703,8 @@ ESldError CSldDictionary::DoSpellingSearch(Int32 aListIndex, const UInt16 *aText
 	if (error != eOK)
 		return error;
 
+	pSearchList->SetSearchContext(GetSearchContext());
+
 	// Устанавливаем максимальное количество списков, в которых мы можем производить поиск
 	error = pSearchList->SetMaximumLists(ListCount);
 	if (error != eOK)
@@ -4365,6 +4776,9 @@ ESldError CSldDictionary::DoFullTextSearch(const UInt16* aText, Int32 aMaximumWo
 ************************************************************************/
 ESldError CSldDictionary::DoFullTextSearch(Int32 aListIndex, const UInt16* aText, Int32 aMaximumWords)
 {
+	SLD_STATISTICS_SCOPE(m_LayerAccess, eStatisticsOperation_FullTextSearch);
+	SLD_SCRATCH_SCOPE();
+
 	if (!aText)
 		return eMemoryNullPointer;
 	
@@ -4423,7 +4837,13 @@ ESldError CSldDictionary::DoFullTextSearch(Int32 aListIndex, const UInt16* aText
 	error = pSearchList->Init(m_data, GetLayerAccess(), listInfo, NULL, 0);
 	if (error != eOK)
 		return error;
+
+	pSearchList->SetSearchContext(GetSearchContext());
 	
+	error = InitAllWordLists();
+	if (error != eOK)
+		return error;
+
 	// Производим поиск
 	ESldError searchError = pSearchList->DoFullTextSearch(aText, aMaximumWords, GetLists(), GetDictionaryHeader()->NumberOfLists, aListIndex);
 	// Восстанавливаем ранее сохраненное состояние списков слов (независимо от того, успешно выполнился поиск или нет)
@@ -4467,6 +4887,9 @@ ESldError CSldDictionary::DoFullTextSearch(Int32 aListIndex, const UInt16* aText
 ************************************************************************/
 ESldError CSldDictionary::SortSearchListRelevant(Int32 aListIndex, const UInt16* aText, const CSldVector<TSldMorphologyWordStruct>& aMorphologyForms, ESldFTSSortingTypeEnum aMode)
 {
+	SLD_STATISTICS_SCOPE(m_LayerAccess, eStatisticsOperation_SortSearchListRelevant);
+	SLD_SCRATCH_SCOPE();
+
 	if (!aText)
 		return eMemoryNullPointer;
 	
@@ -4838,14 +5261,11 @@ ESldError CSldDictionary::InitRegistration(void)
 			return error;
 	}
 
+	// Списки слов, которые еще не были проинициализированы, получат HASH при инициализации
 	for (UInt32 i = 0; i < GetDictionaryHeader()->NumberOfLists; i++)
 	{
-		ISldList* pList = 0;
-		ESldError error = GetWordList(i, &pList);
-		if (error != eOK)
-			return error;
-
-		if (pList)
+		ISldList* pList = m_List ? m_List[i] : NULL;
+		if (pList && pList->isInit())
 		{
 			error = pList->SetHASH(m_RegistrationData.HASH);
 			if (error != eOK)
@@ -5501,6 +5921,8 @@ ESldError CSldDictionary::GetWordByTextExtended(const UInt16* aText, UInt32* aRe
 ************************************************************************/
 ESldError CSldDictionary::GetWordByTextExtended(Int32 aListIndex, const UInt16* aText, UInt32* aResultFlag, UInt32 aActionsOnFailFlag)
 {
+	SLD_SCRATCH_SCOPE();
+
 	*aResultFlag = 0;
 	Int32 listCount;
 	ESldError error = GetNumberOfLists(&listCount);
@@ -5863,12 +6285,27 @@ ESldError CSldDictionary::UpdateHistoryElementInList(CSldHistoryElement* aHistor
 	if (*aResultFlag == eHistoryNotCompare)
 		return eOK;
 
+	return UpdateHistoryElementIndex(aHistoryElement, aListIndex, globalIndex);
+}
+
+/** *********************************************************************
+* Переносит элемент истории на найденное для него слово
+*
+* @param[in]	aHistoryElement		- элемент истории
+* @param[in]	aListIndex			- индекс списка, в котором было найдено слово
+* @param[in]	aGlobalIndex		- индекс найденного слова
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::UpdateHistoryElementIndex(CSldHistoryElement* aHistoryElement, const Int32 aListIndex, const Int32 aGlobalIndex)
+{
+	ESldError error = eOK;
 	if (aHistoryElement->GetListIndex() != aListIndex)
 	{
 		aHistoryElement->SetListIndex(aListIndex);
 	}
 
-	if (aHistoryElement->GetWordIndex() != globalIndex)
+	if (aHistoryElement->GetWordIndex() != (UInt32)aGlobalIndex)
 	{
 		UInt32 date = 0;
 		UInt32 time = 0;
@@ -5896,7 +6333,7 @@ ESldError CSldDictionary::UpdateHistoryElementInList(CSldHistoryElement* aHistor
 			return error;
 
 		CSldVector<CSldHistoryElement> hElement;
-		error = GetHistoryElement(globalIndex, hElement);
+		error = GetHistoryElement(aGlobalIndex, hElement);
 		if (error != eOK)
 			return error;
 
@@ -5943,32 +6380,167 @@ ESldError CSldDictionary::UpdateHistoryElement(CSldHistoryElement* aHistoryEleme
 	if (aHistoryElement->GetDictID() != GetDictionaryHeader()->DictID)
 		return eOK;
 
-	ESldError error = eOK;
 	CSldVector<Int32> listIndexes;
-	for (Int32 listIndex = 0; listIndex < GetDictionaryHeader()->NumberOfLists; listIndex++)
+	ESldError error = GetHistoryElementLists(*aHistoryElement, listIndexes);
+	if (error != eOK)
+		return error;
+
+	for (auto listIndex : listIndexes)
 	{
-		const CSldListInfo* listInfo = NULL;
-		error = GetWordListInfo(listIndex, &listInfo);
+		error = UpdateHistoryElementInList(aHistoryElement, listIndex, aResultFlag);
+		if (error != eOK)
+			return error;
+
+		if (*aResultFlag != eHistoryNotCompare)
+			return eOK;
+	}
+
+	return eOK;
+}
+
+/** *********************************************************************
+* Обновляет набор элементов истории до текущего состояния базы
+*
+* Результат для каждого элемента совпадает с результатом UpdateHistoryElement(), но элементы, сохраненные
+* для одного списка, проверяются вместе: сначала за один проход по списку в порядке индексов слов,
+* затем ненайденные - поиском по тексту в порядке сортировки. Так же, как и UpdateHistoryElement(),
+* функция не восстанавливает состояние списков
+*
+* @param[in]	aHistoryElements	- элементы истории, элементы других словарей пропускаются
+* @param[out]	aResultFlags		- массив размером с aHistoryElements, куда будут записаны результаты
+*									  для каждого элемента (см. #ESldHistoryResult)
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::UpdateHistoryElements(sld2::Span<CSldHistoryElement> aHistoryElements, ESldHistoryResult* aResultFlags)
+{
+	if (!aResultFlags)
+		return eMemoryNullPointer;
+
+	const Int32 numberOfLists = GetDictionaryHeader()->NumberOfLists;
+	CSldVector<CSldVector<UInt32>> listElements(numberOfLists);
+
+	ESldError error;
+	CSldVector<Int32> listIndexes;
+	for (UInt32 elementIndex = 0; elementIndex < aHistoryElements.size(); elementIndex++)
+	{
+		CSldHistoryElement & element = aHistoryElements[elementIndex];
+		aResultFlags[elementIndex] = eHistoryNotCompare;
+		if (element.GetDictID() != GetDictionaryHeader()->DictID)
+			continue;
+
+		error = GetHistoryElementLists(element, listIndexes);
+		if (error != eOK)
+			return error;
+
+		if (listIndexes.empty())
+			continue;
+
+		// Пакетом проверяются только элементы, у которых сохраненный список подходит для восстановления
+		const Int32 listIndex = listIndexes.front();
+		ISldList* pList = NULL;
+		error = GetWordList(listIndex, &pList);
 		if (error != eOK)
 			return error;
 
-		if (listInfo->GetLanguageFrom() == aHistoryElement->GetLanguageCode() && CheckType(aHistoryElement->GetListType(), listInfo->GetUsage()))
+		if (listIndex == element.GetListIndex() && pList && pList->GetHereditaryListType() == eHereditaryListTypeNormal)
 		{
-			if (listIndex == aHistoryElement->GetListIndex())
-				listIndexes.insert(0, listIndex);
-			else
-				listIndexes.push_back(listIndex);
+			listElements[listIndex].push_back(elementIndex);
+			continue;
 		}
+
+		error = UpdateHistoryElement(&element, &aResultFlags[elementIndex]);
+		if (error != eOK)
+			return error;
 	}
 
-	for (auto listIndex : listIndexes)
+	CSldVector<CSldHistoryElement*> elements;
+	CSldVector<ESldHistoryResult> resultFlags;
+	CSldVector<Int32> globalIndexes;
+	for (Int32 listIndex = 0; listIndex < numberOfLists; listIndex++)
 	{
-		error = UpdateHistoryElementInList(aHistoryElement, listIndex, aResultFlag);
+		const auto & elementIndexes = listElements[listIndex];
+		if (elementIndexes.empty())
+			continue;
+
+		ISldList* pList = NULL;
+		error = GetWordList(listIndex, &pList);
 		if (error != eOK)
 			return error;
 
-		if (*aResultFlag != eHistoryNotCompare)
-			return eOK;
+		elements.clear();
+		for (UInt32 elementIndex : elementIndexes)
+			elements.push_back(&aHistoryElements[elementIndex]);
+
+		resultFlags.resize(elements.size());
+		globalIndexes.resize(elements.size());
+		error = ((CSldList*)pList)->GetWordsByHistoryElements(elements, resultFlags.data(), globalIndexes.data());
+		if (error != eOK)
+			return error;
+
+		for (UInt32 i = 0; i < elements.size(); i++)
+		{
+			CSldHistoryElement* element = elements[i];
+			ESldHistoryResult & resultFlag = aResultFlags[elementIndexes[i]];
+			if (resultFlags[i] != eHistoryNotCompare)
+			{
+				resultFlag = resultFlags[i];
+				error = UpdateHistoryElementIndex(element, listIndex, globalIndexes[i]);
+				if (error != eOK)
+					return error;
+
+				continue;
+			}
+
+			// Слово не нашлось в своем списке - ищем в остальных подходящих
+			error = GetHistoryElementLists(*element, listIndexes);
+			if (error != eOK)
+				return error;
+
+			for (Int32 otherListIndex : listIndexes)
+			{
+				if (otherListIndex == listIndex)
+					continue;
+
+				error = UpdateHistoryElementInList(element, otherListIndex, &resultFlag);
+				if (error != eOK)
+					return error;
+
+				if (resultFlag != eHistoryNotCompare)
+					break;
+			}
+		}
+	}
+
+	return eOK;
+}
+
+/** *********************************************************************
+* Возвращает списки, в которых может быть восстановлен элемент истории
+*
+* @param[in]	aHistoryElement		- элемент истории
+* @param[out]	aListIndexes		- индексы подходящих по языку и типу списков,
+*									  сохраненный в элементе список, если подходит, идет первым
+*
+* @return error code
+************************************************************************/
+ESldError CSldDictionary::GetHistoryElementLists(const CSldHistoryElement & aHistoryElement, CSldVector<Int32> & aListIndexes)
+{
+	aListIndexes.clear();
+	for (Int32 listIndex = 0; listIndex < GetDictionaryHeader()->NumberOfLists; listIndex++)
+	{
+		const CSldListInfo* listInfo = NULL;
+		ESldError error = GetWordListInfo(listIndex, &listInfo);
+		if (error != eOK)
+			return error;
+
+		if (listInfo->GetLanguageFrom() == aHistoryElement.GetLanguageCode() && CheckType(aHistoryElement.GetListType(), listInfo->GetUsage()))
+		{
+			if (listIndex == aHistoryElement.GetListIndex())
+				aListIndexes.insert(0, listIndex);
+			else
+				aListIndexes.push_back(listIndex);
+		}
 	}
 
 	return eOK;
@@ -6182,6 +6754,10 @@ ESldError CSldDictionary::FindWordBySpecificRule(Int32 aListIndex, const UInt16*
 ************************************************************************/
 ESldError CSldDictionary::GetMorphology(UInt32 aLanguageCode, MorphoData **aMorphoData, UInt32 aDictId /*= 0*/)
 {
+	ESldError error = InitMorphology();
+	if (error != eOK)
+		return error;
+
 	if (!m_MorphologyManager)
 		return eOK;
 
@@ -6203,7 +6779,7 @@ ESldError CSldDictionary::GetMorphology(UInt32 aLanguageCode, MorphoData **aMorp
 
 	// получаем смещение в файле до необходимой морфологии 
 	UInt32 resourceShift, resourceSize;
-	ESldError error = m_data.GetResourceShiftAndSize(&resourceShift, &resourceSize, RESOURCE_TYPE_MORPHOLOGY_DATA, resourceIndex);
+	error = m_data.GetResourceShiftAndSize(&resourceShift, &resourceSize, RESOURCE_TYPE_MORPHOLOGY_DATA, resourceIndex);
 	if (error != eOK)
 		return error;
 
@@ -6314,6 +6890,13 @@ ESldError CSldDictionary::GetCurrentWordStylizedVariant(Int32 aVariantIndex, Spl
 		return eMemoryNullPointer;
 
 	const Int32 articleIndex = pList->GetStylizedVariantArticleIndex(aVariantIndex);
+	if (articleIndex != SLD_INDEX_STYLIZED_VARIANT_NO)
+	{
+		error = InitContent();
+		if (error != eOK)
+			return error;
+	}
+
 	if (articleIndex != SLD_INDEX_STYLIZED_VARIANT_NO && m_Articles)
 	{
 		return m_Articles->GetArticle(articleIndex, aArticle);
@@ -6392,6 +6975,10 @@ ESldError CSldDictionary::AddCustomWordList(CSldCustomListControl* aListControl,
 	if (error != eOK)
 		return error;
 
+	error = InitAllWordLists();
+	if (error != eOK)
+		return error;
+
 	error = pCustomList->SetRealLists(GetLists(), listCount);
 	if (error != eOK)
 		return error;
@@ -6568,6 +7155,10 @@ ESldError CSldDictionary::GetSubwordsList(CSldCustomListControl* aListControl, I
 	if (error != eOK)
 		return error;
 
+	error = InitAllWordLists();
+	if (error != eOK)
+		return error;
+
 	CSldSearchWordResult resultWords;
 	error = resultWords.Init(GetLists(), listCount);
 	if (error != eOK)
@@ -7092,6 +7683,13 @@ ESldError CSldDictionary::GetAtomicObjectInfo(const Int32 aIndex, const TAtomicO
 	if (aIndex < 0 || aIndex >= listInfo->GetNumberOfGlobalWords())
 		return eCommonWrongIndex;
 
+	error = InitContent();
+	if (error != eOK)
+		return error;
+
+	if (!m_AtomicInfo)
+		return eCommonWrongIndex;
+
 	*aAtomicObject = &m_AtomicInfo[aIndex];
 
 	return eOK;
@@ -7420,6 +8018,62 @@ ESldError CSldDictionary::GetCurrentLocalizationIndex(Int32 & aIndex)
 	return pList->GetCurrentLocalizationIndex(aIndex);
 }
 
+/**
+ * Возвращает "менеджер" структурированных метаданных
+ *
+ * @param[out]  aManager - указатель, по которому будет записан указатель на менеджер
+ *                         или nullptr, если в словаре нет структурированных метаданных
+ *
+ * @return error code
+ */
+ESldError CSldDictionary::GetMetadataManager(CSldMetadataManager **aManager) const
+{
+	if (!aManager)
+		return eMemoryNullPointer;
+	*aManager = nullptr;
+
+	ESldError error = InitContent();
+	if (error != eOK)
+		return error;
+
+	*aManager = m_MetadataManager.get();
+	return eOK;
+}
+
+// Возвращает индекс листа со строчками структурированных метаданных
+Int32 CSldDictionary::GetMetadataStringsListIndex() const
+{
+	return InitContent() == eOK ? m_MetadataStringsListIndex : SLD_DEFAULT_LIST_INDEX;
+}
+
+/**
+ * Возвращает "менеджер" css метаданных
+ *
+ * @param[out]  aManager - указатель, по которому будет записан указатель на менеджер
+ *                         или nullptr, если в словаре нет css метаданных
+ *
+ * @return error code
+ */
+ESldError CSldDictionary::GetCSSDataManager(CSldCSSDataManager **aManager) const
+{
+	if (!aManager)
+		return eMemoryNullPointer;
+	*aManager = nullptr;
+
+	ESldError error = InitContent();
+	if (error != eOK)
+		return error;
+
+	*aManager = m_cssDataManager.get();
+	return eOK;
+}
+
+// Возвращает индекс листа со строчками css метаданных
+Int32 CSldDictionary::GetCSSDataStringsListIndex() const
+{
+	return InitContent() == eOK ? m_cssDataStringsListIndex : SLD_DEFAULT_LIST_INDEX;
+}
+
 /**
  * Возвращает строку с javascript'ом ассоциированным со статьями
  *
@@ -7600,13 +8254,17 @@ ESldError CSldDictionary::SetMergeInfo(const TMergedMetaInfo *aInfo, UInt32 aDic
 ************************************************************************/
 ESldError CSldDictionary::GetArticleLinks(const Int32 aListIndex, const Int32 aGlobalIndex, SldLinksCollection & aLinks)
 {
+	ESldError error = InitContent();
+	if (error != eOK)
+		return error;
+
 	if (m_Articles == NULL)
 		return eCommonDictionaryHasNoTranslations;
 
 	aLinks.clear();
 
 	ISldList* pList = NULL;
-	ESldError error = GetWordList(aListIndex, &pList);
+	error = GetWordList(aListIndex, &pList);
 	if (error != eOK)
 		return error;
 
@@ -4,6 +4,7 @@
 #include "SldVersionInfo.h"
 #include "SldError.h"
 #include "SldPlatform.h"
+#include "SldArena.h"
 #include "SldTypes.h"
 #include "SldCompare.h"
 #include "ISldList.h"
@@ -56,6 +57,32 @@ public:
 	// Closes the dictionary
 	virtual ESldError Close(void);
 
+	// Gets the performance counters collected since the dictionary was opened or since the last reset
+	// Returns eCommonStatisticsNotAvailable if the engine is built without SLD__HAVE_STATISTICS
+	ESldError GetStatistics(TSldStatistics *aStatistics) const;
+
+	// Resets the performance counters
+	ESldError ResetStatistics();
+
+	// Gets the counters of the arena holding temporary buffers of searches and translations
+	// All zeros if the engine is built without SLD__HAVE_SCRATCH_ARENA
+	sld2::ArenaStats GetScratchArenaStats() const;
+
+	// Frees the memory the scratch arena keeps for reuse between operations
+	void ReleaseScratchMemory();
+
+	// Enables checking every resource against its checksum when it is loaded for the first time
+	// Must be called before Open(), has no effect for containers without resource checksums
+	void SetResourceVerification(bool aEnable);
+
+	// Sets the search context (cancellation token, deadline and result limit) honoured by all
+	// of the subsequent searches. NULL disables it. The context is not owned by the dictionary
+	// and is dropped on Close(). See CSldSearchContext for details
+	void SetSearchContext(CSldSearchContext *aContext) { m_SearchContext = aContext; }
+
+	// Returns the current search context
+	CSldSearchContext* GetSearchContext() const { return m_SearchContext; }
+
 	// Gets the morphology for the given language code and optionally the morphology base id
 	ESldError GetMorphology(UInt32 aLanguageCode, MorphoData **aMorphoData, UInt32 aDictId = 0);
 
@@ -89,6 +116,11 @@ public:
 	// Gets a word by wordlist number, global word number in wordlist, and spelling number
 	ESldError GetWordByGlobalIndex(Int32 aListIndex, Int32 aGlobalWordIndex, Int32 aVariantIndex, UInt16** aWord);
 
+	// Sets the capacity of the decoded words cache of a word list (0 disables the cache)
+	ESldError SetDecodedWordsCacheSize(Int32 aListIndex, UInt32 aCapacity);
+	// Enables or disables the cache of word signatures used to speed up wildcard search in a word list
+	ESldError SetWildCardSignaturesCache(Int32 aListIndex, bool aEnable);
+
 	// Searches for the closest word in the current wordlist that is greater than or equal to the given word
 	ESldError GetWordByText(const UInt16* aText);
 	// Searches for the closest word in the specified word list that is greater than or equal to the given
@@ -256,6 +288,9 @@ public:
 	// Returns the number of wordlists.
 	virtual ESldError GetNumberOfLists(Int32 *aNumberOfLists) const;
 
+	// Проверяет, что список слов записан в словаре и не пересоздается (не поисковый и не пользовательский)
+	virtual bool IsStaticList(Int32 aListIndex) const;
+
 	// Возвращает флаг, имеет или нет слово с локальным номером в текущем списке слов поддерево иерархии
 	ESldError isWordHasHierarchy(Int32 aLocalWordIndex, UInt32* aIsHierarchy, EHierarchyLevelType* aLevelType = NULL);
 	// Возвращает флаг, имеет или нет слово с локальным номером в указанном списке слов поддерево иерархии
@@ -573,6 +608,9 @@ public:
 	// Обновляет элемент истории до текущего состояния базы
 	virtual ESldError UpdateHistoryElement(CSldHistoryElement* aHistoryElement, ESldHistoryResult* aResultFlag);
 
+	// Обновляет набор элементов истории до текущего состояния базы
+	virtual ESldError UpdateHistoryElements(sld2::Span<CSldHistoryElement> aHistoryElements, ESldHistoryResult* aResultFlags);
+
 	// Возвращает тип содержимого в контейнере
 	ESlovoEdContainerDatabaseTypeEnum GetDatabaseType(void) const;
 
@@ -636,16 +674,16 @@ public:
 	ESldError GetInitialWordIndexes(Int32 aListIndex, Int32 aLocalIndex, Int32* aInitialListIndex, Int32* aInitialWordIndex);
 
 	// Возвращает "менеджер" структурированных метаданных
-	CSldMetadataManager* GetMetadataManager() const { return m_MetadataManager.get(); }
+	ESldError GetMetadataManager(CSldMetadataManager **aManager) const;
 
 	// Возвращает индекс листа со строчками структурированных метаданных
-	Int32 GetMetadataStringsListIndex() const { return m_MetadataStringsListIndex; }
+	Int32 GetMetadataStringsListIndex() const;
 
 	// Возвращает "менеджер" css метаданных
-	CSldCSSDataManager* GetCSSDataManager() const { return m_cssDataManager.get(); }
+	ESldError GetCSSDataManager(CSldCSSDataManager **aManager) const;
 
 	// Возвращает индекс листа со строчками css метаданных
-	Int32 GetCSSDataStringsListIndex() const { return m_cssDataStringsListIndex; }
+	Int32 GetCSSDataStringsListIndex() const;
 
 	// Возвращает строку с javascript'ом ассоциированным со статьями
 	ESldError GetArticlesJavaScript(SldU16String &aString);
@@ -716,6 +754,12 @@ protected:
 	// Обновляет элемент истории до текущего состояния базы в заданном списке слов 
 	ESldError UpdateHistoryElementInList(CSldHistoryElement* aHistoryElement, const Int32 aListIndex, ESldHistoryResult* aResultFlag);
 
+	// Переносит элемент истории на найденное для него слово
+	ESldError UpdateHistoryElementIndex(CSldHistoryElement* aHistoryElement, const Int32 aListIndex, const Int32 aGlobalIndex);
+
+	// Возвращает списки, в которых может быть восстановлен элемент истории
+	ESldError GetHistoryElementLists(const CSldHistoryElement & aHistoryElement, CSldVector<Int32> & aListIndexes);
+
 	// Возвращает индекс первого листа заданного типа
 	Int32 FindListIndex(UInt32 aType) const;
 
@@ -756,8 +800,47 @@ protected:
 
 private:
 
+	// Подсистемы словаря, которые инициализируются не в Open(), а при первом обращении к ним
+	enum ELazyInitPart : UInt32
+	{
+		eLazyInit_AdditionalInfo	= 1 << 0,
+		eLazyInit_Morphology		= 1 << 1,
+		// Переводы, локализованные строчки, атомарные объекты и менеджеры метаданных (см. InitContent())
+		eLazyInit_Content			= 1 << 2
+	};
+
+	// Загружает дополнительную информацию о базе и аннотацию
+	ESldError InitAdditionalInfo();
+
+	// Инициализирует систему сравнения строчек
+	ESldError InitCompare();
+
+	// Инициализирует менеджер морфологий
+	ESldError InitMorphology();
+
+	// Один раз инициализирует подсистемы, доступные в том числе через константные методы
+	ESldError InitContent() const;
+
+	// Инициализирует переводы
+	ESldError InitArticles() const;
+
+	// Загружает локализованные строчки
+	ESldError InitLocalizedStrings() const;
+
+	// Загружает информацию об атомарных объектах
+	ESldError InitAtomicInfo() const;
+
+	// Инициализирует менеджер структурированных метаданных
+	ESldError InitMetadataManager() const;
+
+	// Инициализирует менеджер css метаданных
+	ESldError InitCSSDataManager() const;
+
+	// Инициализирует все базовые списки слов
+	ESldError InitAllWordLists();
+
 	// Класс чтения данных
-	CSDCReadMy				m_data;
+	mutable CSDCReadMy		m_data;
 
 	// Указатель на данные, необходимые для работы прослойки
 	ISldLayerAccess 		*m_LayerAccess;
@@ -793,16 +876,16 @@ private:
 	Int32					m_ListIndex;
 
 	// Переводы
-	sld2::UniquePtr<CSldArticles>	m_Articles;
+	mutable sld2::UniquePtr<CSldArticles>	m_Articles;
 
 	// Локализованные строчки словаря
-	sld2::UniquePtr<CSldLocalizedString>	m_Strings;
+	mutable sld2::UniquePtr<CSldLocalizedString>	m_Strings;
 	
 	// Массив указателей на функции сборки озвучки
 	FSoundBuilderMethodPtr	m_SoundBuilder[4];
 	
-	// Данные, необходимые для работы системы защиты
-	TRegistrationData		m_RegistrationData;
+	// Данные, необходимые для работы системы защиты (изменяются переводами, см. CSldArticles::SetRegisterData())
+	mutable TRegistrationData	m_RegistrationData;
 
 	// Случайное число
 	TRandomSeed				m_RandomSeed;
@@ -813,22 +896,43 @@ private:
 	sld2::UniquePtr<CSldMorphology> m_MorphologyManager;
 
 	// Структура с информацией об атомарных объектах
-	TAtomicObjectInfo		*m_AtomicInfo;
+	mutable TAtomicObjectInfo	*m_AtomicInfo;
 
 	// Класс работы со структурированными метаданными
-	sld2::UniquePtr<CSldMetadataManager> m_MetadataManager;
+	mutable sld2::UniquePtr<CSldMetadataManager> m_MetadataManager;
 
 	// Индекс листа содержащего строки структурированных метаданных
-	Int32					m_MetadataStringsListIndex;
+	mutable Int32			m_MetadataStringsListIndex;
 
 	// Класс работы с css метаданными
-	sld2::UniquePtr<CSldCSSDataManager>	m_cssDataManager;
+	mutable sld2::UniquePtr<CSldCSSDataManager>	m_cssDataManager;
 
 	// Индекс листа содержащего строки css метаданных
-	Int32					m_cssDataStringsListIndex;
+	mutable Int32			m_cssDataStringsListIndex;
 
 	// Данные о смреженых словарях
 	TMergedDictInfo			m_MergedDictInfo;
+
+	// Контекст поиска (не принадлежит словарю)
+	CSldSearchContext*		m_SearchContext;
+
+	// Битовая маска уже проинициализированных подсистем (см. ELazyInitPart)
+	// Словарь не предназначен для одновременного использования из нескольких потоков
+	// (текущий список слов, состояние поиска и перевода), поэтому синхронизация здесь не нужна
+	mutable UInt32			m_InitializedParts;
+
+	// Результат инициализации подсистем из InitContent()
+	mutable ESldError		m_ContentError;
+
+#ifdef SLD__HAVE_STATISTICS
+	// Счетчики производительности
+	TSldStatistics			m_Statistics;
+#endif
+
+#ifdef SLD__HAVE_SCRATCH_ARENA
+	// Арена временных буферов операций словаря
+	sld2::Arena				m_ScratchArena;
+#endif
 };
 
 #endif
@@ -4,46 +4,111 @@
 
 namespace
 {
-	ESldError GetReferencesForList(
-			CSldDictionary& aDictionary, Int32 aListIndex, 
-			const SldU16String& aRawWord, CSldVector<Int32>& aTmpIndexes, 
-			TWordRefInfo& aWordRef, const CSldVector<MorphoDataType*>& aMorphos, 
-			const CSldCompare* aSldCompare, UInt8 aUseBuiltInMorpho = 0)
+	// Строка с привязанными к ней данными; массивы таких элементов упорядочиваются по строке
+	template <typename T>
+	struct TKeyedValue
 	{
-		ESldError error = aDictionary.GetWordSetByTextExtended(aListIndex, aRawWord.c_str(), aTmpIndexes);
-		if (error != eOK)
-			return error;
+		SldU16String Key;
+		T Value;
 
-		for (const auto wordIndex : aTmpIndexes)
+		bool operator<(SldU16StringRef aKey) const { return SldU16StringRef(Key) < aKey; }
+		bool operator==(SldU16StringRef aKey) const { return SldU16StringRef(Key) == aKey; }
+	};
+
+	// Возвращает элемент с ключом aKey, добавляя его в упорядоченный массив при отсутствии
+	template <typename T>
+	T& FindOrInsert(CSldVector<TKeyedValue<T>>& aValues, SldU16StringRef aKey)
+	{
+		UInt32 pos;
+		if (!sld2::binary_search(aValues.data(), aValues.size(), aKey, &pos))
 		{
-			aWordRef.Refs.emplace_back(TSldWordIndexes(aListIndex, wordIndex), TWordRefInfo::type::exact);
+			TKeyedValue<T> value;
+			value.Key = to_string(aKey);
+			aValues.insert(pos, sld2::move(value));
 		}
+		return aValues[pos].Value;
+	}
+
+	// Возвращает элемент с ключом aKey из упорядоченного массива
+	template <typename T>
+	T& Find(CSldVector<TKeyedValue<T>>& aValues, SldU16StringRef aKey)
+	{
+		return aValues[sld2::sorted_find(aValues, aKey)].Value;
+	}
+
+	bool IsSameMorphoIds(const CSldVector<UInt32>& aLeft, const CSldVector<UInt32>& aRight)
+	{
+		if (aLeft.size() != aRight.size())
+			return false;
+		for (UInt32 i = 0; i < aLeft.size(); i++)
+		{
+			if (aLeft[i] != aRight[i])
+				return false;
+		}
+		return true;
+	}
+
+	// Возвращает идентификатор морфологической базы
+	UInt32 GetMorphoId(const MorphoDataType *aMorpho)
+	{
+		const MorphoDataHeader *header = nullptr;
+		if (!aMorpho->GetMorphoHeader(&header) || !header)
+			return 0;
+		return header->DictID;
+	}
 
-		const auto language = aDictionary.GetListLanguageFrom(aListIndex);
+	// Слово фразы, для которого ищутся ссылки в списке
+	struct TPhraseWord
+	{
+		// Найденные ссылки
+		TWordRefs Refs;
+		// Ссылки уже известны (взяты из кэша)
+		bool Resolved = false;
+		// Морфологические формы слова с их типами
+		CSldVector<TSldPair<SldU16String, TWordRefInfo::type>> Forms;
+	};
+
+	// Результат поиска строки в списке
+	struct TWordSetLookup
+	{
+		CSldVector<Int32> Indexes;
+		ESldError Error = eOK;
+	};
 
+	/**
+	 * Собирает морфологические формы слова, отличные от самого слова
+	 *
+	 * @param[in]	aDictionary			- словарь
+	 * @param[in]	aLanguage			- язык списка
+	 * @param[in]	aRawWord			- эффективная строка слова
+	 * @param[in]	aMorphos			- морфологические базы языка списка
+	 * @param[in]	aSldCompare			- таблица сравнения
+	 * @param[in]	aUseBuiltInMorpho	- флаг, включающий использование встроенной морфологии
+	 * @param[out]	aForms				- формы слова с их типами
+	 *
+	 * @return error code
+	 */
+	ESldError CollectMorphoForms(CSldDictionary& aDictionary, ESldLanguage aLanguage, const SldU16String& aRawWord,
+			const CSldVector<MorphoDataType*>& aMorphos, const CSldCompare* aSldCompare, UInt8 aUseBuiltInMorpho,
+			CSldVector<TSldPair<SldU16String, TWordRefInfo::type>>& aForms)
+	{
 		CSldVector<TSldMorphologyWordStruct> tmpMorphologyForms;
 
 		auto addForms = [&]() -> void
 		{
-			for (const auto& form : tmpMorphologyForms)
+			for (auto& form : tmpMorphologyForms)
 			{
 				if (aSldCompare->StrICmp(aRawWord.c_str(), form.MorphologyForm) == 0)
 					continue;
 
 				const auto morphoType = form.MorphologyFormType == eMorphologyWordTypeBase ? TWordRefInfo::type::morphoBase : TWordRefInfo::type::morphoForm;
-
-				aDictionary.GetWordSetByTextExtended(aListIndex, form.MorphologyForm.c_str(), aTmpIndexes);
-
-				for (const auto wordIndex : aTmpIndexes)
-					aWordRef.Refs.emplace_back(TSldWordIndexes(aListIndex, wordIndex), morphoType);
+				aForms.emplace_back(sld2::move(form.MorphologyForm), morphoType);
 			}
 		};
 
+		ESldError error;
 		for (auto morpho : aMorphos)
 		{
-			if (language != morpho->GetLanguageCode())
-				continue;
-
 			error = GetAllMorphoForms(aRawWord.c_str(), morpho, tmpMorphologyForms);
 			if (error != eOK)
 				return error;
@@ -53,7 +118,7 @@ namespace
 
 		if (aUseBuiltInMorpho)
 		{
-			error = GetAllMorphoForms(aRawWord.c_str(), &aDictionary, language, tmpMorphologyForms);
+			error = GetAllMorphoForms(aRawWord.c_str(), &aDictionary, aLanguage, tmpMorphologyForms);
 			if (error != eOK)
 				return error;
 
@@ -64,6 +129,75 @@ namespace
 	}
 }
 
+/** *********************************************************************
+* Привязывает кэш к словарю, очищая его при смене словаря
+*
+* @param[in]	aDictionary	- словарь
+************************************************************************/
+void CSldWordReferenceCache::Bind(const CSldDictionary *aDictionary)
+{
+	if (m_Dictionary == aDictionary)
+		return;
+
+	Clear();
+	m_Dictionary = aDictionary;
+}
+
+/** *********************************************************************
+* Возвращает позицию первой записи, не меньшей (aListIndex, aWord)
+************************************************************************/
+UInt32 CSldWordReferenceCache::LowerBound(Int32 aListIndex, SldU16StringRef aWord) const
+{
+	return sld2::lower_bound(m_Entries.data(), m_Entries.size(), [aListIndex, aWord](const TEntry &aEntry) {
+		return aEntry.ListIndex < aListIndex || (aEntry.ListIndex == aListIndex && SldU16StringRef(aEntry.Word) < aWord);
+	});
+}
+
+/** *********************************************************************
+* Ищет ссылки слова, полученные с теми же морфологическими базами
+*
+* @return указатель на ссылки или nullptr, если слова нет в кэше
+************************************************************************/
+const TWordRefs* CSldWordReferenceCache::Find(Int32 aListIndex, SldU16StringRef aWord, const CSldVector<UInt32>& aMorphoIds, UInt8 aUseBuiltInMorpho) const
+{
+	const UInt32 pos = LowerBound(aListIndex, aWord);
+	if (pos == m_Entries.size())
+		return nullptr;
+
+	const TEntry &entry = m_Entries[pos];
+	if (entry.ListIndex != aListIndex || SldU16StringRef(entry.Word) != aWord ||
+		entry.UseBuiltInMorpho != aUseBuiltInMorpho || !IsSameMorphoIds(entry.MorphoIds, aMorphoIds))
+		return nullptr;
+
+	return &entry.Refs;
+}
+
+/** *********************************************************************
+* Запоминает ссылки слова (заменяя ссылки, полученные с другими морфологическими базами)
+************************************************************************/
+void CSldWordReferenceCache::Insert(Int32 aListIndex, SldU16StringRef aWord, const CSldVector<UInt32>& aMorphoIds, UInt8 aUseBuiltInMorpho, const TWordRefs& aRefs)
+{
+	UInt32 pos = LowerBound(aListIndex, aWord);
+	if (pos == m_Entries.size() || m_Entries[pos].ListIndex != aListIndex || SldU16StringRef(m_Entries[pos].Word) != aWord)
+	{
+		if (m_Entries.size() >= m_MaxWords)
+		{
+			Clear();
+			pos = 0;
+		}
+
+		TEntry entry;
+		entry.ListIndex = aListIndex;
+		entry.Word = to_string(aWord);
+		m_Entries.insert(pos, sld2::move(entry));
+	}
+
+	TEntry &entry = m_Entries[pos];
+	entry.MorphoIds = aMorphoIds;
+	entry.UseBuiltInMorpho = aUseBuiltInMorpho;
+	entry.Refs = aRefs;
+}
+
 ESldError CSldDictionaryHelper::GetExternalBaseName(Int32 aListIndex, SldU16WordsArray& aBaseNames)
 {
 	Int32 currentListIndex = 0;
@@ -923,16 +1057,18 @@ ESldError CSldDictionaryHelper::AdvancedHeadwordSearch(const UInt16* aRequest, c
 		}
 	}
 
+	SldWordsCollection ftsWords;
+	ftsWords.reserve(ftsResult[0].size() + ftsResult[1].size() + ftsResult[2].size() + ftsResult[3].size());
 	for (auto & order : ftsResult)
 	{
 		for (auto & res : order)
-		{
-			error = listControl.AddWord(dictionaryListIndex, res.second);
-			if (error != eOK)
-				return error;
-		}
+			ftsWords.emplace_back(dictionaryListIndex, res.second);
 	}
 
+	error = listControl.AddWords(ftsWords);
+	if (error != eOK)
+		return error;
+
 	error = m_Dictionary.ClearSearch();
 	if (error != eOK)
 		return error;
@@ -1281,6 +1417,10 @@ ESldError CSldDictionaryHelper::CollocationsSearch(const UInt16* aRequest, const
 		if (error != eOK)
 			return error;
 
+		error = aListControl.ReserveWords(phraseCount);
+		if (error != eOK)
+			return error;
+
 		for (Int32 phraseIndex = 0; phraseIndex < phraseCount; phraseIndex++)
 		{
 			currentIndex++;
@@ -2143,39 +2283,7 @@ ESldError CSldDictionaryHelper::Swipe(Int32 aDirection, ESwipingMode aSwipingMod
 ************************************************************************/
 ESldError CSldDictionaryHelper::GetWordReference(SldU16StringRef aPhrase, const CSldVector<MorphoDataType*>& aMorphos, CSldVector<TWordRefInfo>& aRefs, UInt8 aUseBuiltInMorpho/* = 0*/)
 {
-	aRefs.clear();
-	ESldError error;
-
-	CSldVector<SldU16StringRef> words;
-	GetCompare()->DivideQueryByParts(aPhrase, words);
-	if (words.empty())
-		return eOK;
-
-	const auto dictionaryLists = GetListIndexes(eWordListType_Dictionary);
-	SldU16String rawWord;
-	CSldVector<Int32> tmpIndexes;
-	CSldVector<TSldMorphologyWordStruct> tmpMorphologyForms;
-
-	for (const auto word : words)
-	{
-		rawWord = GetCompare()->GetEffectiveString(word);
-		aRefs.emplace_back();
-		auto& wordRef = aRefs.back();
-
-		wordRef.StartPos = word.data() - aPhrase.data();
-		wordRef.EndPos = wordRef.StartPos + word.length() - 1;
-
-		for (const auto listIndex : dictionaryLists)
-		{
-      error = GetReferencesForList(m_Dictionary, listIndex, rawWord, tmpIndexes, 
-                                   wordRef, aMorphos, GetCompare(), aUseBuiltInMorpho);
-
-      if (error != eOK)
-        return error;
-		}
-	}
-
-	return eOK;
+	return GetWordReferenceInLists(aPhrase, GetListIndexes(eWordListType_Dictionary), aMorphos, aRefs, aUseBuiltInMorpho);
 }
 
 /** *********************************************************************
@@ -2202,32 +2310,133 @@ ESldError CSldDictionaryHelper::GetWordReferenceInList(SldU16StringRef aPhrase,
 			return eCommonWrongList;
 	}
 
+	CSldVector<Int32> listIndexes;
+	listIndexes.push_back(listIndex);
+	return GetWordReferenceInLists(aPhrase, listIndexes, aMorphos, aRefs, aUseBuiltInMorpho);
+}
+
+/** *********************************************************************
+* Ищет записи, соответсвующие словам во фразе, в указанных списках
+*
+* Повторяющиеся слова фразы разрешаются один раз. Все слова и их морфологические формы
+* собираются в упорядоченный массив без повторов и ищутся в каждом списке по одному разу
+* в порядке сортировки. Если задан кэш (см. SetWordReferenceCache()), слова, уже найденные
+* в статических списках словаря в предыдущих вызовах, берутся из него. Порядок ссылок в результате совпадает с порядком
+* поиска каждого слова по отдельности.
+*
+* @param[in]	aPhrase			- фраза, разбиваемая на слова
+* @param[in]	aListIndexes	- индексы списков, в которых ищутся записи
+* @param[in]	aMorphos		- указатели на морфологические базы
+* @param[out]	aRefs			- контейнер с найденными словами результатами
+* @param[in] aUseBuiltInMorpho - флаг, включающий использование встроенной морфологии
+* @return error code
+************************************************************************/
+ESldError CSldDictionaryHelper::GetWordReferenceInLists(SldU16StringRef aPhrase, const CSldVector<Int32>& aListIndexes, const CSldVector<MorphoDataType*>& aMorphos, CSldVector<TWordRefInfo>& aRefs, UInt8 aUseBuiltInMorpho)
+{
 	aRefs.clear();
-	ESldError error = ESldError::eOK;
+	ESldError error;
 
 	CSldVector<SldU16StringRef> words;
 	GetCompare()->DivideQueryByParts(aPhrase, words);
 	if (words.empty())
 		return eOK;
 
-	SldU16String rawWord;
-	CSldVector<Int32> tmpIndexes;
-	CSldVector<TSldMorphologyWordStruct> tmpMorphologyForms;
+	if (m_WordRefCache)
+		m_WordRefCache->Bind(&m_Dictionary);
 
-	for (const auto word : words)
+	CSldVector<SldU16String> rawWords(words.size());
+	for (UInt32 i = 0; i < words.size(); i++)
 	{
-		rawWord = GetCompare()->GetEffectiveString(word);
+		rawWords[i] = GetCompare()->GetEffectiveString(words[i]);
 		aRefs.emplace_back();
 		auto& wordRef = aRefs.back();
 
-		wordRef.StartPos = word.data() - aPhrase.data();
-		wordRef.EndPos = wordRef.StartPos + word.length() - 1;
+		wordRef.StartPos = words[i].data() - aPhrase.data();
+		wordRef.EndPos = wordRef.StartPos + words[i].length() - 1;
+	}
 
-		error = GetReferencesForList(m_Dictionary, listIndex, rawWord, tmpIndexes,
-			wordRef, aMorphos, GetCompare(), aUseBuiltInMorpho);
+	CSldVector<TKeyedValue<TPhraseWord>> phraseWords;
+	CSldVector<TKeyedValue<TWordSetLookup>> lookups;
+	CSldVector<MorphoDataType*> listMorphos;
+	CSldVector<UInt32> listMorphoIds;
+	for (const auto listIndex : aListIndexes)
+	{
+		const auto language = m_Dictionary.GetListLanguageFrom(listIndex);
+		const bool useCache = m_WordRefCache && m_Dictionary.IsStaticList(listIndex);
 
-		if (error != eOK)
-			return error;
+		listMorphos.clear();
+		listMorphoIds.clear();
+		for (auto morpho : aMorphos)
+		{
+			if (language == morpho->GetLanguageCode())
+			{
+				listMorphos.push_back(morpho);
+				if (useCache)
+					listMorphoIds.push_back(GetMorphoId(morpho));
+			}
+		}
+
+		// Слова фразы без повторов
+		phraseWords.clear();
+		for (const auto& rawWord : rawWords)
+			FindOrInsert(phraseWords, rawWord);
+
+		// Слова и формы, которые нужно найти в списке
+		lookups.clear();
+		for (auto& word : phraseWords)
+		{
+			if (useCache)
+			{
+				const TWordRefs *refs = m_WordRefCache->Find(listIndex, word.Key, listMorphoIds, aUseBuiltInMorpho);
+				if (refs)
+				{
+					word.Value.Refs = *refs;
+					word.Value.Resolved = true;
+					continue;
+				}
+			}
+
+			error = CollectMorphoForms(m_Dictionary, language, word.Key, listMorphos, GetCompare(), aUseBuiltInMorpho, word.Value.Forms);
+			if (error != eOK)
+				return error;
+
+			FindOrInsert(lookups, word.Key);
+			for (const auto& form : word.Value.Forms)
+				FindOrInsert(lookups, form.first);
+		}
+
+		for (auto& lookup : lookups)
+			lookup.Value.Error = m_Dictionary.GetWordSetByTextExtended(listIndex, lookup.Key.c_str(), lookup.Value.Indexes);
+
+		for (auto& word : phraseWords)
+		{
+			TPhraseWord& phraseWord = word.Value;
+			if (phraseWord.Resolved)
+				continue;
+
+			const TWordSetLookup& exact = Find(lookups, word.Key);
+			if (exact.Error != eOK)
+				return exact.Error;
+
+			for (const auto wordIndex : exact.Indexes)
+				phraseWord.Refs.emplace_back(TSldWordIndexes(listIndex, wordIndex), TWordRefInfo::type::exact);
+
+			// Ошибки поиска форм не прерывают поиск, как и раньше берется то, что успели найти
+			for (const auto& form : phraseWord.Forms)
+			{
+				for (const auto wordIndex : Find(lookups, form.first).Indexes)
+					phraseWord.Refs.emplace_back(TSldWordIndexes(listIndex, wordIndex), form.second);
+			}
+
+			if (useCache)
+				m_WordRefCache->Insert(listIndex, word.Key, listMorphoIds, aUseBuiltInMorpho, phraseWord.Refs);
+		}
+
+		for (UInt32 i = 0; i < rawWords.size(); i++)
+		{
+			for (const auto& ref : Find(phraseWords, rawWords[i]).Refs)
+				aRefs[i].Refs.push_back(ref);
+		}
 	}
 
 	return eOK;
@@ -35,11 +35,72 @@ struct TExternResourcePriority
 // Вектор структур TExternResource, не обязательно сортирован по приоритету
 typedef CSldVector<TExternResourcePriority> TExternReference;
 
+// Ссылки на записи списка, найденные для одного слова фразы
+typedef CSldVector<TSldPair<TSldWordIndexes, TWordRefInfo::type>> TWordRefs;
+
+/**
+ * Кэш ссылок на слова фраз между вызовами CSldDictionaryHelper::GetWordReference()
+ * и CSldDictionaryHelper::GetWordReferenceInList()
+ *
+ * Хранит найденные ссылки для пар (список, эффективная строка слова) вместе с идентификаторами
+ * морфологических баз, с которыми они были получены. Запоминаются только ссылки в списках,
+ * записанных в словаре, кроме поисковых и пользовательских. Кэш привязывается к словарю
+ * при первом использовании и очищается при использовании с другим словарем. Объект должен жить дольше помощников,
+ * которым он передан через CSldDictionaryHelper::SetWordReferenceCache().
+ */
+class CSldWordReferenceCache
+{
+public:
+	// aMaxWords - максимальное количество запоминаемых слов, при переполнении кэш очищается
+	explicit CSldWordReferenceCache(UInt32 aMaxWords = 4096) : m_Dictionary(nullptr), m_MaxWords(aMaxWords) {}
+
+	// Очищает кэш
+	void Clear() { m_Entries.clear(); }
+
+	// Возвращает количество запомненных слов
+	UInt32 GetCount() const { return m_Entries.size(); }
+
+private:
+	friend class CSldDictionaryHelper;
+
+	struct TEntry
+	{
+		// Индекс списка
+		Int32 ListIndex = SLD_DEFAULT_LIST_INDEX;
+		// Эффективная строка слова
+		SldU16String Word;
+		// Идентификаторы морфологических баз и флаг встроенной морфологии, с которыми получены ссылки
+		CSldVector<UInt32> MorphoIds;
+		UInt8 UseBuiltInMorpho = 0;
+		// Найденные ссылки
+		TWordRefs Refs;
+	};
+
+	// Привязывает кэш к словарю
+	void Bind(const CSldDictionary *aDictionary);
+
+	// Ищет ссылки слова, полученные с теми же морфологическими базами
+	const TWordRefs* Find(Int32 aListIndex, SldU16StringRef aWord, const CSldVector<UInt32>& aMorphoIds, UInt8 aUseBuiltInMorpho) const;
+
+	// Запоминает ссылки слова
+	void Insert(Int32 aListIndex, SldU16StringRef aWord, const CSldVector<UInt32>& aMorphoIds, UInt8 aUseBuiltInMorpho, const TWordRefs& aRefs);
+
+	// Возвращает позицию первой записи, не меньшей (aListIndex, aWord)
+	UInt32 LowerBound(Int32 aListIndex, SldU16StringRef aWord) const;
+
+	// Записи, упорядоченные по индексу списка и слову
+	CSldVector<TEntry> m_Entries;
+	// Словарь, к которому относятся записи
+	const CSldDictionary *m_Dictionary;
+	// Максимальное количество записей
+	UInt32 m_MaxWords;
+};
+
 class CSldDictionaryHelper
 {
 public:
 	// Constructor
-	CSldDictionaryHelper(CSldDictionary & aDict) : m_Dictionary(aDict){}
+	CSldDictionaryHelper(CSldDictionary & aDict) : m_Dictionary(aDict), m_WordRefCache(nullptr) {}
 	// Destructor
 	~CSldDictionaryHelper() {}
 
@@ -70,6 +131,9 @@ public:
 	// Выполняет свайп в любом списке, в направлении aDirection/abs(aDirection), в режиме aSwipingMode
 	ESldError Swipe(Int32, ESwipingMode, CSldCustomListControl *);
 
+	// Задает кэш ссылок на слова фраз, используемый между вызовами (nullptr - без кэша)
+	void SetWordReferenceCache(CSldWordReferenceCache *aCache) { m_WordRefCache = aCache; }
+
 	// Ищет записи, соответсвующие словам во фразе
 	ESldError GetWordReference(SldU16StringRef aPhrase, const CSldVector<MorphoDataType*>& aMorphos, CSldVector<TWordRefInfo>& aRefs, UInt8 aUseBuiltInMorpho = 0);
 
@@ -102,11 +166,17 @@ private:
 
 	CSldVector<Int32> GetListIndexes(const EWordListTypeEnum aType, const ESldLanguage aLang = SldLanguage::Unknown);
 
+	// Ищет записи, соответсвующие словам во фразе, в указанных списках
+	ESldError GetWordReferenceInLists(SldU16StringRef aPhrase, const CSldVector<Int32>& aListIndexes, const CSldVector<MorphoDataType*>& aMorphos, CSldVector<TWordRefInfo>& aRefs, UInt8 aUseBuiltInMorpho);
+
 	const CSldCompare* GetCompare() const { const CSldCompare* cmp = nullptr; m_Dictionary.GetCompare(&cmp); return cmp; }  
 
 private:
 
 	// Указатель на класс CSldDictionary
 	CSldDictionary		&m_Dictionary;
+
+	// Кэш ссылок на слова фраз между вызовами
+	CSldWordReferenceCache	*m_WordRefCache;
 };
 #endif
\ No newline at end of file
@@ -110,6 +110,8 @@ typedef enum
 	eCommonWrongNumberOfWords,
 	// Ошибочное количество переводов у записи
 	eCommonWrongNumberOfTranslation,
+	// Ядро собрано без сбора статистики (см. SLD__HAVE_STATISTICS)
+	eCommonStatisticsNotAvailable,
 
 	// Это не ошибки - это особые случаи поведения ядра
 	eExceptionErrorBase = 0x0500,
@@ -1,5 +1,32 @@
 ﻿#include "SldIndexes.h"
 
+// Распаковывает одно поле побайтово записанных ссылок; размер поля (в байтах) известен на этапе компиляции,
+// поэтому внутренний цикл не содержит ветвлений
+template <UInt32 FieldSize>
+static void unpackField(const UInt8* aData, UInt32 aStride, UInt32 aCount, Int32 TSldIndexData::*aField, TSldIndexData* aIndexData)
+{
+	for (UInt32 i = 0; i < aCount; i++, aData += aStride)
+	{
+		UInt32 value = 0;
+		for (UInt32 byte = 0; byte < FieldSize; byte++)
+			value |= (UInt32)aData[byte] << (byte * 8);
+		aIndexData[i].*aField = (Int32)value;
+	}
+}
+
+// Распаковывает одно поле побайтово записанных ссылок
+static void unpackField(UInt32 aFieldSize, const UInt8* aData, UInt32 aStride, UInt32 aCount, Int32 TSldIndexData::*aField, TSldIndexData* aIndexData)
+{
+	switch (aFieldSize)
+	{
+	case 1: unpackField<1>(aData, aStride, aCount, aField, aIndexData); break;
+	case 2: unpackField<2>(aData, aStride, aCount, aField, aIndexData); break;
+	case 3: unpackField<3>(aData, aStride, aCount, aField, aIndexData); break;
+	case 4: unpackField<4>(aData, aStride, aCount, aField, aIndexData); break;
+	default: break;
+	}
+}
+
 /** *********************************************************************
 * Производим инициализацию класса доступа к индексам
 *
@@ -59,6 +86,24 @@ ESldError CSldIndexes::Init(CSDCReadMy &aData, UInt32 aIndexCountType, UInt32 aI
 		m_TotalIndexDataSize += m_Header.SizeOfShiftIndex;
 	}
 
+	// Побайтовое чтение возможно, только если размеры всех полей кратны байту
+	if ((m_Header.DataMask & SLD_INDEXES_IS_BYTE_ALIGNED) && m_TotalIndexDataSize)
+	{
+		const UInt32 fieldSizes[] = {
+			m_isDataHasArticleIndex ? m_Header.SizeOfIndexes : 0,
+			m_isDataHasListIndex ? m_Header.SizeOfListIndex : 0,
+			m_isDataHasTranslationIndex ? m_Header.SizeOfTranslationIndex : 0,
+			m_isDataHasShiftIndex ? m_Header.SizeOfShiftIndex : 0
+		};
+
+		m_IsDataByteAligned = 1;
+		for (UInt32 fieldSize : fieldSizes)
+		{
+			if (fieldSize % 8 || fieldSize > 32)
+				m_IsDataByteAligned = 0;
+		}
+	}
+
 	return eOK;
 }
 
@@ -204,46 +249,164 @@ ESldError CSldIndexes::GetIndexData(Int32 aWordIndex, Int32 aWordTranslationInde
 	if (!m_CurrentDataCount || ((UInt32)aWordTranslationIndex >= m_CurrentDataCount))
 		return eCommonWrongIndex;
 	
-	UInt32 shiftData = m_CurrentBaseShiftData + aWordTranslationIndex*m_TotalIndexDataSize;
-	
-	error = m_InputData.GoTo(shiftData);
+	TSldIndexData indexData;
+	error = ReadIndexData(m_CurrentBaseShiftData + aWordTranslationIndex*m_TotalIndexDataSize, 1, &indexData);
 	if (error != eOK)
 		return error;
-	
-	UInt32 dListIndex = m_Header.DefaultListIndex;
-	UInt32 dArticleIndex = 0;
-	UInt32 dTranslationIndex = m_Header.DefaultTranslationIndex;
-	UInt32 dShiftIndex = 0;
-	
+
+	*aListIndex = indexData.ListIndex;
+	*aArticleIndex = indexData.ArticleIndex;
+	*aTranslationIndex = indexData.TranslationIndex;
+	*aShiftIndex = indexData.ShiftIndex;
+
+	return eOK;
+}
+
+/** *********************************************************************
+* Возвращает данные всех ссылок слова
+*
+* Все ссылки считываются за один проход по данным индексов, что заметно быстрее,
+* чем получение каждой ссылки отдельно
+*
+* @param[in]	aWordIndex	- глобальный номер слова в списке слов
+* @param[out]	aIndexData	- вектор, в который будут помещены данные ссылок слова
+*
+* @return error code
+************************************************************************/
+ESldError CSldIndexes::GetIndexData(Int32 aWordIndex, CSldVector<TSldIndexData> & aIndexData)
+{
+	aIndexData.clear();
+
+	Int32 TranslationCount = 0;
+	ESldError error = GetNumberOfArticlesByIndex(aWordIndex, &TranslationCount);
+	if (error != eOK)
+		return error;
+
+	if (!m_CurrentDataCount)
+		return eOK;
+
+	aIndexData.resize(m_CurrentDataCount);
+	return ReadIndexData(m_CurrentBaseShiftData, m_CurrentDataCount, aIndexData.data());
+}
+
+/** *********************************************************************
+* Считывает данные нескольких подряд идущих ссылок
+*
+* @param[in]	aShiftData	- позиция данных первой ссылки в битах
+* @param[in]	aCount		- количество ссылок
+* @param[out]	aIndexData	- указатель на массив, куда будут сохранены данные ссылок
+*
+* @return error code
+************************************************************************/
+ESldError CSldIndexes::ReadIndexData(UInt32 aShiftData, UInt32 aCount, TSldIndexData* aIndexData)
+{
+	ESldError error;
+
+	// Данные побайтово записанных индексов копируются порциями и распаковываются без битового потока
+	if (m_IsDataByteAligned)
+	{
+		const UInt32 indexDataSize = m_TotalIndexDataSize / 8;
+		const UInt32 blockCount = SLD_INDEXES_UNPACK_BLOCK_SIZE / indexDataSize;
+		UInt8 buffer[SLD_INDEXES_UNPACK_BLOCK_SIZE];
+
+		while (aCount)
+		{
+			const UInt32 count = sld2::min(aCount, blockCount);
+			error = m_InputData.GetBytes(aShiftData, buffer, count * indexDataSize);
+			if (error != eOK)
+				return error;
+
+			UnpackIndexData(buffer, count, aIndexData);
+
+			aShiftData += count * m_TotalIndexDataSize;
+			aIndexData += count;
+			aCount -= count;
+		}
+
+		return eOK;
+	}
+
+	error = m_InputData.GoTo(aShiftData);
+	if (error != eOK)
+		return error;
+
+	for (UInt32 i = 0; i < aCount; i++)
+	{
+		UInt32 dListIndex = m_Header.DefaultListIndex;
+		UInt32 dArticleIndex = 0;
+		UInt32 dTranslationIndex = m_Header.DefaultTranslationIndex;
+		UInt32 dShiftIndex = 0;
+
+		if (m_isDataHasListIndex)
+		{
+			error = m_InputData.GetData(&dListIndex, m_Header.SizeOfListIndex);
+			if (error != eOK)
+				return error;
+		}
+		if (m_isDataHasArticleIndex)
+		{
+			error = m_InputData.GetData(&dArticleIndex, m_Header.SizeOfIndexes);
+			if (error != eOK)
+				return error;
+		}
+		if (m_isDataHasTranslationIndex)
+		{
+			error = m_InputData.GetData(&dTranslationIndex, m_Header.SizeOfTranslationIndex);
+			if (error != eOK)
+				return error;
+		}
+		if (m_isDataHasShiftIndex)
+		{
+			error = m_InputData.GetData(&dShiftIndex, m_Header.SizeOfShiftIndex);
+			if (error != eOK)
+				return error;
+		}
+
+		aIndexData[i].ListIndex = (Int32)dListIndex;
+		aIndexData[i].ArticleIndex = (Int32)dArticleIndex;
+		aIndexData[i].TranslationIndex = (Int32)dTranslationIndex;
+		aIndexData[i].ShiftIndex = (Int32)dShiftIndex;
+	}
+
+	return eOK;
+}
+
+/** *********************************************************************
+* Распаковывает данные ссылок, записанные побайтово
+*
+* Поля распаковываются по очереди для всех ссылок сразу
+*
+* @param[in]	aData		- указатель на данные ссылок
+* @param[in]	aCount		- количество ссылок
+* @param[out]	aIndexData	- указатель на массив, куда будут сохранены данные ссылок
+************************************************************************/
+void CSldIndexes::UnpackIndexData(const UInt8* aData, UInt32 aCount, TSldIndexData* aIndexData) const
+{
+	const UInt32 stride = m_TotalIndexDataSize / 8;
+	for (UInt32 i = 0; i < aCount; i++)
+	{
+		aIndexData[i].ListIndex = (Int32)m_Header.DefaultListIndex;
+		aIndexData[i].ArticleIndex = 0;
+		aIndexData[i].TranslationIndex = (Int32)m_Header.DefaultTranslationIndex;
+		aIndexData[i].ShiftIndex = 0;
+	}
+
+	// Порядок полей совпадает с порядком чтения из битового потока
 	if (m_isDataHasListIndex)
 	{
-		error = m_InputData.GetData(&dListIndex, m_Header.SizeOfListIndex);
-		if (error != eOK)
-			return error;
+		unpackField(m_Header.SizeOfListIndex / 8, aData, stride, aCount, &TSldIndexData::ListIndex, aIndexData);
+		aData += m_Header.SizeOfListIndex / 8;
 	}
 	if (m_isDataHasArticleIndex)
 	{
-		error = m_InputData.GetData(&dArticleIndex, m_Header.SizeOfIndexes);
-		if (error != eOK)
-			return error;
+		unpackField(m_Header.SizeOfIndexes / 8, aData, stride, aCount, &TSldIndexData::ArticleIndex, aIndexData);
+		aData += m_Header.SizeOfIndexes / 8;
 	}
 	if (m_isDataHasTranslationIndex)
 	{
-		error = m_InputData.GetData(&dTranslationIndex, m_Header.SizeOfTranslationIndex);
-		if (error != eOK)
-			return error;
+		unpackField(m_Header.SizeOfTranslationIndex / 8, aData, stride, aCount, &TSldIndexData::TranslationIndex, aIndexData);
+		aData += m_Header.SizeOfTranslationIndex / 8;
 	}
 	if (m_isDataHasShiftIndex)
-	{
-		error = m_InputData.GetData(&dShiftIndex, m_Header.SizeOfShiftIndex);
-		if (error != eOK)
-			return error;
-	}
-	
-	*aListIndex = (Int32)dListIndex;
-	*aArticleIndex = (Int32)dArticleIndex;
-	*aTranslationIndex = (Int32)dTranslationIndex;
-	*aShiftIndex = (Int32)dShiftIndex;
-	
-	return eOK;
-}
\ No newline at end of file
+		unpackField(m_Header.SizeOfShiftIndex / 8, aData, stride, aCount, &TSldIndexData::ShiftIndex, aIndexData);
+}
@@ -3,6 +3,7 @@
 
 #include "SldError.h"
 #include "SldBitInput.h"
+#include "SldVector.h"
 
 // Максимальный размер ресурса. На самом деле все ресурсы кроме последнего должны быть этого размера.
 #define SLD_INDEXES_RESOURCE_SIZE	(32*1024)
@@ -12,6 +13,21 @@
 // Получить номер статьи на которую ссылается слово
 #define SLD_INDEX_GET_DATA				(1)
 
+// Максимальный размер (в байтах) порции данных, распаковываемой за один раз при побайтовом чтении индексов
+#define SLD_INDEXES_UNPACK_BLOCK_SIZE	(1024)
+
+// Данные одной ссылки индекса
+struct TSldIndexData
+{
+	// Номер списка слов
+	Int32 ListIndex;
+	// Номер статьи или номер слова в списке слов (в случае списка слов полнотекстового поиска)
+	Int32 ArticleIndex;
+	// Номер перевода
+	Int32 TranslationIndex;
+	// Смещение в статье
+	Int32 ShiftIndex;
+};
 
 // Класс отвечающий за хранение индексов статей.
 class CSldIndexes
@@ -28,6 +44,7 @@ public:
 		m_isDataHasListIndex(0),
 		m_isDataHasTranslationIndex(0),
 		m_isDataHasShiftIndex(0),
+		m_IsDataByteAligned(0),
 		m_TotalIndexDataSize(0)
 	{
 		sldMemZero(&m_Header, sizeof(m_Header));
@@ -42,8 +59,17 @@ public:
 	// Возвращает данные индекса по номеру слова и номеру перевода в слове
 	ESldError GetIndexData(Int32 aWordIndex, Int32 aWordTranslationIndex, Int32* aListIndex, Int32* aArticleIndex, Int32* aTranslationIndex, Int32* aShiftIndex);
 
+	// Возвращает данные всех ссылок слова
+	ESldError GetIndexData(Int32 aWordIndex, CSldVector<TSldIndexData> & aIndexData);
+
 private:
 
+	// Считывает данные нескольких подряд идущих ссылок
+	ESldError ReadIndexData(UInt32 aShiftData, UInt32 aCount, TSldIndexData* aIndexData);
+
+	// Распаковывает данные ссылок, записанные побайтово
+	void UnpackIndexData(const UInt8* aData, UInt32 aCount, TSldIndexData* aIndexData) const;
+
 	// Заголовок
 	TIndexesHeader m_Header;
 
@@ -79,6 +105,9 @@ private:
 	
 	// Индексы имеют в своем составе смещения в статье (иначе смещение == 0)
 	UInt8 m_isDataHasShiftIndex;
+
+	// Все поля данных индексов занимают целое число байт
+	UInt8 m_IsDataByteAligned;
 	
 	// Общий размер одного индекса в битах
 	UInt32 m_TotalIndexDataSize;
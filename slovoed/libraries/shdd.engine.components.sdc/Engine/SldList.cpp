@@ -1,6 +1,8 @@
 ﻿#include "SldList.h"
 
+#include "SldArena.h"
 #include "SldMacros.h"
+#include "SldStatistics.h"
 #include "SldTools.h"
 
 // Destructor
@@ -376,7 +378,7 @@ ESldError CSldList::Init(CSDCReadMy &aData, ISldLayerAccess* aLayerAccess, const
 		if (!m_Catalog)
 			return eMemoryNotEnoughMemory;
 
-		error = m_Catalog->Init(*m_data, pListHeader->Type_Hierarchy);
+		error = m_Catalog->Init(*m_data, pListHeader->Type_Hierarchy, pListHeader->Type_HierarchyParents);
 		if (error != eOK)
 			return error;
 	}
@@ -895,6 +897,9 @@ ESldError CSldList::GetMostSimilarWordByText(const UInt16* aText, UInt32* aResul
 	Int32 edit_distance = 0;
 	UInt32 maxLocalIndex = HighIndex - LowIndex;
 
+	// Буфер для слова без разделителей, увеличивается по мере необходимости
+	sld2::ScratchArray<UInt16> currentWordWithoutDelimiters;
+
 	for (i = BestWordIndex; i < maxLocalIndex;i++)
 	{
 		error = GetWordByIndex(i);
@@ -958,16 +963,17 @@ ESldError CSldList::GetMostSimilarWordByText(const UInt16* aText, UInt32* aResul
 			// Ищем наиболее похожее слово без учета разделителей, но с учетом регистра, ударений, диакритиков и пр.
 			Int32 len = GetCMP()->StrLen(GetWord(v));
 
-			UInt16* currentWordWithoutDelimiters = NULL;
-			currentWordWithoutDelimiters = (UInt16*)sldMemNew((len + 1)* sizeof(currentWordWithoutDelimiters[0]));
-			if (!currentWordWithoutDelimiters)
+			if (currentWordWithoutDelimiters.size() < (UInt32)len + 1)
+			{
+				if (!currentWordWithoutDelimiters.resize(sld2::default_init, len + 1))
 					return eMemoryNotEnoughMemory;
+			}
 
-			GetCMP()->StrEffectiveCopy(currentWordWithoutDelimiters, GetWord(v));
-			UInt32 lenWithoutDelimiters = GetCMP()->StrLen(currentWordWithoutDelimiters);
+			GetCMP()->StrEffectiveCopy(currentWordWithoutDelimiters.data(), GetWord(v));
+			UInt32 lenWithoutDelimiters = GetCMP()->StrLen(currentWordWithoutDelimiters.data());
 
 			if (len < ARRAY_DIM)
-				edit_distance = GetCMP()->FuzzyCompare(currentWordWithoutDelimiters, aText, lenWithoutDelimiters + 1, PatternLen, FuzzyBuffer);
+				edit_distance = GetCMP()->FuzzyCompare(currentWordWithoutDelimiters.data(), aText, lenWithoutDelimiters + 1, PatternLen, FuzzyBuffer);
 			else
 				edit_distance = len;
 			
@@ -976,8 +982,6 @@ ESldError CSldList::GetMostSimilarWordByText(const UInt16* aText, UInt32* aResul
 				MinimumEditDistance = edit_distance;
 				BestWordIndex = i;
 			}
-
-			sldMemFree(currentWordWithoutDelimiters);
 		}
 	}
 	
@@ -999,7 +1003,11 @@ ESldError CSldList::GetMostSimilarWordByText(const UInt16* aText, UInt32* aResul
 ESldError CSldList::GetNextWord(void)
 {
 	UInt16 shiftBuf[2] = {0};
-	ESldError error;
+	ESldError error = SyncCachedWordShift();
+	if (error != eOK)
+		return error;
+
+	SLD_STATISTICS_ADD(WordsDecoded, 1);
 
 	const TListHeader* pListHeader = GetListInfo()->GetHeader();
 
@@ -1964,6 +1972,29 @@ ESldError CSldList::GetFullTextTranslationData(Int32 aGlobalIndex, Int32 aWordTr
 	return eOK;
 }
 
+/** *********************************************************************
+* Возвращает данные всех переводов слова в списке слов полнотекстового поиска
+*
+* @param[in]	aGlobalIndex	- глобальный номер слова в списке слов
+* @param[out]	aTranslations	- вектор, в который будут помещены данные переводов:
+*								  номер списка слов, номер слова в списке, номер перевода и смещение
+*
+* @return error code
+************************************************************************/
+ESldError CSldList::GetFullTextTranslationData(Int32 aGlobalIndex, CSldVector<TSldIndexData> & aTranslations)
+{
+	if (!m_IsCatalogSynchronized)
+		return eCommonCatalogIsNotSynchronizedError;
+
+	if (!m_Indexes)
+		return eMemoryNullPointer;
+
+	if (m_LocalizedBaseGlobalIndex != SLD_DEFAULT_WORD_INDEX)
+		aGlobalIndex += m_LocalizedBaseGlobalIndex;
+
+	return m_Indexes->GetIndexData(aGlobalIndex, aTranslations);
+}
+
 /** ********************************************************************
 * Производит переход по указанному поисковому номеру.
 *
@@ -1974,6 +2005,7 @@ ESldError CSldList::GetFullTextTranslationData(Int32 aGlobalIndex, Int32 aWordTr
 ESldError CSldList::GoToBySearchIndex(Int32 aSearchIndex)
 {
 	ESldError error;
+	m_CachedWordShift = MAX_UINT_VALUE;
 	error = m_Input->GoTo(aSearchIndex);
 	if (error != eOK)
 		return error;
@@ -2353,9 +2385,20 @@ ESldError CSldList::GetWordByGlobalIndex(Int32 aGlobalIndex, const bool aInLocal
 	{
 		return eOK;
 	}
+	else if (m_WordsCache.IsInit() && RestoreCachedWord(aGlobalIndex))
+	{
+		return eOK;
+	}
 	else if (GetListInfo()->m_Header.Version == VERSION_LIST_DIRECT_ACCESS)
 	{
-		return GetWordByShift(aGlobalIndex);
+		error = GetWordByShift(aGlobalIndex);
+		if (error != eOK)
+			return error;
+
+		if (m_WordsCache.IsInit())
+			StoreCachedWord();
+
+		return eOK;
 	}
 	// Запрашивается следующее по порядку слово
 	else if (aGlobalIndex - GetCurrentWordIndex() == 1)
@@ -2403,6 +2446,8 @@ ESldError CSldList::GetWordByGlobalIndex(Int32 aGlobalIndex, const bool aInLocal
 			return error;
 	}
 
+	// Если слово совпало с точкой быстрого доступа, оно не декодировалось целиком, и кэшировать его нельзя
+	const bool isDecoded = GetCurrentWordIndex() < aGlobalIndex;
 	while (GetCurrentWordIndex() < aGlobalIndex)
 	{
 		error = GetNextWord();
@@ -2410,9 +2455,113 @@ ESldError CSldList::GetWordByGlobalIndex(Int32 aGlobalIndex, const bool aInLocal
 			return error;
 	}
 
+	if (isDecoded && m_WordsCache.IsInit())
+		StoreCachedWord();
+
 	return eOK;
 }
 
+/** *********************************************************************
+* Включает кэш декодированных слов для произвольного доступа по глобальному индексу
+*
+* В кэше хранятся все варианты написания слова и номера его медиа ресурсов, поэтому при повторном
+* обращении к слову через GetWordByGlobalIndex() оно не декодируется заново.
+* Последовательный перебор слов через GetNextWord() кэш не заполняет
+*
+* @param[in]	aCapacity	- количество слов в кэше, округляется вверх до степени двойки;
+*							  0 - выключает кэш
+*
+* @return error code
+************************************************************************/
+ESldError CSldList::SetDecodedWordsCacheSize(const UInt32 aCapacity)
+{
+	ESldError error = SyncCachedWordShift();
+	if (error != eOK)
+		return error;
+
+	return m_WordsCache.Init(aCapacity, GetListInfo()->GetNumberOfVariants());
+}
+
+/** *********************************************************************
+* Делает текущим слово из кэша декодированных слов, если оно там есть
+*
+* Входной поток при этом не трогается, позиция после слова запоминается и устанавливается
+* только перед следующим декодированием
+*
+* @param[in]	aGlobalIndex	- глобальный индекс слова
+*
+* @return true, если слово было в кэше
+************************************************************************/
+bool CSldList::RestoreCachedWord(const Int32 aGlobalIndex)
+{
+	const UInt32 slot = m_WordsCache.GetSlot(aGlobalIndex);
+	if (m_WordsCache.GlobalIndexes[slot] != aGlobalIndex)
+		return false;
+
+	const UInt16* word = m_WordsCache.Words[slot].data();
+	for (UInt32 i = 0; i < m_WordsCache.NumberOfVariants; i++)
+		word += CSldCompare::StrCopy(m_CurrentWord[i], word) + 1;
+
+	const Int32* indexes = &m_WordsCache.Indexes[slot * m_WordsCache.IndexesPerSlot()];
+	m_PictureIndex = indexes[0];
+	m_VideoIndex = indexes[1];
+	m_SoundIndex = indexes[2];
+	m_SceneIndex = indexes[3];
+	sld2::memmove_n(m_StylizedVariant.data(), indexes + 4, m_WordsCache.NumberOfVariants);
+
+	if (GetListInfo()->GetHeader()->Version != VERSION_LIST_BASE)
+		m_AltNameManager.m_LastShift = -1;
+
+	m_CurrentIndex = aGlobalIndex;
+	m_CachedWordShift = m_WordsCache.Shifts[slot];
+
+	return true;
+}
+
+/** *********************************************************************
+* Сохраняет текущее слово в кэш декодированных слов
+************************************************************************/
+void CSldList::StoreCachedWord()
+{
+	const UInt32 slot = m_WordsCache.GetSlot(m_CurrentIndex);
+
+	UInt32 wordsLength = 0;
+	for (UInt32 i = 0; i < m_WordsCache.NumberOfVariants; i++)
+		wordsLength += CSldCompare::StrLen(m_CurrentWord[i]) + 1;
+
+	CSldVector<UInt16> & words = m_WordsCache.Words[slot];
+	words.resize(wordsLength);
+
+	UInt16* word = words.data();
+	for (UInt32 i = 0; i < m_WordsCache.NumberOfVariants; i++)
+		word += CSldCompare::StrCopy(word, m_CurrentWord[i]) + 1;
+
+	Int32* indexes = &m_WordsCache.Indexes[slot * m_WordsCache.IndexesPerSlot()];
+	indexes[0] = m_PictureIndex;
+	indexes[1] = m_VideoIndex;
+	indexes[2] = m_SoundIndex;
+	indexes[3] = m_SceneIndex;
+	sld2::memmove_n(indexes + 4, m_StylizedVariant.data(), m_WordsCache.NumberOfVariants);
+
+	m_WordsCache.Shifts[slot] = m_Input->GetCurrentPosition();
+	m_WordsCache.GlobalIndexes[slot] = m_CurrentIndex;
+}
+
+/** *********************************************************************
+* Переводит входной поток на позицию после слова, взятого из кэша декодированных слов
+*
+* @return error code
+************************************************************************/
+ESldError CSldList::SyncCachedWordShift()
+{
+	if (m_CachedWordShift == MAX_UINT_VALUE)
+		return eOK;
+
+	const UInt32 shift = m_CachedWordShift;
+	m_CachedWordShift = MAX_UINT_VALUE;
+	return m_Input->SetCurrentPosition(shift);
+}
+
 /** *********************************************************************
 * Производит поиск слов по шаблону, в пределах текущего уровня вложенности
 *
@@ -2750,6 +2899,7 @@ ESldError CSldList::JumpByQAIndex(Int32 aIndex)
 
 	CSldCompare::StrCopy(m_CurrentWord[0], tmpText);
 
+	m_CachedWordShift = MAX_UINT_VALUE;
 	error = m_Input->GoTo(aIndex);
 	if (error != eOK)
 		return error;
@@ -3592,6 +3742,7 @@ ESldError CSldList::GoToCachedPoint(UInt32 aQAPointIndex, Int32 aNeedGlobalIndex
 			m_CurrentIndex = m_QAShift.LastGlobalIndex - 2;
 		}
 
+		m_CachedWordShift = MAX_UINT_VALUE;
 		error = m_Input->SetCurrentPosition(m_QAShift.Shift[localCashedIndex]);
 		if (error != eOK)
 			return error;
@@ -3633,6 +3784,38 @@ ESldError TCurrentQAWordsShift::Init(const Int32 aQAInterleaveSize, const UInt32
 	return eOK;
 }
 
+/** *********************************************************************
+* Инициализирует кэш декодированных слов
+*
+* @param[in]	aCapacity			- количество слов в кэше, округляется вверх до степени двойки;
+*									  0 - освобождает кэш
+* @param[in]	aNumberOfVariants	- количество вариантов написания в списке
+*
+* @return Код ошибки
+************************************************************************/
+ESldError TDecodedWordsCache::Init(const UInt32 aCapacity, const UInt32 aNumberOfVariants)
+{
+	UInt32 capacity = aCapacity ? 1 : 0;
+	while (capacity && capacity < aCapacity)
+		capacity <<= 1;
+
+	NumberOfVariants = aNumberOfVariants;
+
+	GlobalIndexes.resize(0);
+	Shifts.resize(0);
+	Indexes.resize(0);
+	Words.resize(0);
+	if (!capacity)
+		return eOK;
+
+	// GlobalIndexes выделяется последним, чтобы при нехватке памяти кэш остался выключенным
+	if (!Shifts.resize(capacity) || !Indexes.resize(capacity * IndexesPerSlot()) || !Words.resize(capacity) ||
+		!GlobalIndexes.resize(capacity, SLD_DEFAULT_WORD_INDEX))
+		return eMemoryNotEnoughMemory;
+
+	return eOK;
+}
+
 /** *********************************************************************
 * Переходит на новую QA-точку, очищая структуру быстрого поиска
 *
@@ -3862,34 +4045,142 @@ ESldError CSldList::GetWordByHistoryElement(CSldHistoryElement* aHistoryElement,
 	*aResultFlag = eHistoryNotCompare;
 	*aGlobalIndex = SLD_DEFAULT_WORD_INDEX;
 
-	ESldError error = eOK;
-	UInt32 massCompare = 0;
-	UInt16* currentElementShowVariant = NULL;
-	UInt16* currentWordShowVariant = NULL;
-
-	error = aHistoryElement->GetShowVariant(&currentElementShowVariant);
-	if(error != eOK)
-		return error;
-
 	// Проверяем текущее слово
 	if (aHistoryElement->GetWordIndex() < GetListInfo()->GetNumberOfGlobalWords())
 	{
-		error = GetWordByGlobalIndex(aHistoryElement->GetWordIndex());
-		if(error != eOK)
+		ESldError error = CheckHistoryElementIndex(*aHistoryElement, aResultFlag, aGlobalIndex);
+		if (error != eOK || *aResultFlag != eHistoryNotCompare)
 			return error;
+	}
 
-		error = GetCurrentWord(GetListInfo()->GetShowVariantIndex(), &currentWordShowVariant);
-		if(error != eOK)
+	// Если индекс слова сменился - пытаемся найти слово самостоятельно
+	return FindHistoryElementByText(*aHistoryElement, aResultFlag, aGlobalIndex);
+}
+
+/** *********************************************************************
+* Получает слова по набору элементов истории
+*
+* Сначала за один проход по возрастанию сохраненных индексов проверяются слова, оставшиеся на своих местах,
+* затем оставшиеся элементы ищутся по тексту в порядке сортировки их show-вариантов.
+* Результат для каждого элемента совпадает с результатом GetWordByHistoryElement()
+*
+* @param[in]	aHistoryElements	- элементы истории
+* @param[out]	aResultFlags		- массив размером с aHistoryElements, куда будут записаны результаты
+*									  для каждого элемента (см. #ESldHistoryResult)
+* @param[out]	aGlobalIndexes		- массив размером с aHistoryElements, куда будут записаны индексы найденных слов
+*
+* @return error code
+************************************************************************/
+ESldError CSldList::GetWordsByHistoryElements(sld2::Span<CSldHistoryElement* const> aHistoryElements, ESldHistoryResult* aResultFlags, Int32* aGlobalIndexes)
+{
+	if (!aResultFlags || !aGlobalIndexes)
+		return eMemoryNullPointer;
+
+	CSldVector<Int32> order;
+	order.reserve(aHistoryElements.size());
+	for (UInt32 elementIndex = 0; elementIndex < aHistoryElements.size(); elementIndex++)
+	{
+		if (!aHistoryElements[elementIndex])
+			return eMemoryNullPointer;
+
+		aResultFlags[elementIndex] = eHistoryNotCompare;
+		aGlobalIndexes[elementIndex] = SLD_DEFAULT_WORD_INDEX;
+		if (aHistoryElements[elementIndex]->GetWordIndex() < GetListInfo()->GetNumberOfGlobalWords())
+			order.push_back(elementIndex);
+	}
+
+	// Проверяем слова на сохраненных местах, двигаясь по списку только вперед
+	sld2::sort_indexes(order.data(), order.size(), [&aHistoryElements](Int32 aFirst, Int32 aSecond) {
+		const UInt32 first = aHistoryElements[aFirst]->GetWordIndex();
+		const UInt32 second = aHistoryElements[aSecond]->GetWordIndex();
+		return first < second ? -1 : first > second ? 1 : 0;
+	});
+
+	ESldError error;
+	for (Int32 elementIndex : order)
+	{
+		error = CheckHistoryElementIndex(*aHistoryElements[elementIndex], &aResultFlags[elementIndex], &aGlobalIndexes[elementIndex]);
+		if (error != eOK)
 			return error;
+	}
 
-		if (CompareHistoryElementWithCurrentWord(*aHistoryElement) == 0)
-		{
-			*aResultFlag = eHistoryFullCompare;
-			return GetCurrentGlobalIndex(aGlobalIndex);
-		}
+	// Ненайденные элементы ищем по тексту в порядке возрастания их массы
+	CSldSortKeys keys;
+	order.clear();
+	for (UInt32 elementIndex = 0; elementIndex < aHistoryElements.size(); elementIndex++)
+	{
+		if (aResultFlags[elementIndex] != eHistoryNotCompare)
+			continue;
+
+		UInt16* showVariant = NULL;
+		error = aHistoryElements[elementIndex]->GetShowVariant(&showVariant);
+		if (error != eOK)
+			return error;
+
+		keys.Add(*GetCMP(), showVariant, eSortKeyMass);
+		order.push_back(elementIndex);
 	}
 
-	// Если индекс слова сменился - пытаемся найти слово самостоятельно
+	CSldVector<Int32> textOrder(order.size());
+	for (UInt32 i = 0; i < textOrder.size(); i++)
+		textOrder[i] = i;
+	keys.Sort(textOrder);
+
+	for (Int32 keyIndex : textOrder)
+	{
+		const Int32 elementIndex = order[keyIndex];
+		error = FindHistoryElementByText(*aHistoryElements[elementIndex], &aResultFlags[elementIndex], &aGlobalIndexes[elementIndex]);
+		if (error != eOK)
+			return error;
+	}
+
+	return eOK;
+}
+
+/** *********************************************************************
+* Проверяет, находится ли слово элемента истории на сохраненном в нем месте
+*
+* @param[in]	aHistoryElement	- элемент истории, индекс слова в нем должен быть меньше количества слов в списке
+* @param[out]	aResultFlag		- указатель, по которому будет записан eHistoryFullCompare, если слово на месте
+* @param[out]	aGlobalIndex	- указатель, по которому будет записан индекс слова, если оно на месте
+*
+* @return error code
+************************************************************************/
+ESldError CSldList::CheckHistoryElementIndex(CSldHistoryElement & aHistoryElement, ESldHistoryResult* aResultFlag, Int32* aGlobalIndex)
+{
+	ESldError error = GetWordByGlobalIndex(aHistoryElement.GetWordIndex());
+	if (error != eOK)
+		return error;
+
+	if (CompareHistoryElementWithCurrentWord(aHistoryElement) == 0)
+	{
+		*aResultFlag = eHistoryFullCompare;
+		return GetCurrentGlobalIndex(aGlobalIndex);
+	}
+
+	return eOK;
+}
+
+/** *********************************************************************
+* Ищет слово элемента истории по тексту его show-варианта
+*
+* @param[in]	aHistoryElement	- элемент истории
+* @param[out]	aResultFlag		- указатель, по которому будет записан результат выполнения функции
+*								  (см. #ESldHistoryResult)
+* @param[out]	aGlobalIndex	- указатель, по которому будет записан индекс найденного слова
+*
+* @return error code
+************************************************************************/
+ESldError CSldList::FindHistoryElementByText(CSldHistoryElement & aHistoryElement, ESldHistoryResult* aResultFlag, Int32* aGlobalIndex)
+{
+	UInt32 massCompare = 0;
+	UInt16* currentElementShowVariant = NULL;
+	UInt16* currentWordShowVariant = NULL;
+
+	ESldError error = aHistoryElement.GetShowVariant(&currentElementShowVariant);
+	if (error != eOK)
+		return error;
+
 	error = GetWordByTextExtended(currentElementShowVariant, &massCompare, 0);
 	if(error != eOK)
 		return error;
@@ -3908,7 +4199,7 @@ ESldError CSldList::GetWordByHistoryElement(CSldHistoryElement* aHistoryElement,
 	while (isRealWord == 1 && GetCMP()->StrICmp(currentElementShowVariant, currentWordShowVariant) == 0)
 	{
 		UInt32 resultIndex = 0;
-		TSldPair<UInt32, CSldVector<Int32>> pair(CompareHistoryElementWithCurrentWord(*aHistoryElement, true), CSldVector<Int32>());
+		TSldPair<UInt32, CSldVector<Int32>> pair(CompareHistoryElementWithCurrentWord(aHistoryElement, true), CSldVector<Int32>());
 
 		if (sld2::binary_search(&weight_Index[0], weight_Index.size(), pair, &resultIndex))
 		{
@@ -3940,7 +4231,7 @@ ESldError CSldList::GetWordByHistoryElement(CSldHistoryElement* aHistoryElement,
 		if (error != eOK)
 			return error;
 
-		const Int32 checkResult = CompareHistoryElementWithCurrentWord(*aHistoryElement);
+		const Int32 checkResult = CompareHistoryElementWithCurrentWord(aHistoryElement);
 		if (checkResult == 0)
 		{
 			*aResultFlag = eHistoryFullCompare;
@@ -4011,6 +4302,7 @@ ESldError CSldList::GetWordByShift(UInt32 aWordIndex)
 	if (error != eOK)
 		return error;
 
+	m_CachedWordShift = MAX_UINT_VALUE;
 	error = m_Input->SetCurrentPosition(shift);
 	if (error != eOK)
 		return error;
@@ -4751,6 +5043,10 @@ ESldError CSldList::FindBinaryMatch(const UInt16* aText, UInt32* aResult)
 		if (GetListInfo()->GetNumberOfGlobalWords() > 1)
 		{
 			error = GetWordByGlobalIndex(GetListInfo()->GetNumberOfGlobalWords() - 2);
+			if (error != eOK)
+				return error;
+
+			error = SyncCachedWordShift();
 			if (error != eOK)
 				return error;
 			m_LastShift = m_Input->GetCurrentPosition();
@@ -4770,6 +5066,7 @@ ESldError CSldList::FindBinaryMatch(const UInt16* aText, UInt32* aResult)
 	if (GetCurrentWordIndex() < 1)
 	{
 		currentPos = 0;
+		m_CachedWordShift = MAX_UINT_VALUE;
 		error = m_Input->SetCurrentPosition(0);
 		if (error != eOK)
 			return error;
@@ -4781,6 +5078,10 @@ ESldError CSldList::FindBinaryMatch(const UInt16* aText, UInt32* aResult)
 		error = GetWordByGlobalIndex(GetCurrentWordIndex() - 1);
 		if (error != eOK)
 			return error;
+
+		error = SyncCachedWordShift();
+		if (error != eOK)
+			return error;
 	}
 
 	currentPos = m_Input->GetCurrentPosition();
@@ -5594,6 +5895,72 @@ UInt32 CSldList::CompareHistoryElementWithCurrentWord(CSldHistoryElement & aElem
 	return resultWeight;
 }
 
+/** *********************************************************************
+* Включает или выключает кэш сигнатур слов для отсева слов при поиске по шаблону
+*
+* Кэш занимает 16 байт на каждое слово списка. Сигнатуры в нем заполняются поиском по
+* шаблону по мере того, как он проверяет слова; выключение кэша освобождает память
+*
+* @param[in]	aEnable	- true - включить кэш, false - выключить
+*
+* @return error code
+************************************************************************/
+ESldError CSldList::SetWildCardSignaturesCache(bool aEnable)
+{
+	if (!aEnable)
+	{
+		m_WildCardSignatures = sld2::DynArray<TSldWildCardSignature>();
+		return eOK;
+	}
+
+	if (!m_WildCardSignatures.empty())
+		return eOK;
+
+	const UInt32 numberOfWords = GetListInfo()->m_Header.NumberOfWords;
+	sld2::DynArray<TSldWildCardSignature> signatures(numberOfWords);
+	if (signatures.size() != numberOfWords)
+		return eMemoryNotEnoughMemory;
+
+	m_WildCardSignatures = sld2::move(signatures);
+	return eOK;
+}
+
+/** *********************************************************************
+* Возвращает построенную сигнатуру слова для отсева слов при поиске по шаблону
+*
+* @param[in]	aGlobalIndex	- глобальный индекс слова в текущей локализации
+*
+* @return указатель на сигнатуру слова или NULL, если кэш сигнатур выключен или
+*         сигнатура слова еще не построена
+************************************************************************/
+const TSldWildCardSignature* CSldList::GetWildCardSignature(Int32 aGlobalIndex) const
+{
+	const Int32 wordIndex = m_LocalizedBaseGlobalIndex == SLD_DEFAULT_WORD_INDEX ? aGlobalIndex : aGlobalIndex + m_LocalizedBaseGlobalIndex;
+	if (wordIndex < 0 || (UInt32)wordIndex >= m_WildCardSignatures.size())
+		return NULL;
+
+	// Пустая сигнатура означает, что она еще не построена (у слов, сигнатура которых
+	// действительно пустая, она просто строится каждый раз заново)
+	const TSldWildCardSignature &signature = m_WildCardSignatures[wordIndex];
+	return signature.Grams == 0 && signature.Heads == 0 ? NULL : &signature;
+}
+
+/** *********************************************************************
+* Сохраняет в кэше сигнатуру слова, построенную при поиске по шаблону
+*
+* Сигнатура строится по строкам масс всех show-вариантов написания слова
+* (см. CSldCompare::AddWildCardSignature); если кэш сигнатур выключен, ничего не делает
+*
+* @param[in]	aGlobalIndex	- глобальный индекс слова в текущей локализации
+* @param[in]	aSignature		- сигнатура слова
+************************************************************************/
+void CSldList::SetWildCardSignature(Int32 aGlobalIndex, const TSldWildCardSignature &aSignature)
+{
+	const Int32 wordIndex = m_LocalizedBaseGlobalIndex == SLD_DEFAULT_WORD_INDEX ? aGlobalIndex : aGlobalIndex + m_LocalizedBaseGlobalIndex;
+	if (wordIndex >= 0 && (UInt32)wordIndex < m_WildCardSignatures.size())
+		m_WildCardSignatures[wordIndex] = aSignature;
+}
+
 /** *********************************************************************
 * Возвращает вектор индексов словаря для заданного слова
 *
@@ -44,6 +44,37 @@ struct TCurrentQAWordsShift
 	sld2::DynArray<UInt16>		Prefix;
 };
 
+// Кэш декодированных слов для произвольного доступа к списку по глобальному индексу
+// Слово хранится в ячейке с номером, равным младшим битам его индекса, и вытесняется следующим словом с тем же номером ячейки
+struct TDecodedWordsCache
+{
+	TDecodedWordsCache(void) :
+	NumberOfVariants(0)
+	{ }
+
+	// Initialization
+	ESldError Init(const UInt32 aCapacity, const UInt32 aNumberOfVariants);
+
+	bool IsInit() const { return !GlobalIndexes.empty(); }
+
+	// Возвращает номер ячейки для слова с заданным индексом
+	UInt32 GetSlot(const Int32 aGlobalIndex) const { return (UInt32)aGlobalIndex & (GlobalIndexes.size() - 1); }
+
+	// Количество чисел на ячейку в Indexes: номера картинки, видео, озвучки, сцены и индексы стилизованных вариантов
+	UInt32 IndexesPerSlot() const { return 4 + NumberOfVariants; }
+
+	UInt32		NumberOfVariants;
+
+	// Глобальные индексы слов в ячейках, SLD_DEFAULT_WORD_INDEX - ячейка пуста
+	sld2::DynArray<Int32>				GlobalIndexes;
+	// Позиции во входном потоке сразу после слова
+	sld2::DynArray<UInt32>				Shifts;
+	// Номера медиа ресурсов и стилизованных вариантов слов
+	sld2::DynArray<Int32>				Indexes;
+	// Все варианты написания слов подряд, каждый с завершающим нулем
+	sld2::DynArray<CSldVector<UInt16>>	Words;
+};
+
 // Элемент структуры бинарного поиска
 struct TBinaryTreeElement
 {
@@ -161,6 +192,7 @@ public:
 		m_CurrentDirectAccessResourceIndex(0),
 		m_IsCatalogSynchronized(1),
 		m_LastShift(-1),
+		m_CachedWordShift(MAX_UINT_VALUE),
 		m_SortedWordIndexes(NULL),
 		m_SortedVariantIndex(0),
 		m_WordsBuff(NULL),
@@ -279,6 +311,9 @@ public:
 	// Возвращает данные перевода по номеру слова и номеру перевода в списке слов полнотекстового поиска
 	ESldError GetFullTextTranslationData(Int32 aGlobalIndex, Int32 aWordTranslationIndex, Int32* aListIndex, Int32* aListEntryIndex, Int32* aTranslationIndex, Int32* aShiftIndex);
 
+	// Возвращает данные всех переводов слова в списке слов полнотекстового поиска
+	ESldError GetFullTextTranslationData(Int32 aGlobalIndex, CSldVector<TSldIndexData> & aTranslations);
+
 	// Возвращает путь к текущему положению в каталоге
 	ESldError GetCurrentPath(TCatalogPath* aPath);
 
@@ -416,9 +451,18 @@ public:
 	// Получает слово по элементу истории
 	ESldError GetWordByHistoryElement(CSldHistoryElement* aHistoryElement, ESldHistoryResult* aResultFlag, Int32* aGlobalIndex);
 
+	// Получает слова по набору элементов истории
+	ESldError GetWordsByHistoryElements(sld2::Span<CSldHistoryElement* const> aHistoryElements, ESldHistoryResult* aResultFlags, Int32* aGlobalIndexes);
+
 	// Возвращает количество слов из вспомогательного сортированного списка
 	UInt32 GetSortedWordsCount();
 
+	// Включает кэш декодированных слов для произвольного доступа по глобальному индексу
+	ESldError SetDecodedWordsCacheSize(const UInt32 aCapacity);
+
+	// Включает или выключает кэш сигнатур слов для отсева слов при поиске по шаблону
+	ESldError SetWildCardSignaturesCache(bool aEnable);
+
 	// Устанавливает значение флага синхронизации каталога с текущим индексом
 	ESldError SetCatalogSynchronizedFlag(UInt8 aFlag);
 
@@ -467,6 +511,15 @@ private:
 	// Получает слово напрямую при наличии массива Индекс - Смещение
 	ESldError GetWordByShift(UInt32 aWordIndex);
 
+	// Делает текущим слово из кэша декодированных слов, если оно там есть
+	bool RestoreCachedWord(const Int32 aGlobalIndex);
+
+	// Сохраняет текущее слово в кэш декодированных слов
+	void StoreCachedWord();
+
+	// Переводит входной поток на позицию после слова, взятого из кэша
+	ESldError SyncCachedWordShift();
+
 	// Получает смещение для текущего индекса
 	ESldError GetShiftByIndex(UInt32 aWordIndex, UInt32* aShift);
 
@@ -503,6 +556,18 @@ private:
 	// Сравнивает все варианты элемента истории и текущего слова
 	UInt32 CompareHistoryElementWithCurrentWord(CSldHistoryElement & aElement, bool aByMass = false);
 
+	// Проверяет, находится ли слово элемента истории на сохраненном в нем месте
+	ESldError CheckHistoryElementIndex(CSldHistoryElement & aHistoryElement, ESldHistoryResult* aResultFlag, Int32* aGlobalIndex);
+
+	// Ищет слово элемента истории по тексту его show-варианта
+	ESldError FindHistoryElementByText(CSldHistoryElement & aHistoryElement, ESldHistoryResult* aResultFlag, Int32* aGlobalIndex);
+
+	// Возвращает построенную сигнатуру слова для отсева слов при поиске по шаблону
+	const TSldWildCardSignature* GetWildCardSignature(Int32 aGlobalIndex) const;
+
+	// Сохраняет в кэше сигнатуру слова, построенную при поиске по шаблону
+	void SetWildCardSignature(Int32 aGlobalIndex, const TSldWildCardSignature &aSignature);
+
 
 
 	// Возвращает указатель на заголовок данного списка слов
@@ -606,6 +671,13 @@ private:
 	// Аналог NumberOfWords, для проверки граничных условий в списках со скрытыми словами
 	UInt32						m_LastShift;
 
+	// Кэш декодированных слов
+	TDecodedWordsCache			m_WordsCache;
+
+	// Позиция во входном потоке после текущего слова, если оно было взято из кэша.
+	// Входной поток переводится на нее только перед следующим декодированием, MAX_UINT_VALUE - поток уже на месте
+	UInt32						m_CachedWordShift;
+
 	// Массив индексов статей с стилизованными вариантами написания
 	sld2::DynArray<Int32>		m_StylizedVariant;
 
@@ -618,6 +690,9 @@ private:
 	// Буфер, для сортировки слов
 	UInt16**					m_WordsBuff;
 
+	// Кэш сигнатур слов списка для поиска по шаблону (сигнатура строится при первой проверке слова)
+	sld2::DynArray<TSldWildCardSignature> m_WildCardSignatures;
+
 	// Данные о смреженых словарях
 	const TMergedDictInfo*		m_MergedDictInfo;
 };
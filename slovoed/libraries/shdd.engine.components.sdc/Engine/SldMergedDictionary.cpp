@@ -356,6 +356,27 @@ ESldError CSldMergedDictionary::GetNumberOfLists(Int32* aNumberOfLists) const
 	return eOK;
 }
 
+/** *********************************************************************
+* Проверяет, что список слов получен слиянием словарей и его содержимое не меняется
+*
+* @param[in]	aListIndex	- номер списка слов
+*
+* @return true, если список статический
+************************************************************************/
+bool CSldMergedDictionary::IsStaticList(Int32 aListIndex) const
+{
+	// Списки, добавленные после слияния, - поисковые и пользовательские
+	if (aListIndex < 0 || (UInt32)aListIndex >= m_MergedMetaInfo.WordIndexes.size())
+		return false;
+
+	const CSldListInfo* listInfo = NULL;
+	if (GetWordListInfo(aListIndex, &listInfo) != eOK)
+		return false;
+
+	const UInt32 listUsage = listInfo->GetUsage();
+	return listUsage != eWordListType_RegularSearch && listUsage != eWordListType_CustomList;
+}
+
 /** *********************************************************************
 * Возвращает класс, хранящий информацию о свойствах списка слов
 *
@@ -759,7 +780,11 @@ ESldError CSldMergedDictionary::DoFullTextSearch(Int32 aListIndex, const UInt16*
 		{
 			if (mergedListIndex == aListIndex)
 			{
+				// Контекст поиска передается словарю только на время поиска
+				CSldSearchContext *prevContext = dict->GetSearchContext();
+				dict->SetSearchContext(GetSearchContext());
 				error = dict->DoFullTextSearch(listIndex, aText, aMaximumWords);
+				dict->SetSearchContext(prevContext);
 				if (error != eOK)
 					return error;
 
@@ -807,6 +832,8 @@ ESldError CSldMergedDictionary::DoFullTextSearch(Int32 aListIndex, const UInt16*
 	if (error != eOK)
 		return error;
 
+	pSearchList->SetSearchContext(GetSearchContext());
+
 	error = pSearchList->SetMaximumLists(m_MergedWordlists.size());
 	if (error != eOK)
 		return error;
@@ -947,6 +974,55 @@ ESldError CSldMergedDictionary::UpdateHistoryElement(CSldHistoryElement* aHistor
 	return eOK;
 }
 
+/** *********************************************************************
+* Обновляет набор элементов истории до текущего состояния базы
+*
+* Элементы каждого из слитых словарей обновляются вместе, см. CSldDictionary::UpdateHistoryElements()
+*
+* @param[in]	aHistoryElements	- элементы истории
+* @param[out]	aResultFlags		- массив размером с aHistoryElements, куда будут записаны результаты
+*									  для каждого элемента (см. #ESldHistoryResult)
+*
+* @return error code
+************************************************************************/
+ESldError CSldMergedDictionary::UpdateHistoryElements(sld2::Span<CSldHistoryElement> aHistoryElements, ESldHistoryResult* aResultFlags)
+{
+	if (!aResultFlags)
+		return eMemoryNullPointer;
+
+	for (UInt32 elementIndex = 0; elementIndex < aHistoryElements.size(); elementIndex++)
+		aResultFlags[elementIndex] = eHistoryNotCompare;
+
+	ESldError error = eOK;
+	UInt32 dictID = 0;
+	CSldVector<UInt32> updatedDictIDs;
+	CSldVector<ESldHistoryResult> resultFlags(aHistoryElements.size());
+	for (auto && dict : m_Dictionaries)
+	{
+		error = dict->GetDictionaryID(&dictID);
+		if (error != eOK)
+			return error;
+
+		// Как и в UpdateHistoryElement(), элементы обновляются только в первом словаре с их идентификатором
+		if (sld2::sorted_find(updatedDictIDs, dictID) != updatedDictIDs.npos)
+			continue;
+
+		sld2::sorted_insert(updatedDictIDs, dictID);
+
+		error = dict->UpdateHistoryElements(aHistoryElements, resultFlags.data());
+		if (error != eOK)
+			return error;
+
+		for (UInt32 elementIndex = 0; elementIndex < aHistoryElements.size(); elementIndex++)
+		{
+			if (resultFlags[elementIndex] != eHistoryNotCompare)
+				aResultFlags[elementIndex] = resultFlags[elementIndex];
+		}
+	}
+
+	return eOK;
+}
+
 /** *********************************************************************
 * Получает слово по элементу истории, при необходимости переключает списки
 *
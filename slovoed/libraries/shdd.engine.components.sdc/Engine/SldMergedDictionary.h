@@ -38,6 +38,9 @@ public:
 	// Возвращает количество списков слов
 	ESldError GetNumberOfLists(Int32 *aNumberOfLists) const override;
 
+	// Проверяет, что список слов получен слиянием словарей и не пересоздается
+	bool IsStaticList(Int32 aListIndex) const override;
+
 	// Возвращает класс, хранящий информацию о свойствах списка слов
 	ESldError GetWordListInfo(Int32 aListIndex, const CSldListInfo **aListInfo) const override;
 
@@ -101,6 +104,9 @@ public:
 	// Обновляет элемент истории до текущего состояния базы
 	ESldError UpdateHistoryElement(CSldHistoryElement* aHistoryElement, ESldHistoryResult* aResultFlag) override;
 
+	// Обновляет набор элементов истории до текущего состояния базы
+	ESldError UpdateHistoryElements(sld2::Span<CSldHistoryElement> aHistoryElements, ESldHistoryResult* aResultFlags) override;
+
 private:
 
 	// Инициализация членов по умолчанию
@@ -6,8 +6,7 @@
 #include "SldTypeDefs.h"
 #include "SldSDCReadMy.h"
 #include "SldStringReference.h"
-
-class CSldStringStore;
+#include "SldStringStore.h"
 
 class CSldMetadataManager
 {
@@ -36,6 +35,29 @@ public:
 	// Возвращает строку метаданных живущую в string store
 	ESldError GetString(UInt32 aIndex, SldU16StringRef &aString);
 
+	/**
+	 * Возвращает набор строк метаданных по глобальным индексам
+	 *
+	 * @param[in]  aIndexes - массив глобальных индексов строк
+	 * @param[in]  aFunc    - функтор с сигнатурой `void (UInt32 aPos, SldU16StringRef aString)`
+	 *
+	 * Подробности в CSldStringStore::GetStrings()
+	 *
+	 * @return error code
+	 */
+	template <typename Func>
+	ESldError GetStrings(sld2::Span<const UInt32> aIndexes, Func&& aFunc) {
+		return m_strings ? m_strings->GetStrings(aIndexes, sld2::forward<Func>(aFunc)) : eCommonWrongIndex;
+	}
+
+	// Возвращает количество строк метаданных
+	UInt32 GetStringCount() const { return m_strings ? m_strings->GetStringCount() : 0; }
+
+	// Устанавливает количество одновременно загруженных ресурсов string store
+	ESldError SetStringsResidentResourceCount(UInt32 aCount) {
+		return m_strings ? m_strings->SetResidentResourceCount(aCount) : eOK;
+	}
+
 private:
 
 	// loads metadata using the global index, type and size
@@ -217,10 +217,14 @@ static UInt16* allocate(CSldMetadataParser::TStrings &strings, UInt32 aLen, TMet
 
 // Initialization
 CSldMetadataParser::CSldMetadataParser(CSldDictionary *aDict, CSldCSSUrlResolver *aResolver, UInt16 *aMem, UInt16 aMemSize)
-	: m_dictionary(aDict), m_metadataManager(aDict ? aDict->GetMetadataManager() : nullptr), m_resolver(aResolver),
+	: m_dictionary(aDict), m_metadataManager(nullptr), m_resolver(aResolver),
 	  m_mergeInfo(aDict ? aDict->GetMergeInfo() : nullptr),
 	  m_mergedDictIdx(m_mergeInfo ? aDict->GetMergedDictIndex() : 0)
 {
+	// если метаданные не удалось загрузить, парсер работает так же, как для словаря без них
+	if (aDict)
+		aDict->GetMetadataManager(&m_metadataManager);
+
 	init(m_strings, aMem, aMemSize);
 }
 
@@ -2520,11 +2524,14 @@ ESldError CSldMetadataParser::GetCSSStyleString(UInt32 aIndex, SldU16String &aSt
 		return eOK;
 	}
 
-	CSldCSSDataManager *manager = m_dictionary->GetCSSDataManager();
+	CSldCSSDataManager *manager;
+	ESldError error = m_dictionary->GetCSSDataManager(&manager);
+	if (error != eOK)
+		return error;
 	if (!manager)
 		return eMetadataErrorNoCSSData;
 
 	// mask off the dictionary id
 	aIndex &= sld2::bit_mask32(MergedCSSBlockIndexBits);
-	return manager->GetCSSStyleString(aIndex, &aString, aResolver);
+	return manager->GetCSSStyleString(aIndex, &aString, aResolver, *m_dictionary);
 }
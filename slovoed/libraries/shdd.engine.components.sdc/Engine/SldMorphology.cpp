@@ -23,6 +23,11 @@ public:
 
 	UInt32 GetSize() const override { return m_size; }
 
+	void Prefetch(UInt32 aOffset, UInt32 aSize) override {
+		if (m_file)
+			m_file->Prefetch(m_shift + aOffset, aSize);
+	}
+
 private:
 	ISDCFile *m_file;
 	UInt32   m_shift;
@@ -62,6 +62,17 @@ typedef float     Float32;
  *    controls miscellaneous memory functions (memset()/memcpy() & friends)
  * So it's eg. possible to use a custom memory allocator and still use library
  * memcpy()/memset().
+ *
+ * SLD__HAVE_MEM_ALLOCATOR_HOOK
+ *
+ * If defined (and SLD__HAVE_MEM_MGR_ALLOCATOR is not) the default memory
+ * allocation functions go through the allocator installed at runtime with
+ * sldSetMemoryAllocator() and fall back to malloc()/free() when none is set.
+ * The allocator is process-wide: install it before the Engine allocates
+ * anything and keep it alive until all of the Engine objects are destroyed.
+ *
+ * NOTE: Scratch memory for temporary buffers of a single dictionary operation
+ *       does not need a custom allocator, see SldArena.h
  */
 #ifdef SLD__HAVE_MEM_MGR
 #  define SLD__HAVE_MEM_MGR_ALLOCATOR
@@ -86,6 +97,46 @@ void *sldMemNewZero(UInt32 aSize);
 
 #include <stdlib.h> /* malloc, calloc, free */
 
+#ifdef SLD__HAVE_MEM_ALLOCATOR_HOOK
+
+// Memory allocator installed with sldSetMemoryAllocator()
+class ISldMemoryAllocator
+{
+public:
+	virtual ~ISldMemoryAllocator() {}
+
+	// Allocates a block of aSize bytes, returns NULL on error
+	virtual void *Allocate(UInt32 aSize) = 0;
+
+	// Allocates a block of aSize bytes filled with zeros, returns NULL on error
+	virtual void *AllocateZero(UInt32 aSize) = 0;
+
+	// Resizes the block allocated by this allocator (aPtr may be NULL), returns NULL on error
+	virtual void *Reallocate(void *aPtr, UInt32 aSize) = 0;
+
+	// Frees the block allocated by this allocator (aPtr may be NULL)
+	virtual void Free(void *aPtr) = 0;
+};
+
+// Returns a reference to the current memory allocator (NULL - malloc()/free())
+inline ISldMemoryAllocator*& sldMemoryAllocator()
+{
+	static ISldMemoryAllocator *allocator = NULL;
+	return allocator;
+}
+
+/**
+ * Installs the memory allocator used by sldMemNew() & friends
+ *
+ * @param[in] aAllocator - allocator, NULL to return to malloc()/free()
+ */
+inline void sldSetMemoryAllocator(ISldMemoryAllocator *aAllocator)
+{
+	sldMemoryAllocator() = aAllocator;
+}
+
+#endif // SLD__HAVE_MEM_ALLOCATOR_HOOK
+
 /**
  * Allocates a block of memory
  *
@@ -95,6 +146,10 @@ void *sldMemNewZero(UInt32 aSize);
  */
 static inline void *sldMemNew(UInt32 aSize)
 {
+#ifdef SLD__HAVE_MEM_ALLOCATOR_HOOK
+	if (ISldMemoryAllocator *allocator = sldMemoryAllocator())
+		return allocator->Allocate(aSize);
+#endif
 	return malloc(aSize);
 }
 
@@ -107,6 +162,10 @@ static inline void *sldMemNew(UInt32 aSize)
  ************************************************************************/
 static inline void *sldMemNewZero(UInt32 aSize)
 {
+#ifdef SLD__HAVE_MEM_ALLOCATOR_HOOK
+	if (ISldMemoryAllocator *allocator = sldMemoryAllocator())
+		return allocator->AllocateZero(aSize);
+#endif
 	return calloc(1, aSize);
 }
 
@@ -120,6 +179,10 @@ static inline void *sldMemNewZero(UInt32 aSize)
  */
 static inline void *sldMemRealloc(void *aPtr, UInt32 aSize)
 {
+#ifdef SLD__HAVE_MEM_ALLOCATOR_HOOK
+	if (ISldMemoryAllocator *allocator = sldMemoryAllocator())
+		return allocator->Reallocate(aPtr, aSize);
+#endif
 	return realloc(aPtr, aSize);
 }
 
@@ -130,6 +193,13 @@ static inline void *sldMemRealloc(void *aPtr, UInt32 aSize)
  */
 static inline void sldMemFree(void *aPtr)
 {
+#ifdef SLD__HAVE_MEM_ALLOCATOR_HOOK
+	if (ISldMemoryAllocator *allocator = sldMemoryAllocator())
+	{
+		allocator->Free(aPtr);
+		return;
+	}
+#endif
 	free(aPtr);
 }
 
@@ -307,4 +377,55 @@ inline void sldDelete(T *aPtr)
 	sldMemFree(aPtr);
 }
 
+/**
+ * SLD__HAVE_STATISTICS
+ *
+ * If defined the Engine collects performance counters (see SldStatistics.h)
+ * available through CSldDictionary::GetStatistics() and calls the
+ * ISldLayerAccess::TraceBegin()/TraceEnd() hooks around dictionary operations.
+ * Without it all of the counting code is compiled out.
+ *
+ * SLD__HAVE_SCRATCH_ARENA
+ *
+ * If defined every dictionary search and translation runs inside a scope of the
+ * dictionary's own bump arena (see SldArena.h) and the temporary buffers of the
+ * hot paths (sld2::ScratchArray) are carved out of it instead of the heap.
+ * Requires thread_local support. Without it sld2::ScratchArray uses sldMemNew().
+ *
+ * SLD__HAVE_SEARCH_DEADLINE
+ *
+ * If defined the Engine supports search deadlines (see CSldSearchContext::SetDeadline()).
+ * Cancellation and result limits of the search context are always available.
+ *
+ * SLD__HAVE_MONOTONIC_CLOCK
+ *
+ * If defined instructs the Engine to use the platform provided monotonic clock
+ * sldMonotonicTime() instead of clock_gettime(CLOCK_MONOTONIC). The clock is only
+ * used by the two features above.
+ */
+#if defined(SLD__HAVE_STATISTICS) || defined(SLD__HAVE_SEARCH_DEADLINE)
+
+#ifdef SLD__HAVE_MONOTONIC_CLOCK
+
+// Returns monotonic time in nanoseconds
+UInt64 sldMonotonicTime();
+
+#else
+
+#include <time.h> /* clock_gettime */
+
+/**
+ * Returns monotonic time in nanoseconds
+ */
+static inline UInt64 sldMonotonicTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return UInt64(ts.tv_sec) * 1000000000u + UInt64(ts.tv_nsec);
+}
+
+#endif // SLD__HAVE_MONOTONIC_CLOCK
+
+#endif // SLD__HAVE_STATISTICS || SLD__HAVE_SEARCH_DEADLINE
+
 #endif //_SLD_PLATFORM_H_
@@ -3,9 +3,10 @@
 #include "SDC_CRC.h"
 #include "SldCompare.h"
 #include "SldDynArray.h"
+#include "SldStatistics.h"
 
 // The size of one data block in bytes for calculating the CRC of the direct resource data
-#define CRC_DATA_BLOCK_SIZE			(0xFFFF)
+#define CRC_DATA_BLOCK_SIZE			(0x40000)
 
 enum : UInt32 { InvalidResourceIndex = ~0u };
 
@@ -61,6 +62,7 @@ struct File {
 	File(ISDCFile *file, UInt32 offset) : file(file), offset(offset) {}
 	bool operator()(void *aData, UInt32 aSize) const
 	{
+		SLD_STATISTICS_ADD(BytesRead, aSize);
 		return file->Read(aData, aSize, offset) == aSize;
 	}
 };
@@ -116,10 +118,11 @@ static inline ESldError read(void **aData, UInt32 *aSize, UInt32 aReadSize, Read
 	return error;
 }
 
-template <bool InPlace>
+// @aVerify is called for the stored (compressed) data before it's unpacked
+template <bool InPlace, typename Verifier>
 static inline ESldError loadCompressed(const SlovoEdContainerResourcePosition &aResource,
 									   ISDCFile *aFile, sld2::DynArray<UInt8> &aCompressedData,
-									   void **aData, UInt32 *aSize)
+									   void **aData, UInt32 *aSize, Verifier&& aVerify)
 {
 	// assert(isCompressed(aResource));
 	// as the highest bit is used as a flag we have to mask it off
@@ -131,9 +134,14 @@ static inline ESldError loadCompressed(const SlovoEdContainerResourcePosition &a
 			return eMemoryNotEnoughMemory;
 	}
 
+	SLD_STATISTICS_ADD(BytesRead, size);
 	if (aFile->Read(aCompressedData.data(), size, aResource.Shift) != size)
 		return eResourceCantGetResource;
 
+	ESldError error = aVerify(aCompressedData.data(), size);
+	if (error != eOK)
+		return error;
+
 	auto header = (const SlovoEdContainerCompressedResourceHeader*)aCompressedData.data();
 	const char *data = (const char*)aCompressedData.data() + sizeof(*header);
 	size -= sizeof(*header);
@@ -168,6 +176,7 @@ CSDCReadMy::CSDCReadMy(void)
 	m_resTable = NULL;
 	m_Property = NULL;
 	m_FileData = NULL;
+	m_VerifyResources = false;
 }
 
 CSDCReadMy::~CSDCReadMy(void)
@@ -230,6 +239,23 @@ ESldError CSDCReadMy::Open(ISDCFile *aFile)
 		return eResourceCantOpenContainer;
 	}
 
+	if (m_VerifyResources && m_Header.ResourceCRCTableShift)
+	{
+		const UInt32 count = m_Header.NumberOfResources;
+		if (!m_resCRC.resize(sld2::default_init, count) || !m_resVerified.resize((count + 31) / 32))
+		{
+			Close();
+			return eMemoryNotEnoughMemory;
+		}
+
+		const UInt32 crcTableSize = sizeof(m_resCRC[0]) * count;
+		if (m_FileData->Read(m_resCRC.data(), crcTableSize, m_Header.ResourceCRCTableShift) != crcTableSize)
+		{
+			Close();
+			return eResourceCantOpenContainer;
+		}
+	}
+
 	if (m_Property)
 		sldMemZero(m_Property, sizeof(*m_Property));
 
@@ -258,6 +284,9 @@ void CSDCReadMy::Close()
 		sldMemFree(m_Property);
 	m_Property = NULL;
 
+	m_resCRC = sld2::DynArray<UInt32>();
+	m_resVerified = sld2::DynArray<UInt32>();
+
 	sldMemZero(&m_Header, sizeof(m_Header));
 }
 
@@ -455,14 +484,26 @@ CSDCReadMy::ResourceHandle CSDCReadMy::GetResource(UInt32 aResType, UInt32 aResI
 	ESldError err;
 	if (hasCompression(m_Header) && isCompressed(position))
 	{
-		err = loadCompressed<false>(position, m_FileData, m_compressedData, &ptr, &size);
+		err = loadCompressed<false>(position, m_FileData, m_compressedData, &ptr, &size,
+									[this, index](const void *aStoredData, UInt32 aStoredSize) { return VerifyResource(index, aStoredData, aStoredSize); });
+		if (err != eOK)
+			return err;
 	}
 	else
 	{
 		err = read<false>(&ptr, &size, position.Size, readers::File(m_FileData, position.Shift));
+		if (err != eOK)
+			return err;
+
+		err = VerifyResource(index, ptr, size);
+		if (err != eOK)
+		{
+			sldMemFree(ptr);
+			return err;
+		}
 	}
-	if (err != eOK)
-		return err;
+
+	SLD_STATISTICS_ADD(ResourcesLoaded, 1);
 
 	ResourceStruct *resource;
 	if (!empty(m_freeList))
@@ -485,6 +526,33 @@ CSDCReadMy::ResourceHandle CSDCReadMy::GetResource(UInt32 aResType, UInt32 aResI
 	return ResourceHandle(resource);
 }
 
+/**
+ * Checks the stored resource data against the checksum from the container, every resource
+ * is checked only once, when it is loaded for the first time
+ *
+ * @param[in] aIndexInTable - resource index in the resource location table
+ * @param[in] aData         - stored resource data (before unpacking)
+ * @param[in] aSize         - stored resource data size
+ *
+ * @return error code
+ */
+ESldError CSDCReadMy::VerifyResource(UInt32 aIndexInTable, const void *aData, UInt32 aSize)
+{
+	if (m_resCRC.empty())
+		return eOK;
+
+	const UInt32 bit = 1u << (aIndexInTable % 32);
+	UInt32 &verified = m_resVerified[aIndexInTable / 32];
+	if (verified & bit)
+		return eOK;
+
+	if (CRC32((const UInt8*)aData, aSize, SDC_CRC32_START_VALUE, true) != m_resCRC[aIndexInTable])
+		return eResourceWrongCRC;
+
+	verified |= bit;
+	return eOK;
+}
+
 /**
  * Frees resource data
  */
@@ -524,12 +592,28 @@ ESldError CSDCReadMy::GetResourceData(void* aData, UInt32 aResType, UInt32 aResI
 
 	const SlovoEdContainerResourcePosition &resource = m_resTable[index];
 	if (hasCompression(m_Header) && isCompressed(resource))
-		return loadCompressed<true>(resource, m_FileData, m_compressedData, &aData, aDataSize);
+	{
+		ESldError error = loadCompressed<true>(resource, m_FileData, m_compressedData, &aData, aDataSize,
+											   [this, index](const void *aStoredData, UInt32 aStoredSize) { return VerifyResource(index, aStoredData, aStoredSize); });
+		if (error == eOK)
+			SLD_STATISTICS_ADD(ResourcesLoaded, 1);
+		return error;
+	}
 
 	const UInt32 readSize = (sld2::min)(resource.Size, *aDataSize);
+	SLD_STATISTICS_ADD(BytesRead, readSize);
 	if (m_FileData->Read(aData, readSize, resource.Shift) != readSize)
 		return eResourceCantGetResource;
 
+	// a partially read resource can't be checked
+	if (readSize == resource.Size)
+	{
+		ESldError error = VerifyResource(index, aData, readSize);
+		if (error != eOK)
+			return error;
+	}
+
+	SLD_STATISTICS_ADD(ResourcesLoaded, 1);
 	*aDataSize = readSize;
 	return eOK;
 }
@@ -615,6 +699,62 @@ ESldError CSDCReadMy::GetResourceShiftAndSize(UInt32 *aShift, UInt32 *aSize, UIn
 	return eOK;
 }
 
+/***********************************************************************
+* Hints the container file that the given range of resources of the same type will be read soon
+*
+* Resources which lie next to each other in the file are passed to ISDCFile::Prefetch()
+* as a single block. Missing resources are silently skipped
+*
+* @param[in] aResType		- resource type
+* @param[in] aFirstIndex	- number of the first resource of the range
+* @param[in] aCount			- number of resources in the range
+************************************************************************/
+void CSDCReadMy::PrefetchResources(UInt32 aResType, UInt32 aFirstIndex, UInt32 aCount)
+{
+	if (!m_FileData || !aCount)
+		return;
+
+	UInt32 indexInTable = GetResourceIndexInTable(aResType, aFirstIndex);
+	if (indexInTable == InvalidResourceIndex)
+		return;
+
+	const UInt32 resourceCount = GetNumberOfResources();
+	UInt32 blockShift = 0;
+	UInt32 blockSize = 0;
+	for (UInt32 i = 0; i < aCount; i++)
+	{
+		if (i)
+		{
+			// in a sorted table resources of the same type follow each other, otherwise we have to look them up
+			const UInt32 next = indexInTable + 1;
+			if (m_Header.IsResourceTableSorted && next < resourceCount &&
+				m_resTable[next].Type == aResType && m_resTable[next].Index == aFirstIndex + i)
+				indexInTable = next;
+			else
+				indexInTable = GetResourceIndexInTable(aResType, aFirstIndex + i);
+
+			if (indexInTable == InvalidResourceIndex)
+				break;
+		}
+
+		const SlovoEdContainerResourcePosition &position = m_resTable[indexInTable];
+		const UInt32 size = position.Size & ~(1u << 31);
+		if (blockSize && blockShift + blockSize == position.Shift)
+		{
+			blockSize += size;
+			continue;
+		}
+
+		if (blockSize)
+			m_FileData->Prefetch(blockShift, blockSize);
+		blockShift = position.Shift;
+		blockSize = size;
+	}
+
+	if (blockSize)
+		m_FileData->Prefetch(blockShift, blockSize);
+}
+
 /***********************************************************************
 * Get resource index in the resource location table by its type and number
 *
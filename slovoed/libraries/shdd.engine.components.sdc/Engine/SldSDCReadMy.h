@@ -202,6 +202,9 @@ public:
 	// Gets the offset from the beginning of the file to the resource with the given type and number
 	ESldError GetResourceShiftAndSize(UInt32 *aShift, UInt32 *aSize, UInt32 aResType, UInt32 aResIndex) const;
 
+	// Hints the container file that the given range of resources of the same type will be read soon
+	void PrefetchResources(UInt32 aResType, UInt32 aFirstIndex, UInt32 aCount);
+
 	// Returns the base property for the given key
 	bool GetPropertyByKey(const UInt16* aKey, UInt16** aValue);
 	// Returns the number of additional properties of the base
@@ -221,6 +224,13 @@ public:
 	// We check the integrity of the container.
 	SDCError CheckData(void);
 
+	// Enables checking the integrity of every resource when it is loaded for the first time
+	// Takes effect on the next Open(), only for containers with resource checksums
+	void SetResourceVerification(bool aEnable) { m_VerifyResources = aEnable; }
+
+	// Checks whether the container has resource checksums
+	bool HasResourceCRC() const { return m_Header.ResourceCRCTableShift != 0; }
+
 	// Gets a pointer to the current container file
 	ISDCFile* GetFileData();
 
@@ -235,6 +245,9 @@ private:
 	// Releases resource data if its refcount falls to 0
 	void CloseResource(ResourceStruct *aResource);
 
+	// Checks the stored resource data against its checksum
+	ESldError VerifyResource(UInt32 aIndexInTable, const void *aData, UInt32 aSize);
+
 	static inline ResourceStruct* to_resource(sld2::list_node *node) {
 		return sld2_container_of(node, ResourceStruct, &ResourceStruct::link);
 	}
@@ -261,6 +274,15 @@ private:
 
 	// Cache for reading packed resources
 	sld2::DynArray<UInt8>					m_compressedData;
+
+	// Resource checksums in the resource location table order (empty if resources are not verified)
+	sld2::DynArray<UInt32>					m_resCRC;
+
+	// Bitmap of the resources which have already been verified
+	sld2::DynArray<UInt32>					m_resVerified;
+
+	// Flag to verify resources when they are loaded
+	bool									m_VerifyResources;
 };
 
 // ResourceHandle equality comparsion operators to simplify error checking
@@ -0,0 +1,132 @@
+﻿#ifndef _SLD_SEARCH_CONTEXT_H_
+#define _SLD_SEARCH_CONTEXT_H_
+
+#include "SldPlatform.h"
+
+// Причина, по которой завершился поиск
+enum ESldSearchStatus
+{
+	// Поиск выполнен полностью
+	eSearchStatus_Complete = 0,
+	// Поиск прерван по запросу оболочки (токен отмены или eExceptionSearchStop из ISldLayerAccess::WordFound())
+	eSearchStatus_Cancelled,
+	// Поиск прерван по истечении крайнего срока
+	eSearchStatus_DeadlineExceeded,
+	// Найдено максимально допустимое количество результатов
+	eSearchStatus_ResultLimitReached
+};
+
+// Токен отмены поиска
+class ISldSearchCancellation
+{
+public:
+	virtual ~ISldSearchCancellation() {}
+
+	// Возвращает true, если поиск нужно прервать
+	// Вызывается из потока, выполняющего поиск, поэтому должен быть потокобезопасным
+	// относительно того потока, который отменяет поиск (например, читать std::atomic_bool)
+	virtual bool IsCancelled() const = 0;
+};
+
+/**
+ * Контекст поиска: токен отмены, крайний срок и ограничение количества результатов
+ *
+ * Устанавливается в словарь через CSldDictionary::SetSearchContext() и действует на все
+ * последующие поиски. Поисковые циклы проверяют контекст каждые SLD_SEARCH_CALLBACK_INTERLEAVE
+ * слов вместе с вызовом ISldLayerAccess::WordFound(eWordFoundCallbackInterleave). Прерванный поиск
+ * завершается успешно и оставляет найденные к этому моменту результаты, причину остановки
+ * возвращает GetStatus().
+ *
+ * Статус "липкий": после отмены или истечения крайнего срока все последующие поиски с этим
+ * контекстом сразу завершаются без результатов, пока не будет вызван Reset(). Так один контекст
+ * может ограничивать весь запрос, состоящий из нескольких поисков. Достижение ограничения
+ * количества результатов относится к одному поиску и последующие поиски не останавливает.
+ */
+class CSldSearchContext
+{
+public:
+	CSldSearchContext() :
+		m_Cancellation(NULL),
+		m_Deadline(0),
+		m_ResultLimit(0),
+		m_Status(eSearchStatus_Complete)
+	{}
+
+	// Устанавливает токен отмены (NULL - без отмены)
+	void SetCancellation(const ISldSearchCancellation *aCancellation) { m_Cancellation = aCancellation; }
+
+#ifdef SLD__HAVE_SEARCH_DEADLINE
+	// Устанавливает крайний срок по часам sldMonotonicTime() в наносекундах (0 - без ограничения)
+	void SetDeadline(UInt64 aDeadline) { m_Deadline = aDeadline; }
+
+	// Устанавливает крайний срок через заданное количество наносекунд от текущего момента
+	void SetTimeout(UInt64 aTimeout) { m_Deadline = sldMonotonicTime() + aTimeout; }
+#endif
+
+	// Устанавливает максимальное количество результатов одного поиска (0 - без ограничения)
+	void SetResultLimit(UInt32 aLimit) { m_ResultLimit = aLimit; }
+
+	// Возвращает причину остановки поиска
+	ESldSearchStatus GetStatus() const { return m_Status; }
+
+	// Возвращает true, если поиск был прерван (отменен или истек крайний срок)
+	bool IsStopped() const { return m_Status == eSearchStatus_Cancelled || m_Status == eSearchStatus_DeadlineExceeded; }
+
+	// Сбрасывает статус перед новым запросом
+	void Reset() { m_Status = eSearchStatus_Complete; }
+
+	// Возвращает максимальное количество результатов с учетом ограничения контекста
+	Int32 LimitResults(Int32 aMaximumWords) const
+	{
+		return m_ResultLimit && (aMaximumWords < 0 || UInt32(aMaximumWords) > m_ResultLimit) ? Int32(m_ResultLimit) : aMaximumWords;
+	}
+
+	// Отмечает прерывание поиска оболочкой
+	void SetCancelled()
+	{
+		if (!IsStopped())
+			m_Status = eSearchStatus_Cancelled;
+	}
+
+	// Отмечает количество найденных слов по окончании поиска
+	void SetResultCount(UInt32 aResultCount)
+	{
+		if (!IsStopped())
+			m_Status = m_ResultLimit && aResultCount >= m_ResultLimit ? eSearchStatus_ResultLimitReached : eSearchStatus_Complete;
+	}
+
+	/**
+	 * Проверяет, нужно ли прервать поиск
+	 *
+	 * Ограничение количества результатов здесь не проверяется: оно применяется к размеру
+	 * поискового списка (см. LimitResults()), а поиск похожих слов продолжает просмотр,
+	 * заменяя худшие результаты лучшими
+	 *
+	 * @return true, если поиск нужно прервать
+	 */
+	bool Check()
+	{
+		if (IsStopped())
+			return true;
+
+		if (m_Cancellation && m_Cancellation->IsCancelled())
+			m_Status = eSearchStatus_Cancelled;
+#ifdef SLD__HAVE_SEARCH_DEADLINE
+		else if (m_Deadline && sldMonotonicTime() >= m_Deadline)
+			m_Status = eSearchStatus_DeadlineExceeded;
+#endif
+		return IsStopped();
+	}
+
+private:
+	// Токен отмены
+	const ISldSearchCancellation	*m_Cancellation;
+	// Крайний срок в наносекундах (0 - без ограничения)
+	UInt64							m_Deadline;
+	// Максимальное количество результатов (0 - без ограничения)
+	UInt32							m_ResultLimit;
+	// Причина остановки поиска
+	ESldSearchStatus				m_Status;
+};
+
+#endif // _SLD_SEARCH_CONTEXT_H_
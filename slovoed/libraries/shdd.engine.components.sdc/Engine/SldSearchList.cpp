@@ -1,5 +1,6 @@
 ﻿#include "SldSearchList.h"
 
+#include "SldArena.h"
 #include "SldLogicalExpression.h"
 #include "SldLogicalExpressionImplementation.h"
 
@@ -1157,6 +1158,10 @@ ESldError CSldSearchList::DoWordWildCardSearch(const UInt16* aText, ISldList* aL
 {
 	if (!aText || !aList || !aResultData)
 		return eMemoryNullPointer;
+
+	// Поиск уже прерван - оставшиеся операнды не вычисляем
+	if (IsSearchStopped())
+		return eOK;
 	
 	ESldError error;
 	
@@ -1198,40 +1203,61 @@ ESldError CSldSearchList::DoWordWildCardSearch(const UInt16* aText, ISldList* aL
 	if (error != eOK)
 		return error;
 
+	CSldWildCardPattern Pattern;
+	Pattern.Compile(*pList->GetCMP(), TemplateWord.c_str());
+
+	// Слова, сигнатуры которых не содержат сигнатуру шаблона, заведомо под него не подходят
+	const TSldWildCardSignature TemplateSignature = CSldCompare::GetWildCardPatternSignature(TemplateWord.c_str());
+	const TSldWildCardSignature* WordSignature = NULL;
+
 		// Результат сравнения двух строк по шаблону
 	UInt32 res = 0;
 
 	for (Int32 i=LowIndex;i<HighIndex;i++)
 	{
-		error = pList->GetWordByGlobalIndex(i);
-		if (error != eOK)
-			return error;
-
-		for (UInt32 v=0;v<NumberOfVariants;v++)
+		WordSignature = pList->GetWildCardSignature(i);
+		if (!WordSignature || TemplateSignature.MayMatch(*WordSignature))
 		{
-			// Вспомогательные варианты написания не учитываем
-			if (pListInfo->GetVariantType(v) != eVariantShow)
-				continue;
-			
-			error = pList->GetCMP()->GetStrOfMassWithDelimiters(pList->GetWord(v), EncodedWord, 0, 1);
+			error = pList->GetWordByGlobalIndex(i);
 			if (error != eOK)
 				return error;
 
-			res = pList->GetCMP()->WildCompare(TemplateWord.c_str(), EncodedWord.c_str());
-			if (res)
+			// Еще не построенная сигнатура слова строится по тем же строкам масс, что сравниваются с шаблоном
+			TSldWildCardSignature NewSignature = { 0, 0 };
+			UInt32 v = 0;
+			for (;v<NumberOfVariants;v++)
 			{
-				error = aResultData->AddWord(i);
+				// Вспомогательные варианты написания не учитываем
+				if (pListInfo->GetVariantType(v) != eVariantShow)
+					continue;
+			
+				error = pList->GetCMP()->GetStrOfMassWithDelimiters(pList->GetWord(v), EncodedWord, 0, 1);
 				if (error != eOK)
 					return error;
+
+				if (!WordSignature)
+					CSldCompare::AddWildCardSignature(EncodedWord.c_str(), NewSignature);
+
+				res = Pattern.Match(EncodedWord.c_str());
+				if (res)
+				{
+					error = aResultData->AddWord(i);
+					if (error != eOK)
+						return error;
 				
-				// Один из вариантов написания слова подходит - другие проверять не будем
-				break;
+					// Один из вариантов написания слова подходит - другие проверять не будем
+					break;
+				}
 			}
+
+			// Сигнатура сохраняется, только если в ней учтены все варианты написания
+			if (!WordSignature && v == NumberOfVariants)
+				pList->SetWildCardSignature(i, NewSignature);
 		}
 		
 		if ((i%SLD_SEARCH_CALLBACK_INTERLEAVE) == 0)
 		{
-			error = m_LayerAccess->WordFound(eWordFoundCallbackInterleave, i);
+			error = SearchCallback(eWordFoundCallbackInterleave, i);
 			if (error == eExceptionSearchStop)
 				return eOK;
 		}
@@ -1349,27 +1375,54 @@ ESldError CSldSearchList::DoExpressionWildCardSearch(TExpressionBox* aExpression
 		return eOK;
 	}
 
+	// Если в выражении нет операций OR и NOT, то слово подходит под него, только если подходит
+	// под все операнды с операцией AND и под последний операнд. Слова, сигнатуры которых
+	// не содержат сигнатуры этих операндов, можно не проверять
+	bool canFilter = true;
+	TSldWildCardSignature ExpressionSignature = { 0, 0 };
+	for (UInt32 currentTemplateIndex = 0; currentTemplateIndex < aExpressionBox->Count; currentTemplateIndex++)
+	{
+		const UInt8 operation = aExpressionBox->Operators[currentTemplateIndex];
+		if (operation != eTokenType_Operand && operation != eTokenType_Operation_AND)
+		{
+			canFilter = false;
+			break;
+		}
+
+		if (operation == eTokenType_Operation_AND || currentTemplateIndex + 1 == aExpressionBox->Count)
+		{
+			const TSldWildCardSignature signature = CSldCompare::GetWildCardPatternSignature(aExpressionBox->Operands[currentTemplateIndex]);
+			ExpressionSignature.Grams |= signature.Grams;
+			ExpressionSignature.Heads |= signature.Heads;
+		}
+	}
+
+	// Шаблоны операндов компилируются один раз на весь поиск
+	sld2::DynArray<CSldWildCardPattern> Patterns(aExpressionBox->Count);
+	if (Patterns.size() != aExpressionBox->Count)
+	{
+		// Восстановление исходного состояния списка после поиска
+		pList->RestoreState();
+		return eMemoryNotEnoughMemory;
+	}
+
+	for (UInt32 currentTemplateIndex = 0; currentTemplateIndex < aExpressionBox->Count; currentTemplateIndex++)
+		Patterns[currentTemplateIndex].Compile(*pList->GetCMP(), aExpressionBox->Operands[currentTemplateIndex]);
+
+	const TSldWildCardSignature* WordSignature = NULL;
+
 	SldU16String EncodedWord;
 	// Результат сравнения двух строк по шаблону
 	UInt32 result = 0;
 	UInt32 resultIndex = SLD_DEFAULT_WORD_INDEX;
 	for (Int32 i = LowIndex; i < HighIndex; i++)
 	{
-		error = pList->GetWordByGlobalIndex(i);
-		if (error != eOK)
-		{
-			// Восстановление исходного состояния списка после поиска
-			pList->RestoreState();
-			return error;
-		}
+		if (canFilter)
+			WordSignature = pList->GetWildCardSignature(i);
 
-		for (UInt32 v=0;v<NumberOfVariants;v++)
+		if (!WordSignature || ExpressionSignature.MayMatch(*WordSignature))
 		{
-			// Вспомогательные варианты написания не учитываем
-			if (pListInfo->GetVariantType(v) != eVariantShow)
-				continue;
-
-			error = pList->GetCMP()->GetStrOfMassWithDelimiters(pList->GetWord(v), EncodedWord, 0, 1);
+			error = pList->GetWordByGlobalIndex(i);
 			if (error != eOK)
 			{
 				// Восстановление исходного состояния списка после поиска
@@ -1377,85 +1430,111 @@ ESldError CSldSearchList::DoExpressionWildCardSearch(TExpressionBox* aExpression
 				return error;
 			}
 
-			for(UInt32 currentTemplateIndex = 0; currentTemplateIndex < aExpressionBox->Count; currentTemplateIndex++)
+			// Еще не построенная сигнатура слова строится по тем же строкам масс, что сравниваются с шаблонами
+			const bool BuildSignature = canFilter && !WordSignature;
+			TSldWildCardSignature NewSignature = { 0, 0 };
+			UInt32 v = 0;
+			for (;v<NumberOfVariants;v++)
 			{
-				if(result && aExpressionBox->Operators[currentTemplateIndex] == eTokenType_Operation_OR)
-				{
+				// Вспомогательные варианты написания не учитываем
+				if (pListInfo->GetVariantType(v) != eVariantShow)
 					continue;
+
+				error = pList->GetCMP()->GetStrOfMassWithDelimiters(pList->GetWord(v), EncodedWord, 0, 1);
+				if (error != eOK)
+				{
+					// Восстановление исходного состояния списка после поиска
+					pList->RestoreState();
+					return error;
 				}
 
-				result = pList->GetCMP()->WildCompare(aExpressionBox->Operands[currentTemplateIndex], EncodedWord.c_str());
+				if (BuildSignature)
+					CSldCompare::AddWildCardSignature(EncodedWord.c_str(), NewSignature);
 
-				if(aExpressionBox->Operators[currentTemplateIndex] == eTokenType_Operation_AND)
+				for(UInt32 currentTemplateIndex = 0; currentTemplateIndex < aExpressionBox->Count; currentTemplateIndex++)
 				{
-					if(result == 0 && currentTemplateIndex < aExpressionBox->Count && aExpressionBox->Operators[currentTemplateIndex + 1] != eTokenType_Operation_OR)
+					if(result && aExpressionBox->Operators[currentTemplateIndex] == eTokenType_Operation_OR)
 					{
-						break;
+						continue;
 					}
-				}
-				else if(aExpressionBox->Operators[currentTemplateIndex] == eTokenType_Operation_OR)
-				{
-					if(result == 0 && currentTemplateIndex < aExpressionBox->Count && aExpressionBox->Operators[currentTemplateIndex + 1] != eTokenType_Operation_OR)
+
+					result = Patterns[currentTemplateIndex].Match(EncodedWord.c_str());
+
+					if(aExpressionBox->Operators[currentTemplateIndex] == eTokenType_Operation_AND)
 					{
-						break;
+						if(result == 0 && currentTemplateIndex < aExpressionBox->Count && aExpressionBox->Operators[currentTemplateIndex + 1] != eTokenType_Operation_OR)
+						{
+							break;
+						}
 					}
-				}
-				else if(aExpressionBox->Operators[currentTemplateIndex] == eTokenType_Operation_NOT)
-				{
-					if(result)
+					else if(aExpressionBox->Operators[currentTemplateIndex] == eTokenType_Operation_OR)
 					{
-						result = 0;
+						if(result == 0 && currentTemplateIndex < aExpressionBox->Count && aExpressionBox->Operators[currentTemplateIndex + 1] != eTokenType_Operation_OR)
+						{
+							break;
+						}
 					}
-					else
+					else if(aExpressionBox->Operators[currentTemplateIndex] == eTokenType_Operation_NOT)
 					{
-						result = 1;
+						if(result)
+						{
+							result = 0;
+						}
+						else
+						{
+							result = 1;
+						}
 					}
 				}
-			}
 
-			if (result)
-			{
-				if (listUsage == eWordListType_SimpleSearch)
+				if (result)
 				{
-					Int8 realWordFlag = 0;
-					Int8* ptr = (Int8*)(pList->GetWord(1));
-					sldMemMove(&realWordFlag, ptr, sizeof(Int8));
+					if (listUsage == eWordListType_SimpleSearch)
+					{
+						Int8 realWordFlag = 0;
+						Int8* ptr = (Int8*)(pList->GetWord(1));
+						sldMemMove(&realWordFlag, ptr, sizeof(Int8));
 
-					if (realWordFlag == SLD_SIMPLE_SORTED_VIRTUAL_WORD)
-						break;
+						if (realWordFlag == SLD_SIMPLE_SORTED_VIRTUAL_WORD)
+							break;
 
-					ptr++;
-					sldMemMove(&resultIndex, ptr, sizeof(Int32));
-				}
-				else
-				{
-					resultIndex = i;
-				}
+						ptr++;
+						sldMemMove(&resultIndex, ptr, sizeof(Int32));
+					}
+					else
+					{
+						resultIndex = i;
+					}
 
-				error = aResultData->AddWord(resultIndex);
-				if (error != eOK)
-				{
-					// Восстановление исходного состояния списка после поиска
-					pList->RestoreState();
-					return error;
-				}
+					error = aResultData->AddWord(resultIndex);
+					if (error != eOK)
+					{
+						// Восстановление исходного состояния списка после поиска
+						pList->RestoreState();
+						return error;
+					}
 
-				error = m_LayerAccess->WordFound(eWordFoundCallbackFound, resultIndex);
-				if (error == eExceptionSearchStop)
-				{
-					// Восстановление исходного состояния списка после поиска
-					pList->RestoreState();
-					return error;
-				}
+					error = SearchCallback(eWordFoundCallbackFound, resultIndex);
+					if (error == eExceptionSearchStop)
+					{
+						// Восстановление исходного состояния списка после поиска
+						pList->RestoreState();
+						return error;
+					}
 
-				// Один из вариантов написания слова подходит - другие проверять не будем
-				break;
+					// Один из вариантов написания слова подходит - другие проверять не будем
+					break;
+				}
 			}
+
+			// Сигнатура сохраняется, только если в ней учтены все варианты написания
+			if (BuildSignature && v == NumberOfVariants)
+				pList->SetWildCardSignature(i, NewSignature);
 		}
 
 		if ((i%SLD_SEARCH_CALLBACK_INTERLEAVE) == 0)
 		{
-			error = m_LayerAccess->WordFound(eWordFoundCallbackInterleave, i);
+			error = SearchCallback(eWordFoundCallbackInterleave, i);
 			if (error == eExceptionSearchStop)
 			{
 				// Восстановление исходного состояния списка после поиска
@@ -1498,6 +1577,9 @@ ESldError CSldSearchList::DoWildCardSearch(TExpressionBox* aExpressionBox, Int32
 
 	//SldU16String str = aExpressionBox->Operands[0];
 
+	if (m_SearchContext)
+		aMaximumWords = m_SearchContext->LimitResults(aMaximumWords);
+
 	// Ничего искать не нужно
 	if (!aMaximumWords)
 		return eOK;
@@ -1515,7 +1597,7 @@ ESldError CSldSearchList::DoWildCardSearch(TExpressionBox* aExpressionBox, Int32
 	const UInt32 MaximumNumberOfWordsInList = pListInfo->GetNumberOfGlobalWords();
 
 	// Начало поиска
-	error = m_LayerAccess->WordFound(eWordFoundCallbackStartSearch);
+	error = SearchCallback(eWordFoundCallbackStartSearch);
 	if (error == eExceptionSearchStop)
 		return eOK;
 
@@ -1526,7 +1608,10 @@ ESldError CSldSearchList::DoWildCardSearch(TExpressionBox* aExpressionBox, Int32
 		return error;
 
 	error = DoExpressionWildCardSearch(aExpressionBox, aList, aMaximumWords, &resultData);
-	if(error != eOK)
+	// Прерванный поиск (оболочкой или контекстом поиска) не теряет уже найденные слова,
+	// причина остановки остается в контексте поиска
+	const bool searchStopped = error == eExceptionSearchStop;
+	if (error != eOK && !searchStopped)
 		return error;
 
 	if (aRealList)
@@ -1538,8 +1623,11 @@ ESldError CSldSearchList::DoWildCardSearch(TExpressionBox* aExpressionBox, Int32
 	if (error != eOK)
 		return error;
 
+	if (searchStopped)
+		return eOK;
+
 	// Конец поиска
-	error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+	error = SearchCallback(eWordFoundCallbackStopSearch);
 	if (error == eExceptionSearchStop)
 		return eOK;
 
@@ -1579,6 +1667,9 @@ ESldError CSldSearchList::DoFuzzySearch(const UInt16* aText, Int32 aMaximumWords
 	if (error != eOK)
 		return error;
 
+	if (m_SearchContext)
+		aMaximumWords = m_SearchContext->LimitResults(aMaximumWords);
+
 	// Ничего искать не нужно
 	if (!aMaximumWords)
 		return eOK;
@@ -1628,14 +1719,14 @@ ESldError CSldSearchList::DoFuzzySearch(const UInt16* aText, Int32 aMaximumWords
 	}
 
 	// Начало поиска
-	error = m_LayerAccess->WordFound(eWordFoundCallbackStartSearch);
+	error = SearchCallback(eWordFoundCallbackStartSearch);
 	if (error == eExceptionSearchStop)
 		return eOK;
 	else if (error != eOK)
 		return error;
 	
 	// Битовый массив флагов наличия символов в слове
-	sld2::DynArray<UInt32> SymbolsCheckTable;
+	sld2::ScratchArray<UInt32> SymbolsCheckTable;
 	SldU16String PatternOfMass;
 	// Указатель на шаблон, который будем искать
 	const UInt16* SearchPattern = NULL;
@@ -1765,14 +1856,14 @@ ESldError CSldSearchList::DoFuzzySearch(const UInt16* aText, Int32 aMaximumWords
 
 		if ((i%SLD_SEARCH_CALLBACK_INTERLEAVE) == 0)
 		{
-			error = m_LayerAccess->WordFound(eWordFoundCallbackInterleave, i);
+			error = SearchCallback(eWordFoundCallbackInterleave, i);
 			if (error == eExceptionSearchStop)
 				return eOK;
 		}
 	}
 
 	// Конец поиска
-	error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+	error = SearchCallback(eWordFoundCallbackStopSearch);
 	if (error == eExceptionSearchStop)
 		return eOK;
 	
@@ -1892,7 +1983,7 @@ ESldError CSldSearchList::FuzzyCompareSortTable(CSldList* aList, const UInt16* a
 	UInt16 Mass = 0;
 	Int32 diff_count = 0;
 	const UInt16* src = NULL;
-	SldU16String PatternOfMass;
+	SldU16String &PatternOfMass = m_MassBuffer;
 	
 	*aFlag = 0;
 	sldMemZero(aSymbolsCheckTable.data(), aSymbolsCheckTable.size() * sizeof(aSymbolsCheckTable[0]));
@@ -1986,15 +2077,15 @@ ESldError CSldSearchList::DoAnagramSearch(const UInt16* aText, Int32 aTextLen, I
 		MaximumWordSize = aTextLen;
 
 	// Массив флагов для каждого символа в слове, здесь сохраняются флаги, что символ с определенным индексом уже учтен при сравнении
-	sld2::DynArray<UInt8> flag(sld2::default_init, MaximumWordSize);
+	sld2::ScratchArray<UInt8> flag(sld2::default_init, MaximumWordSize);
 	if (MaximumWordSize > 0 && flag.empty())
 		return eMemoryNotEnoughMemory;
 
-	sld2::DynArray<UInt16> PreparedText(aTextLen + 1);
+	sld2::ScratchArray<UInt16> PreparedText(aTextLen + 1);
 	if (PreparedText.empty())
 		return eMemoryNotEnoughMemory;
 
-	sld2::DynArray<UInt16> PreparedWord(MaximumWordSize + 1);
+	sld2::ScratchArray<UInt16> PreparedWord(MaximumWordSize + 1);
 	if (PreparedWord.empty())
 		return eMemoryNotEnoughMemory;
 
@@ -2020,7 +2111,7 @@ ESldError CSldSearchList::DoAnagramSearch(const UInt16* aText, Int32 aTextLen, I
 		return error;
 
 	// Начало поиска
-	error = m_LayerAccess->WordFound(eWordFoundCallbackStartSearch);
+	error = SearchCallback(eWordFoundCallbackStartSearch);
 	if (error == eExceptionSearchStop)
 		return eOK;
 
@@ -2059,7 +2150,7 @@ ESldError CSldSearchList::DoAnagramSearch(const UInt16* aText, Int32 aTextLen, I
 				if (error != eOK)
 					return error;
 
-				error = m_LayerAccess->WordFound(eWordFoundCallbackFound, i);
+				error = SearchCallback(eWordFoundCallbackFound, i);
 				if (error != eOK)
 				{
 					if (error == eExceptionSearchStop)
@@ -2075,7 +2166,7 @@ ESldError CSldSearchList::DoAnagramSearch(const UInt16* aText, Int32 aTextLen, I
 
 		if ((i%SLD_SEARCH_CALLBACK_INTERLEAVE) == 0)
 		{
-			error = m_LayerAccess->WordFound(eWordFoundCallbackInterleave, i);
+			error = SearchCallback(eWordFoundCallbackInterleave, i);
 			if (error == eExceptionSearchStop)
 				return eOK;
 		}
@@ -2086,7 +2177,7 @@ ESldError CSldSearchList::DoAnagramSearch(const UInt16* aText, Int32 aTextLen, I
 	}
 
 	// Конец поиска
-	error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+	error = SearchCallback(eWordFoundCallbackStopSearch);
 	if (error == eExceptionSearchStop)
 		return eOK;
 		
@@ -2153,7 +2244,7 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 	const UInt32 NumberOfVariants = pListInfo->GetNumberOfVariants();
 
 	// Начало поиска
-	error = m_LayerAccess->WordFound(eWordFoundCallbackStartSearch);
+	error = SearchCallback(eWordFoundCallbackStartSearch);
 	if (error == eExceptionSearchStop)
 		return eOK;
 
@@ -2162,7 +2253,7 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 	// Нечего искать
 	if (!TextLen)
 	{
-		error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+		error = SearchCallback(eWordFoundCallbackStopSearch);
 		if (error == eExceptionSearchStop)
 			return eOK;
 		return error;
@@ -2193,7 +2284,7 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 		return error;
 
 	// Битовый массив флагов наличия символов (по весам символов) в слове
-	sld2::DynArray<UInt32> SymbolsCheckTable(sld2::default_init, sld2::bitset::size(0x8000));
+	sld2::ScratchArray<UInt32> SymbolsCheckTable(sld2::default_init, sld2::bitset::size(0x8000));
 	if (SymbolsCheckTable.empty())
 		return eMemoryNotEnoughMemory;
 
@@ -2230,7 +2321,7 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 	// Нечего искать
 	if (symbolIndex == TextLen)
 	{
-		error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+		error = SearchCallback(eWordFoundCallbackStopSearch);
 		if (error == eExceptionSearchStop)
 			return eOK;
 		return error;
@@ -2331,7 +2422,7 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 				if (error != eOK)
 					return error;
 
-				error = m_LayerAccess->WordFound(eWordFoundCallbackFound, currentGlobalIndex);
+				error = SearchCallback(eWordFoundCallbackFound, currentGlobalIndex);
 				if (error == eExceptionSearchStop)
 					return eOK;
 
@@ -2342,14 +2433,14 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 
 		if ((NumberOfCheckedWords%SLD_SEARCH_CALLBACK_INTERLEAVE) == 0)
 		{
-			error = m_LayerAccess->WordFound(eWordFoundCallbackInterleave, NumberOfCheckedWords);
+			error = SearchCallback(eWordFoundCallbackInterleave, NumberOfCheckedWords);
 			if (error == eExceptionSearchStop)
 				return eOK;
 		}
 		// если уже найдено необходимое количество слов, то завершаем поиск
 		if (m_WordCount >= m_WordVector.size())
 		{
-			error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+			error = SearchCallback(eWordFoundCallbackStopSearch);
 			if (error == eExceptionSearchStop)
 				return eOK;
 			return error;
@@ -2445,7 +2536,7 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 
 						if (isDouble == 0)
 						{
-							error = m_LayerAccess->WordFound(eWordFoundCallbackFound, currentGlobalIndex);
+							error = SearchCallback(eWordFoundCallbackFound, currentGlobalIndex);
 							if (error == eExceptionSearchStop)
 								return eOK;
 						}
@@ -2459,14 +2550,14 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 			}
 			if ((NumberOfCheckedWords%SLD_SEARCH_CALLBACK_INTERLEAVE) == 0)
 			{
-				error = m_LayerAccess->WordFound(eWordFoundCallbackInterleave, NumberOfCheckedWords);
+				error = SearchCallback(eWordFoundCallbackInterleave, NumberOfCheckedWords);
 				if (error == eExceptionSearchStop)
 					return eOK;
 			}
 			// если уже найдено необходимое количество слов, то завершаем поиск
 			if (m_WordCount >= m_WordVector.size())
 			{
-				error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+				error = SearchCallback(eWordFoundCallbackStopSearch);
 				if (error == eExceptionSearchStop)
 					return eOK;
 				return error;
@@ -2556,7 +2647,7 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 
 						if (isDouble == 0)
 						{
-							error = m_LayerAccess->WordFound(eWordFoundCallbackFound, j);
+							error = SearchCallback(eWordFoundCallbackFound, j);
 							if (error == eExceptionSearchStop)
 								return eOK;
 						}
@@ -2571,14 +2662,14 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 			}
 			if ((NumberOfCheckedWords%SLD_SEARCH_CALLBACK_INTERLEAVE) == 0)
 			{
-				error = m_LayerAccess->WordFound(eWordFoundCallbackInterleave, NumberOfCheckedWords);
+				error = SearchCallback(eWordFoundCallbackInterleave, NumberOfCheckedWords);
 				if (error == eExceptionSearchStop)
 					return eOK;
 			}
 			// если уже найдено необходимое количество слов, то завершаем поиск
 			if (m_WordCount >= m_WordVector.size())
 			{
-				error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+				error = SearchCallback(eWordFoundCallbackStopSearch);
 				if (error == eExceptionSearchStop)
 					return eOK;
 				return error;
@@ -2643,7 +2734,7 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 
 						if (isDouble == 0)
 						{
-							error = m_LayerAccess->WordFound(eWordFoundCallbackFound, j);
+							error = SearchCallback(eWordFoundCallbackFound, j);
 							if (error == eExceptionSearchStop)
 								return eOK;
 						}
@@ -2658,14 +2749,14 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 			}
 			if ((NumberOfCheckedWords%SLD_SEARCH_CALLBACK_INTERLEAVE) == 0)
 			{
-				error = m_LayerAccess->WordFound(eWordFoundCallbackInterleave, NumberOfCheckedWords);
+				error = SearchCallback(eWordFoundCallbackInterleave, NumberOfCheckedWords);
 				if (error == eExceptionSearchStop)
 					return eOK;
 			}
 			// если уже найдено необходимое количество слов, то завершаем поиск
 			if (m_WordCount >= m_WordVector.size())
 			{
-				error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+				error = SearchCallback(eWordFoundCallbackStopSearch);
 				if (error == eExceptionSearchStop)
 					return eOK;
 				return error;
@@ -2674,7 +2765,7 @@ ESldError CSldSearchList::DoSpellingSearch(const UInt16* aText, ISldList* aList,
 	}
 
 	// Конец поиска
-	error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+	error = SearchCallback(eWordFoundCallbackStopSearch);
 	if (error == eExceptionSearchStop)
 		return eOK;
 
@@ -2698,11 +2789,14 @@ ESldError CSldSearchList::DoFullTextSearch(const UInt16* aText, Int32 aMaximumWo
 		return eMemoryNullPointer;
 	if (!isInit())
 		return eCommonListNotInitialized;
+
+	if (m_SearchContext)
+		aMaximumWords = m_SearchContext->LimitResults(aMaximumWords);
 		
 	ESldError error;
 	
 	// Начало поиска
-	error = m_LayerAccess->WordFound(eWordFoundCallbackStartSearch);
+	error = SearchCallback(eWordFoundCallbackStartSearch);
 	if (error == eExceptionSearchStop)
 		return eOK;
 	
@@ -2764,7 +2858,7 @@ ESldError CSldSearchList::DoFullTextSearch(const UInt16* aText, Int32 aMaximumWo
 		return error;
 	
 	// Конец поиска
-	error = m_LayerAccess->WordFound(eWordFoundCallbackStopSearch);
+	error = SearchCallback(eWordFoundCallbackStopSearch);
 	if (error == eExceptionSearchStop)
 		return eOK;
 		
@@ -3133,7 +3227,9 @@ private:
 
 namespace impl {
 
-void doQuickSort(TSldSearchWordStruct *aWords, Int32 aFirstIndex, Int32 aLastIndex)
+// Быстрая сортировка слов по дистанции между ними, которая доводит до конца только те части, которые пересекаются с первыми aLimit словами;
+// остальные части откладываются в aPending, их последующая досортировка дает тот же порядок, что и полная сортировка
+void doPartialQuickSort(TSldSearchWordStruct *aWords, Int32 aFirstIndex, Int32 aLastIndex, Int32 aLimit, CSldVector<TSldSearchWordRange> &aPending)
 {
 	Int32 i = aFirstIndex;
 	Int32 j = aLastIndex;
@@ -3158,11 +3254,15 @@ void doQuickSort(TSldSearchWordStruct *aWords, Int32 aFirstIndex, Int32 aLastInd
 	} while (i <= j);
 
 	if (i < aLastIndex)
-		doQuickSort(aWords, i, aLastIndex);
+	{
+		if (i < aLimit)
+			doPartialQuickSort(aWords, i, aLastIndex, aLimit, aPending);
+		else
+			aPending.push_back(TSldSearchWordRange{ i, aLastIndex });
+	}
 
 	if (aFirstIndex < j)
-		doQuickSort(aWords, aFirstIndex, j);
-
+		doPartialQuickSort(aWords, aFirstIndex, j, aLimit, aPending);
 }
 
 template <typename Compare>
@@ -3200,12 +3300,11 @@ void doStableQuickSort(TSldSearchWordStruct *aWords, Int32 aFirstIndex, Int32 aL
 
 } // namespace impl
 
-// Производит сортировку вектора слов по дистанции между ними
-void doQuickSort(sld2::Span<TSldSearchWordStruct> aWords)
+// Производит сортировку вектора слов по дистанции между ними, упорядочивая окончательно только первую страницу слов
+void doPartialQuickSort(sld2::Span<TSldSearchWordStruct> aWords, CSldVector<TSldSearchWordRange> &aPending)
 {
-	// XXX: We could write a generic quick_sort algo for this...
 	if (aWords.size() > 1)
-		impl::doQuickSort(aWords.data(), 0, aWords.size() - 1);
+		impl::doPartialQuickSort(aWords.data(), 0, aWords.size() - 1, SLD_FTS_RELEVANT_SORT_PAGE_SIZE, aPending);
 }
 
 // Производит устойчивую сортировку вектора слов используя компаратор
@@ -3479,12 +3578,14 @@ Int32 findMatch(UInt32 count, Compare&& compare, ESldError *error)
  * @param[in]     aLists           - массив листов
  * @param[in]     aText            - шаблон текста, по которому производился поиск
  * @param[in]     aMorphologyForms - массив словоформ
+ * @param[out]    aPending         - диапазоны слов, сортировка которых отложена
  *
  * @return error code
  */
 ESldError doSimpleRelevantSort(sld2::Span<TSldSearchWordStruct> aWords,
 							   sld2::Span<const TSldSearchListStruct> aLists,
-							   SldU16StringRef aText, MorphoFormsArray aMorphologyForms)
+							   SldU16StringRef aText, MorphoFormsArray aMorphologyForms,
+							   CSldVector<TSldSearchWordRange> &aPending)
 {
 	if (aWords.size() < 2 || aText.empty())
 		return eOK;
@@ -3603,7 +3704,7 @@ ESldError doSimpleRelevantSort(sld2::Span<TSldSearchWordStruct> aWords,
 			aWords[i].WordDistance = currentWeight++;
 	}
 
-	doQuickSort(aWords);
+	doPartialQuickSort(aWords, aPending);
 
 	return eOK;
 }
@@ -3616,12 +3717,14 @@ ESldError doSimpleRelevantSort(sld2::Span<TSldSearchWordStruct> aWords,
  * @param[in]     aLists           - массив листов
  * @param[in]     aText            - шаблон текста, по которому производился поиск
  * @param[in]     aMorphologyForms - массив словоформ
+ * @param[out]    aPending         - диапазоны слов, сортировка которых отложена
  *
  * @return error code
  */
 ESldError doFullRelevantSort(sld2::Span<TSldSearchWordStruct> aWords,
 							 sld2::Span<const TSldSearchListStruct> aLists,
-							 SldU16StringRef aText, MorphoFormsArray aMorphologyForms)
+							 SldU16StringRef aText, MorphoFormsArray aMorphologyForms,
+							 CSldVector<TSldSearchWordRange> &aPending)
 {
 	if (aWords.size() < 2 || aText.empty())
 		return eOK;
@@ -3667,7 +3770,7 @@ ESldError doFullRelevantSort(sld2::Span<TSldSearchWordStruct> aWords,
 		}
 	}
 
-	doQuickSort(aWords);
+	doPartialQuickSort(aWords, aPending);
 
 	return eOK;
 }
@@ -3873,6 +3976,9 @@ ESldError CSldSearchList::SortListRelevant(const UInt16* aText, const CSldVector
 	if (!NumberOfWords)
 		return eOK;
 
+	// сортировка начинается с того порядка, который дала бы полная предыдущая сортировка
+	SortPendingWords(m_WordCount);
+
 	auto words = sld2::make_span(m_WordVector.data(), NumberOfWords);
 	auto lists = sld2::make_span(m_ListVector.data(), m_ListCount);
 
@@ -3880,9 +3986,9 @@ ESldError CSldSearchList::SortListRelevant(const UInt16* aText, const CSldVector
 	{
 	case eFTSSortingType_Simple:
 		if (m_EnableSimpleRelevantSort)
-			error = sort::doSimpleRelevantSort(words, lists, aText, aMorphologyForms);
+			error = sort::doSimpleRelevantSort(words, lists, aText, aMorphologyForms, m_PendingWordRanges);
 		else
-			error = sort::doFullRelevantSort(words, lists, aText, aMorphologyForms);
+			error = sort::doFullRelevantSort(words, lists, aText, aMorphologyForms, m_PendingWordRanges);
 		break;
 
 	case eFTSSortingType_AlphabeticalSortedGroups:
@@ -3890,14 +3996,14 @@ ESldError CSldSearchList::SortListRelevant(const UInt16* aText, const CSldVector
 		break;
 
 	case eFTSSortingType_Full:
-		error = sort::doFullRelevantSort(words, lists, aText, aMorphologyForms);
+		error = sort::doFullRelevantSort(words, lists, aText, aMorphologyForms, m_PendingWordRanges);
 		break;
 
 	case eFTSSortingType_Smart:
 		if (m_EnableSimpleRelevantSort && NumberOfWords > SLD_FTS_NUMBER_OF_WORDS_FOR_FULL_MODE)
-			error = sort::doSimpleRelevantSort(words, lists, aText, aMorphologyForms);
+			error = sort::doSimpleRelevantSort(words, lists, aText, aMorphologyForms, m_PendingWordRanges);
 		else
-			error = sort::doFullRelevantSort(words, lists, aText, aMorphologyForms);
+			error = sort::doFullRelevantSort(words, lists, aText, aMorphologyForms, m_PendingWordRanges);
 		break;
 
 	case eFTSSortingType_Alphabetical:
@@ -3908,6 +4014,9 @@ ESldError CSldSearchList::SortListRelevant(const UInt16* aText, const CSldVector
 		break;
 	}
 
+	if (!m_PendingWordRanges.empty())
+		m_SortedWordCount = SLD_FTS_RELEVANT_SORT_PAGE_SIZE;
+
 	return error;
 }
 
@@ -3932,6 +4041,10 @@ ESldError CSldSearchList::DoWordFullTextSearch(const UInt16* aText, Int32 aMaxim
 	if (aRealListIndex >= aListCount)
 		return eCommonWrongIndex;
 
+	// Поиск уже прерван - оставшиеся операнды не вычисляем
+	if (IsSearchStopped())
+		return eOK;
+
 	ESldError error = eOK;
 	Int32 i = 0;
 	const CSldListInfo* pListInfo = NULL;
@@ -4005,6 +4118,7 @@ ESldError CSldSearchList::DoWordFullTextSearch(const UInt16* aText, Int32 aMaxim
 	// Поиск
 	UInt8 suffix_search_mode = 0;
 	Int32 globalWordIdx = 0;
+	CSldVector<TSldIndexData> translations;
 	for (i=StartPos;i<HighIndex;i++)
 	{
 		error = pList->GetWordByGlobalIndex(i);
@@ -4067,17 +4181,17 @@ ESldError CSldSearchList::DoWordFullTextSearch(const UInt16* aText, Int32 aMaxim
 			if (error != eOK)
 				return error;
 			
-			Int32 ListIdx = 0;
-			Int32 ListEntryIdx = 0;
-			Int32 TransIdx = 0;
-			Int32 ShiftIdx = 0;
-			for (Int32 j=0;j<TranslationCount;j++)
+			translations.clear();
+			if (TranslationCount)
 			{
-				error = pList->GetFullTextTranslationData(globalWordIdx, j, &ListIdx, &ListEntryIdx, &TransIdx, &ShiftIdx);
+				error = pList->GetFullTextTranslationData(globalWordIdx, translations);
 				if (error != eOK)
 					return error;
-				
-				error = aResultData->AddWord(ListIdx, ListEntryIdx, TransIdx, ShiftIdx);
+			}
+
+			for (const TSldIndexData& translation : translations)
+			{
+				error = aResultData->AddWord(translation.ListIndex, translation.ArticleIndex, translation.TranslationIndex, translation.ShiftIndex);
 				if (error != eOK)
 					return error;
 				
@@ -4085,9 +4199,9 @@ ESldError CSldSearchList::DoWordFullTextSearch(const UInt16* aText, Int32 aMaxim
 				// Запрашиваем у оболочки, может уже нужно остановить поиск
 				if ((ResultCount%SLD_SEARCH_CALLBACK_INTERLEAVE) == 0)
 				{
-					error = m_LayerAccess->WordFound(eWordFoundCallbackInterleave, ResultCount);
+					error = SearchCallback(eWordFoundCallbackInterleave, ResultCount);
 					if (error == eExceptionSearchStop)
-						return error;
+						return eOK;
 				}
 			}
 			// Один из вариантов написания слова подходит - другие проверять не будем
@@ -4250,7 +4364,10 @@ ESldError CSldSearchList::AddWildCardSearchSearchResults(CSldSimpleSearchWordRes
 
 	// Добавляем слова тогда, когда они найдены
 	if (aResultData->GetWordCount())
+	{
+		m_PendingWordRanges.clear();
 		m_WordCount = aResultData->FillWordVector(m_WordVector, aMaximumWords, m_CurrentListIndex);
+	}
 
 	return eOK;
 }
@@ -4286,7 +4403,11 @@ ESldError CSldSearchList::SetMaximumLists(Int32 aMaxLists)
 ************************************************************************/
 ESldError CSldSearchList::SetMaximumWords(Int32 aMaxWords)
 {
+	if (m_SearchContext)
+		aMaxWords = m_SearchContext->LimitResults(aMaxWords);
+
 	m_WordCount = 0;
+	m_PendingWordRanges.clear();
 	m_CurrentWordIndex = 0;
 	m_Word = NULL;
 
@@ -4299,6 +4420,39 @@ ESldError CSldSearchList::SetMaximumWords(Int32 aMaxWords)
 	return eOK;
 }
 
+/** *********************************************************************
+* Сообщает оболочке о ходе поиска с учетом контекста поиска
+*
+* Перед началом поиска и каждые SLD_SEARCH_CALLBACK_INTERLEAVE слов проверяет контекст
+* поиска (токен отмены, крайний срок) и, если поиск нужно
+* прервать, возвращает eExceptionSearchStop, не обращаясь к оболочке.
+* Остановка поиска оболочкой запоминается в контексте как отмена
+*
+* @param[in]	aType	- тип callback-а (см. #ESldWordFoundCallbackType)
+* @param[in]	aIndex	- параметр callback-а
+*
+* @return error code (eExceptionSearchStop - поиск нужно прервать)
+************************************************************************/
+ESldError CSldSearchList::SearchCallback(ESldWordFoundCallbackType aType, UInt32 aIndex)
+{
+	if (m_SearchContext)
+	{
+		if (aType == eWordFoundCallbackStartSearch || aType == eWordFoundCallbackInterleave)
+		{
+			if (m_SearchContext->Check())
+				return eExceptionSearchStop;
+		}
+		else if (aType == eWordFoundCallbackStopSearch)
+			m_SearchContext->SetResultCount(m_WordCount);
+	}
+
+	ESldError error = m_LayerAccess->WordFound(aType, aIndex);
+	if (error == eExceptionSearchStop && m_SearchContext)
+		m_SearchContext->SetCancelled();
+
+	return error;
+}
+
 /** *********************************************************************
 * Добавляет список слов, в котором производился поиск
 *
@@ -4394,6 +4548,8 @@ ESldError CSldSearchList::AddFuzzyWord(const TSldSearchWordStruct &aWord)
 {
 	if (m_WordCount >= m_WordVector.size())
 		return eCommonWrongIndex;
+
+	SortPendingWords(m_WordCount);
 	
 	Int32 i;
 	for (i=0;i<m_WordCount;i++)
@@ -4455,10 +4611,45 @@ ESldError CSldSearchList::AddSpellingWord(const TSldSearchWordStruct &aWord, Int
 ************************************************************************/
 void CSldSearchList::RemoveLastWord(void)
 {
+	SortPendingWords(m_WordCount);
+
 	if (m_WordCount)
 		m_WordCount--;
 }
 
+/** *********************************************************************
+* Досортировывает отложенные при сортировке по релевантности диапазоны слов
+* так, чтобы порядок первых aCount слов совпадал с порядком полной сортировки.
+* Досортировка производится постранично, с запасом в #SLD_FTS_RELEVANT_SORT_PAGE_SIZE слов
+*
+* @param[in]	aCount	- количество слов в начале списка, порядок которых должен стать окончательным
+************************************************************************/
+void CSldSearchList::SortPendingWords(UInt32 aCount) const
+{
+	if (m_PendingWordRanges.empty() || aCount <= m_SortedWordCount)
+		return;
+
+	const Int32 limit = aCount + SLD_FTS_RELEVANT_SORT_PAGE_SIZE;
+
+	CSldVector<TSldSearchWordRange> ranges = sld2::move(m_PendingWordRanges);
+	m_PendingWordRanges.clear();
+
+	for (const TSldSearchWordRange &range : ranges)
+	{
+		if (range.First < limit)
+			sort::impl::doPartialQuickSort(m_WordVector.data(), range.First, range.Last, limit, m_PendingWordRanges);
+		else
+			m_PendingWordRanges.push_back(range);
+	}
+
+	m_SortedWordCount = limit;
+	for (const TSldSearchWordRange &range : m_PendingWordRanges)
+	{
+		if (static_cast<UInt32>(range.First) < m_SortedWordCount)
+			m_SortedWordCount = range.First;
+	}
+}
+
 /** *********************************************************************
 * Получает список по индексу
 *
@@ -4486,6 +4677,9 @@ TSldSearchWordStruct* CSldSearchList::GetWord(Int32 aIndex) const
 	if (aIndex >= m_WordCount)
 		return NULL;
 
+	if ((UInt32)aIndex >= m_SortedWordCount && !m_PendingWordRanges.empty())
+		SortPendingWords(aIndex + 1);
+
 	return (TSldSearchWordStruct*) &m_WordVector[aIndex];
 }
 
@@ -5155,6 +5349,8 @@ ESldError CSldSearchList::SortByVector(const CSldVector<Int32> & aWordIndexes)
 	if (aWordIndexes.size() != m_WordCount)
 		return eCommonWrongNumberOfWords;
 
+	SortPendingWords(m_WordCount);
+
 	for (UInt32 wordIndex = 0; wordIndex < m_WordCount; wordIndex++)
 	{
 		m_WordVector[wordIndex].WordIndex = aWordIndexes[wordIndex];
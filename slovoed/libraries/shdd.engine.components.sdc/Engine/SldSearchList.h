@@ -4,6 +4,7 @@
 #include "ISldList.h"
 #include "SldList.h"
 #include "SldSearchWordResult.h"
+#include "SldSearchContext.h"
 
 #define WORD_WEIGHT_IS_UNDEFINED	-2
 #define MAX_NUMBER_OF_WORDS_IS_UNDEFINED	-1
@@ -43,8 +44,10 @@ public:
 	// Стандартный конструктор
 	CSldSearchList(void) :
 		m_LayerAccess(NULL),
+		m_SearchContext(NULL),
 		m_ListCount(0),
 		m_WordCount(0),
+		m_SortedWordCount(0),
 		m_CurrentListIndex(0),
 		m_CurrentWordIndex(0),
 		m_List(NULL),
@@ -346,6 +349,10 @@ public:
 	// Устанавливает максимальное количество слов
 	ESldError SetMaximumWords(Int32 aMaxWords);
 
+	// Устанавливает контекст поиска (отмена, крайний срок, ограничение количества результатов)
+	// Должен быть установлен до SetMaximumWords()
+	void SetSearchContext(CSldSearchContext *aContext) { m_SearchContext = aContext; }
+
 	// Создает или находит уже имеющуюся внутреннюю запись о реальном списке слов
 	ESldError MakeList(CSldList* aRealList, Int32 aRealListIndex, TSldSearchListStruct** aList);
 
@@ -418,17 +425,29 @@ private:
 	
 private:
 
+	// Досортировывает отложенные диапазоны слов так, чтобы порядок первых aCount слов был окончательным
+	void SortPendingWords(UInt32 aCount) const;
+
+	// Сообщает оболочке о ходе поиска с учетом контекста поиска
+	ESldError SearchCallback(ESldWordFoundCallbackType aType, UInt32 aIndex = 0);
+
+	// Возвращает true, если поиск уже прерван через контекст поиска
+	bool IsSearchStopped() const { return m_SearchContext && m_SearchContext->IsStopped(); }
+
 	// Заголовок данного списка слов
 	sld2::UniquePtr<CSldListInfo>	m_ListInfo;
 
 	// Класс, отвечающий за общение с оболочкой
 	ISldLayerAccess*			m_LayerAccess;
 
+	// Контекст поиска (может отсутствовать)
+	CSldSearchContext*			m_SearchContext;
+
 	// Массив списков слов, на который ссылается данный поисковый список
 	sld2::DynArray<TSldSearchListStruct>	m_ListVector;
 
-	// Массив с найденными словами
-	sld2::DynArray<TSldSearchWordStruct>	m_WordVector;
+	// Массив с найденными словами (досортировывается при обращении к словам, см. SortPendingWords())
+	mutable sld2::DynArray<TSldSearchWordStruct>	m_WordVector;
 
 	// Количество списков
 	UInt32						m_ListCount;
@@ -436,12 +455,21 @@ private:
 	// Количество слов
 	UInt32						m_WordCount;
 
+	// Диапазоны слов, сортировка которых по релевантности отложена до обращения к ним
+	mutable CSldVector<TSldSearchWordRange>	m_PendingWordRanges;
+
+	// Количество слов в начале списка, порядок которых окончательный (имеет смысл, если есть отложенные диапазоны)
+	mutable UInt32				m_SortedWordCount;
+
 	// Индекс текущего списка
 	Int32						m_CurrentListIndex;
 
 	// Индекс текущего слова
 	Int32						m_CurrentWordIndex;
 
+	// Строка масс проверяемого слова, переиспользуется между вызовами FuzzyCompareSortTable()
+	SldU16String				m_MassBuffer;
+
 	// Текущий список
 	TSldSearchListStruct*		m_List;
 
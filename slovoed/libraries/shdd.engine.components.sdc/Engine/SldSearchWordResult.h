@@ -22,6 +22,16 @@ struct TSldSearchWordStruct
 	{}
 };
 
+// Диапазон найденных слов [First, Last], порядок которых еще не окончательный
+struct TSldSearchWordRange
+{
+	// Индекс первого слова диапазона
+	Int32 First;
+
+	// Индекс последнего слова диапазона
+	Int32 Last;
+};
+
 // Класс, который содержит результаты поиска одного слова при полнотекстовом поиске
 class CSldSearchWordResult
 {
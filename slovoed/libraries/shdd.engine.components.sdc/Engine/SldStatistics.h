@@ -0,0 +1,83 @@
+﻿#ifndef _SLD_STATISTICS_H_
+#define _SLD_STATISTICS_H_
+
+#include "SldPlatform.h"
+
+// Операции словаря, для которых учитывается количество вызовов и время выполнения
+enum ESldStatisticsOperation
+{
+	eStatisticsOperation_Open = 0,
+	eStatisticsOperation_GetWordByIndex,
+	eStatisticsOperation_GetWordByText,
+	eStatisticsOperation_Translate,
+	eStatisticsOperation_WildCardSearch,
+	eStatisticsOperation_FuzzySearch,
+	eStatisticsOperation_AnagramSearch,
+	eStatisticsOperation_SpellingSearch,
+	eStatisticsOperation_FullTextSearch,
+	eStatisticsOperation_SortSearchListRelevant,
+
+	// Количество операций
+	eStatisticsOperation_Count
+};
+
+/**
+ * Счетчики производительности ядра
+ *
+ * Счетчики собираются только если ядро собрано с SLD__HAVE_STATISTICS (см. SldPlatform.h)
+ * и относятся к операциям словаря (#ESldStatisticsOperation), выполнявшимся в момент подсчета.
+ */
+struct TSldStatistics
+{
+	// Количество ресурсов, загруженных из контейнера
+	UInt64 ResourcesLoaded;
+	// Количество байт, прочитанных из контейнера при загрузке ресурсов
+	UInt64 BytesRead;
+	// Количество бит, прочитанных через CSldBitInput
+	UInt64 BitsDecoded;
+	// Количество слов, декодированных CSldList::GetNextWord()
+	UInt64 WordsDecoded;
+	// Количество статей, пропущенных при переходе к нужной статье в CSldArticles::Translate()
+	UInt64 ArticlesSkipped;
+	// Количество сравнений строк CSldCompare::StrICmp()
+	UInt64 StrICmpCalls;
+	// Количество временных буферов (sld2::ScratchArray), размещенных в арене операции
+	UInt64 ScratchAllocations;
+	// Суммарный размер временных буферов, размещенных в арене операции, в байтах
+	UInt64 ScratchBytes;
+	// Количество вызовов операций словаря
+	UInt64 OperationCalls[eStatisticsOperation_Count];
+	// Суммарное время выполнения операций словаря в наносекундах (время вложенных операций учитывается и во внешних)
+	UInt64 OperationTime[eStatisticsOperation_Count];
+
+	TSldStatistics() { Clear(); }
+
+	void Clear() { sldMemZero(this, sizeof(*this)); }
+};
+
+#ifdef SLD__HAVE_STATISTICS
+
+namespace sld2 {
+namespace statistics {
+
+// Возвращает ссылку на счетчики операции словаря, выполняющейся в текущем потоке (nullptr вне операций)
+inline TSldStatistics*& current()
+{
+	static thread_local TSldStatistics *stats = nullptr;
+	return stats;
+}
+
+} // namespace statistics
+} // namespace sld2
+
+// Увеличивает счетчик текущей операции словаря
+#define SLD_STATISTICS_ADD(_counter, _value) \
+	do { if (TSldStatistics *sld_stats_ = sld2::statistics::current()) sld_stats_->_counter += (_value); } while (0)
+
+#else
+
+#define SLD_STATISTICS_ADD(_counter, _value) ((void)0)
+
+#endif // SLD__HAVE_STATISTICS
+
+#endif // _SLD_STATISTICS_H_
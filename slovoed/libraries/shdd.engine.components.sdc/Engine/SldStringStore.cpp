@@ -113,12 +113,11 @@ static decodeResult decode(UInt32 method, const void *decoderData, BitStream bit
  * возможноым (определенным) действием - деструкцией
  */
 CSldStringStore::CSldStringStore(CSDCReadMy &aReader, UInt32 aType, ESldError &aError)
-	: m_indexable(false), m_encodingMethod(~0u), m_resourceCount(0), m_reader(aReader)
+	: m_indexable(false), m_encodingMethod(~0u), m_resourceCount(0), m_decoderDataSize(0),
+	  m_reader(aReader), m_resourceType(aType), m_maxResourceSize(0), m_useCounter(0)
 {
 #define error_out(_err) do { aError = _err; return; } while(0)
 
-	sld2::memzero(m_currentResource);
-
 	ESldError error;
 	auto headerResource = m_reader.GetResource(aType, 0);
 	if (headerResource != eOK)
@@ -161,22 +160,17 @@ CSldStringStore::CSldStringStore(CSDCReadMy &aReader, UInt32 aType, ESldError &a
 
 	// decoder data + staging buffer mem alloc
 	{
-		// decoder data and the encoded strings resource data are all placed
-		// inside a single contiguous buffer one after the other with some alignement
-		// sprinkled here and there
-
 		// everything at the end of the header resource is the decoder data
 		const UInt32 size = headerResource.size() - (UInt32)(ptr - headerResource.ptr());
-		// align the start of the encoded string buffer to avoid unaligned accesses
-		const UInt32 alignedSize = sld2::align_up2<sizeof(UInt32)>(size);
+		// align the start of the encoded string buffers to avoid unaligned accesses
+		m_decoderDataSize = sld2::align_up2<sizeof(UInt32)>(size);
+		m_maxResourceSize = header->maxResourceSize;
 
-		// as bit stream is greedy (as in it reads in UInt32 chunks and can read past the "end")
-		// overallocate a bit so that we don't read into uninitialized memory
-		if (!m_decoderData.resize(alignedSize + header->maxResourceSize + sizeof(UInt32) * 2))
-			error_out(eMemoryNotEnoughMemory);
+		error = AllocateResources((sld2::min)(header->resourceCount, (UInt16)SLD_DEFAULT_STRING_STORE_RESIDENT_RESOURCES));
+		if (error != eOK)
+			error_out(error);
 
 		sldMemCopy(m_decoderData.data(), ptr, size);
-		m_currentResource.data = m_decoderData.data() + alignedSize;
 	}
 
 	// allocate the string staging buffer storage
@@ -187,26 +181,118 @@ CSldStringStore::CSldStringStore(CSDCReadMy &aReader, UInt32 aType, ESldError &a
 	m_encodingMethod = header->compressionMethod;
 	m_resourceCount = header->resourceCount;
 
-	m_currentResource.type = aType;
-	m_currentResource.maxSize = header->maxResourceSize;
-
 	aError = eOK;
 #undef error_out
 }
 
-// loads the resource of the given index
-static ESldError load(CSDCReadMy &aReader, CSldStringStore::CurrentResource &aResource, UInt32 aIndex)
+// the size of a single resident resource buffer
+static inline UInt32 residentBufferSize(UInt32 aMaxResourceSize)
+{
+	// as bit stream is greedy (as in it reads in UInt32 chunks and can read past the "end")
+	// overallocate a bit so that we don't read into uninitialized memory
+	return sld2::align_up2<sizeof(UInt32)>(aMaxResourceSize) + sizeof(UInt32) * 2;
+}
+
+/**
+ * (Пере)выделяет память под данные декодера и буферы загруженных ресурсов
+ *
+ * @param[in]  aCount - количество одновременно загруженных ресурсов
+ *
+ * Данные декодера и буферы ресурсов размещаются в одном непрерывном блоке памяти один за другим,
+ * все загруженные ресурсы при этом "выгружаются".
+ *
+ * @return error code
+ */
+ESldError CSldStringStore::AllocateResources(UInt32 aCount)
+{
+	if (aCount == 0)
+		aCount = 1;
+
+	const UInt32 bufferSize = residentBufferSize(m_maxResourceSize);
+	if (!m_decoderData.resize(m_decoderDataSize + bufferSize * aCount))
+		return eMemoryNotEnoughMemory;
+	if (!m_resources.resize(aCount))
+		return eMemoryNotEnoughMemory;
+
+	for (UInt32 i = 0; i < aCount; i++)
+	{
+		ResidentResource &resource = m_resources[i];
+		resource.data = m_decoderData.data() + m_decoderDataSize + bufferSize * i;
+		resource.size = 0;
+		resource.index = 0;
+		resource.lastUse = 0;
+	}
+	m_useCounter = 0;
+	return eOK;
+}
+
+/**
+ * Устанавливает количество одновременно загруженных ресурсов
+ *
+ * @param[in]  aCount - количество ресурсов, ограничивается сверху общим количеством ресурсов
+ *
+ * Ресурсы вытесняются по принципу LRU; каждый ресурс занимает буфер максимального размера ресурса
+ * данного string store, так что значение стоит держать небольшим.
+ *
+ * @return error code
+ */
+ESldError CSldStringStore::SetResidentResourceCount(UInt32 aCount)
 {
-	if (aIndex == aResource.index && aResource.size != 0)
+	if (aCount == 0)
+		return eMemoryZeroSizeMemoryRequest;
+
+	aCount = (sld2::min)(aCount, m_resourceCount);
+	if (aCount == m_resources.size())
 		return eOK;
 
-	UInt32 dataSize = aResource.maxSize;
-	ESldError error = aReader.GetResourceData(aResource.data, aResource.type, aIndex + 1, &dataSize);
+	return AllocateResources(aCount);
+}
+
+/**
+ * Возвращает загруженный ресурс по индексу, загружая его при необходимости
+ *
+ * @param[in]  aIndex    - индекс ресурса
+ * @param[out] aResource - указатель куда будет записан указатель на загруженный ресурс
+ *
+ * @return error code
+ */
+ESldError CSldStringStore::LoadResource(UInt32 aIndex, const ResidentResource **aResource)
+{
+	// look up the resource among the loaded ones and the least recently used one at the same time
+	ResidentResource *lru = &m_resources[0];
+	for (ResidentResource &resource : m_resources)
+	{
+		if (resource.size != 0 && resource.index == aIndex)
+		{
+			resource.lastUse = ++m_useCounter;
+			*aResource = &resource;
+			return eOK;
+		}
+
+		if (resource.size == 0 || (lru->size != 0 && resource.lastUse < lru->lastUse))
+			lru = &resource;
+	}
+
+	UInt32 dataSize = m_maxResourceSize;
+	ESldError error = m_reader.GetResourceData(lru->data, m_resourceType, aIndex + 1, &dataSize);
 	if (error != eOK)
+	{
+		lru->size = 0;
 		return error;
+	}
 
-	aResource.index = aIndex;
-	aResource.size = dataSize;
+	// the counter overflowed, just restart the lru sequence
+	if (++m_useCounter == 0)
+	{
+		for (ResidentResource &resource : m_resources)
+			resource.lastUse = 0;
+		m_useCounter = 1;
+	}
+
+	lru->index = aIndex;
+	lru->size = dataSize;
+	lru->lastUse = m_useCounter;
+	*aResource = lru;
 	return eOK;
 }
 
@@ -214,20 +300,23 @@ static ESldError load(CSDCReadMy &aReader, CSldStringStore::CurrentResource &aRe
 static bool getStringIndex(sld2::Span<const TSldStringStoreResourceDescriptor> aDescriptors,
 						   UInt32 aGlobalIndex, UInt32 *aResourceIndex, UInt32 *aLocalIndex, UInt32 *aIndexCount)
 {
-	UInt32 startIndex = 0;
-	for (UInt32 i = 0; i < aDescriptors.size(); i++)
-	{
-		const TSldStringStoreResourceDescriptor &descriptor = aDescriptors[i];
-		if (aGlobalIndex < descriptor.endIndex)
-		{
-			*aResourceIndex = i;
-			*aLocalIndex = aGlobalIndex - startIndex;
-			*aIndexCount = descriptor.endIndex - startIndex;
-			return true;
+	// the descriptors are stored with a monotonically increasing `endIndex` so we can simply
+	// binary search for the first one where the global index is less than `endIndex`
+	struct less {
+		UInt32 index;
+		bool operator()(const TSldStringStoreResourceDescriptor &aDescriptor) const {
+			return aDescriptor.endIndex <= index;
 		}
-		startIndex = descriptor.endIndex;
-	}
-	return false;
+	};
+	const UInt32 i = sld2::lower_bound(aDescriptors.data(), aDescriptors.size(), less{ aGlobalIndex });
+	if (i == aDescriptors.size())
+		return false;
+
+	const UInt32 startIndex = i ? aDescriptors[i - 1].endIndex : 0;
+	*aResourceIndex = i;
+	*aLocalIndex = aGlobalIndex - startIndex;
+	*aIndexCount = aDescriptors[i].endIndex - startIndex;
+	return true;
 }
 
 /**
@@ -250,18 +339,19 @@ ESldError CSldStringStore::GetString(UInt32 aIndex, SldU16StringRef &aString)
 	if (!getStringIndex(m_descriptorTable, aIndex, &resourceIndex, &localIndex, &stringCount))
 		return eCommonWrongIndex;
 
-	ESldError error = load(m_reader, m_currentResource, resourceIndex);
+	const ResidentResource *resource;
+	ESldError error = LoadResource(resourceIndex, &resource);
 	if (error != eOK)
 		return error;
 
 	// get the offset of the string, the offsets table is placed at the end of the resource so we have to first
 	// calculate its size to be able to get a pointer to it's start address
-	auto header = (const TSldStringStoreResourceHeader*)m_currentResource.data;
+	auto header = (const TSldStringStoreResourceHeader*)resource->data;
 	const UInt32 offsetsTableSize = sld2::div_round_up(header->offsetBits * stringCount, sizeof(UInt32) * 8) * sizeof(UInt32);
-	const UInt32 *offsets = (const UInt32*)(m_currentResource.data + m_currentResource.size - offsetsTableSize);
+	const UInt32 *offsets = (const UInt32*)(resource->data + resource->size - offsetsTableSize);
 	const UInt32 offset = sld2::readBits(offsets, header->offsetBits, localIndex);
 
-	return DecodeString(offset, aString);
+	return DecodeString(*resource, offset, aString);
 }
 
 /**
@@ -281,23 +371,69 @@ ESldError CSldStringStore::GetStringDirect(UInt32 aResourceIndex, UInt32 aOffset
 	if (aResourceIndex >= m_resourceCount)
 		return eCommonWrongIndex;
 
-	ESldError error = load(m_reader, m_currentResource, aResourceIndex);
+	const ResidentResource *resource;
+	ESldError error = LoadResource(aResourceIndex, &resource);
 	if (error != eOK)
 		return error;
 
-	return DecodeString(aOffset, aString);
+	return DecodeString(*resource, aOffset, aString);
+}
+
+/**
+ * Вычисляет порядок обхода индексов строк при котором они сгруппированы по ресурсам
+ *
+ * @param[in]  aIndexes - массив глобальных индексов строк
+ * @param[out] aOrder   - массив куда будут записаны позиции индексов в aIndexes
+ *
+ * Внутри одного ресурса сохраняется исходный порядок индексов.
+ *
+ * @return error code
+ */
+ESldError CSldStringStore::GroupByResource(sld2::Span<const UInt32> aIndexes, sld2::DynArray<UInt32> &aOrder) const
+{
+	if (!m_indexable || m_resourceCount == 0)
+		return eCommonWrongIndex;
+
+	if (aIndexes.empty())
+	{
+		aOrder.resize(0);
+		return eOK;
+	}
+
+	sld2::DynArray<UInt32> resourceIndexes(sld2::default_init, aIndexes.size());
+	// one extra slot for the "prefix sum" below
+	sld2::DynArray<UInt32> counts(m_resourceCount + 1);
+	if (resourceIndexes.empty() || counts.empty() || !aOrder.resize(sld2::default_init, aIndexes.size()))
+		return eMemoryNotEnoughMemory;
+
+	for (UInt32 i = 0; i < aIndexes.size(); i++)
+	{
+		UInt32 localIndex, stringCount;
+		if (!getStringIndex(m_descriptorTable, aIndexes[i], &resourceIndexes[i], &localIndex, &stringCount))
+			return eCommonWrongIndex;
+		counts[resourceIndexes[i] + 1]++;
+	}
+
+	// a simple counting sort by the resource index
+	for (UInt32 i = 1; i < counts.size(); i++)
+		counts[i] += counts[i - 1];
+
+	for (UInt32 i = 0; i < aIndexes.size(); i++)
+		aOrder[counts[resourceIndexes[i]]++] = i;
+
+	return eOK;
 }
 
-// decodes a string at the given offset from the current resource
-ESldError CSldStringStore::DecodeString(UInt32 aOffset, SldU16StringRef &aString)
+// decodes a string at the given offset from the given resource
+ESldError CSldStringStore::DecodeString(const ResidentResource &aResource, UInt32 aOffset, SldU16StringRef &aString)
 {
 	using namespace decoders;
 
-	auto header = (const TSldStringStoreResourceHeader*)m_currentResource.data;
+	auto header = (const TSldStringStoreResourceHeader*)aResource.data;
 	if (aOffset > header->maxOffset)
 		return eCommonWrongIndex;
 
-	BitStream bits(m_currentResource.data, aOffset);
+	BitStream bits(aResource.data, aOffset);
 	auto result = decoders::decode(m_encodingMethod, m_decoderData.data(), bits, m_stringBuf);
 	if (result.error == eOK)
 		aString = SldU16StringRef(m_stringBuf.data(), result.length);
@@ -23,20 +23,73 @@ public:
 	// Возвращает строку по индексу ресурса и смещению
 	ESldError GetStringDirect(UInt32 aResourceIndex, UInt32 aOffset, SldU16StringRef &aString);
 
+	/**
+	 * Возвращает набор строк по глобальным индексам
+	 *
+	 * @param[in]  aIndexes - массив глобальных индексов строк
+	 * @param[in]  aFunc    - функтор с сигнатурой `void (UInt32 aPos, SldU16StringRef aString)`,
+	 *                        вызывается для каждой строки; aPos - позиция индекса в aIndexes
+	 *
+	 * Запросы группируются по ресурсам, так что каждый ресурс загружается не более одного раза,
+	 * соответственно порядок вызовов aFunc *не* совпадает с порядком индексов.
+	 * Строка передаваемая в aFunc актуальна только до выхода из него.
+	 *
+	 * @return error code
+	 */
+	template <typename Func>
+	ESldError GetStrings(sld2::Span<const UInt32> aIndexes, Func&& aFunc)
+	{
+		sld2::DynArray<UInt32> order;
+		ESldError error = GroupByResource(aIndexes, order);
+		if (error != eOK)
+			return error;
+
+		for (UInt32 pos : order)
+		{
+			SldU16StringRef string;
+			error = GetString(aIndexes[pos], string);
+			if (error != eOK)
+				return error;
+			aFunc(pos, string);
+		}
+		return eOK;
+	}
+
+	// Устанавливает количество одновременно загруженных ресурсов
+	ESldError SetResidentResourceCount(UInt32 aCount);
+
+	// Возвращает количество одновременно загруженных ресурсов
+	UInt32 GetResidentResourceCount() const { return m_resources.size(); }
+
+	// Возвращает количество строк доступных по глобальному индексу
+	UInt32 GetStringCount() const { return m_indexable && m_descriptorTable.size() ? m_descriptorTable.back().endIndex : 0; }
+
 	// *private*
-	struct CurrentResource
+	struct ResidentResource
 	{
+		// resource data (points into m_decoderData)
 		UInt8 *data;
+		// the size of the loaded data, 0 if the slot is empty
 		UInt32 size;
+		// resource index
 		UInt32 index;
-		UInt32 type;
-		UInt32 maxSize;
+		// "timestamp" of the last access, used for lru eviction
+		UInt32 lastUse;
 	};
 
 private:
 
-	// decodes a string at the given offset from the current resource
-	ESldError DecodeString(UInt32 aOffset, SldU16StringRef &aString);
+	// returns the loaded resource with the given index, loading it if required
+	ESldError LoadResource(UInt32 aIndex, const ResidentResource **aResource);
+
+	// (re)allocates decoder data and resource buffers for the given count of resident resources
+	ESldError AllocateResources(UInt32 aCount);
+
+	// calculates an order of the string indexes in which they are grouped by resource
+	ESldError GroupByResource(sld2::Span<const UInt32> aIndexes, sld2::DynArray<UInt32> &aOrder) const;
+
+	// decodes a string at the given offset from the given resource
+	ESldError DecodeString(const ResidentResource &aResource, UInt32 aOffset, SldU16StringRef &aString);
 
 	// if the string store is is globally indexable
 	bool m_indexable;
@@ -52,14 +105,24 @@ private:
 	// internal string buffer
 	sld2::DynArray<UInt16> m_stringBuf;
 
-	// heap allocated decoder data (also holds current resource data)
+	// heap allocated decoder data (also holds resident resources data)
 	sld2::DynArray<UInt8> m_decoderData;
 
+	// the size of the decoder data (aligned)
+	UInt32 m_decoderDataSize;
+
 	// resource reader
 	CSDCReadMy &m_reader;
 
-	// currently loaded resource with compressed data
-	CurrentResource m_currentResource;
+	// type of the resources with compressed data
+	UInt32 m_resourceType;
+	// the maximum size of a resource with compressed data
+	UInt32 m_maxResourceSize;
+
+	// currently loaded resources with compressed data
+	sld2::DynArray<ResidentResource> m_resources;
+	// resource access counter
+	UInt32 m_useCounter;
 };
 
 // Класс отвечает за работу с ресурсами содержащими 1 упакованную строчку
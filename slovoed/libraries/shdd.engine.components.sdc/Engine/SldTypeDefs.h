@@ -312,6 +312,22 @@ typedef struct THierarchyElement
 	UInt32 EndIndex;
 } THierarchyElement;
 
+// Элемент таблицы родителей уровней иерархии (см. #TListHeader::Type_HierarchyParents)
+/**
+	В таблице по одному элементу на каждый уровень иерархии в порядке возрастания номера
+	первого слова уровня. Последним идет терминальный элемент, у которого LevelStart равен
+	количеству слов в списке, а ParentLevel и ParentWordIndex равны MAX_UINT_VALUE.
+*/
+typedef struct THierarchyLevelParent
+{
+	// Глобальный номер первого слова уровня
+	UInt32 LevelStart;
+	// Номер элемента таблицы, описывающего родительский уровень (MAX_UINT_VALUE для корня)
+	UInt32 ParentLevel;
+	// Локальный номер родительского слова в родительском уровне (MAX_UINT_VALUE для корня)
+	UInt32 ParentWordIndex;
+} THierarchyLevelParent;
+
 // Заголовок таблицы быстрого доступа
 typedef struct TQAHeader
 {
@@ -513,8 +529,12 @@ typedef struct TListHeader
 	// В списке должны быть только базовые формы
 	UInt32 MorphologyId;
 
+	// Тип ресурса в котором хранится таблица родителей уровней иерархии (см. #THierarchyLevelParent)
+	// 0 - таблицы нет
+	UInt32 Type_HierarchyParents;
+
 	// Reserved
-	UInt32 Reserved[15];
+	UInt32 Reserved[14];
 
 } TListHeader;
 
@@ -197,6 +197,71 @@ static inline bool binary_search(const Type1 *aData, const UInt32 aElementCount,
 	return aData[index] == aSearchItem;
 }
 
+namespace detail {
+
+// Рекурсия идет только в меньшую часть, большая обрабатывается в цикле,
+// поэтому глубина стека не превышает log2 от количества индексов
+template <typename Compare>
+void sort_indexes(Int32 *aIndexes, Int32 aFirst, Int32 aLast, Compare &aCompare)
+{
+	while (aFirst < aLast)
+	{
+		Int32 i = aFirst;
+		Int32 j = aLast;
+		const Int32 pivot = aIndexes[(i + j) >> 1];
+
+		do
+		{
+			Int32 cmp;
+			while ((cmp = aCompare(aIndexes[i], pivot)) < 0 || (cmp == 0 && aIndexes[i] < pivot))
+				i++;
+
+			while ((cmp = aCompare(aIndexes[j], pivot)) > 0 || (cmp == 0 && aIndexes[j] > pivot))
+				j--;
+
+			if (i <= j)
+			{
+				if (i < j)
+					swap(aIndexes[i], aIndexes[j]);
+
+				i++;
+				j--;
+			}
+		} while (i <= j);
+
+		if (j - aFirst < aLast - i)
+		{
+			sort_indexes(aIndexes, aFirst, j, aCompare);
+			aFirst = i;
+		}
+		else
+		{
+			sort_indexes(aIndexes, i, aLast, aCompare);
+			aLast = j;
+		}
+	}
+}
+
+} // namespace detail
+
+/**
+ * Сортирует массив индексов элементов быстрой сортировкой
+ *
+ * @param [in]  aIndexes  - указатель на первый индекс массива
+ * @param [in]  aCount    - количество индексов в массиве
+ * @param [in]  aCompare  - функция сравнения элементов по их индексам; с сигнатурой
+ *                          `Int32 (Int32, Int32)`, возвращает <0, 0 или >0, как StrCmp
+ *
+ * Индексы равных элементов остаются упорядоченными по возрастанию, поэтому сортировка
+ * устойчива, если исходный массив был упорядочен по возрастанию
+ */
+template <typename Compare>
+inline void sort_indexes(Int32 *aIndexes, UInt32 aCount, Compare&& aCompare)
+{
+	if (aCount > 1)
+		detail::sort_indexes(aIndexes, 0, (Int32)aCount - 1, aCompare);
+}
+
 template<typename Type>
 inline bool InRange(const Type aValue, const Type aMin, const Type aMax)
 {